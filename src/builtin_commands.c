@@ -2,6 +2,7 @@
 
 #include "header/shell/builtin_commands.h"
 #include "header/stdlib/string.h" // Now strictly adhering to provided functions only
+#include "header/stdlib/malloc.h"
 
 // No custom string functions here, relying strictly on header/stdlib/string.h
 extern char current_working_directory[256];
@@ -444,18 +445,43 @@ void handle_cat(const char* filename) {
     }
     request.name[copy_len] = '\0';
     
-    // Alokasi buffer untuk membaca file
-    // Maksimum ukuran file yang bisa ditampilkan (8KB untuk keamanan)
-    const uint32_t max_file_size = 8192;
-    static uint8_t file_buffer[8192];
-    
-    request.buf = file_buffer;
-    request.buffer_size = max_file_size;
     request.is_directory = 0;
     
-    // Panggil syscall untuk membaca file
-    int8_t result;
-    user_syscall(17, (uint32_t)&request, (uint32_t)&result, 0);
+    // Coba mmap dulu: isi file dibaca langsung dari page cache kernel, tanpa
+    // salinan ke file_buffer. Gagal (file kosong, direktori, memori penuh)
+    // => fallback ke read() biasa ke buffer heap seukuran file
+    struct MmapRequest mmap_request;
+    memset(&mmap_request, 0, sizeof(mmap_request));
+    mmap_request.file = request;
+    mmap_request.prot = MMAP_PROT_READ;
+    mmap_request.flags = MMAP_PRIVATE;
+    uint8_t *mapped = NULL;
+    user_syscall(36, (uint32_t)&mmap_request, (uint32_t)&mapped, 0);
+
+    int8_t result = 0;
+    uint8_t *file_buffer = NULL;
+    if (mapped == NULL) {
+        uint32_t buffer_size = 1;
+        uint32_t file_inode = 0;
+        struct EXT2Inode parent_dir;
+        read_inode(current_inode, &parent_dir);
+        if (find_inode_in_dir(&parent_dir, filename, &file_inode)) {
+            struct EXT2Inode file_node;
+            read_inode(file_inode, &file_node);
+            if (file_node.i_size > buffer_size)
+                buffer_size = file_node.i_size;
+        }
+        file_buffer = malloc(buffer_size);
+        if (file_buffer == NULL) {
+            print_line("cat: out of memory");
+            return;
+        }
+        request.buf = file_buffer;
+        request.buffer_size = buffer_size;
+        // Panggil syscall untuk membaca file
+        user_syscall(17, (uint32_t)&request, (uint32_t)&result, 0);
+    }
+    const uint8_t *data = mapped != NULL ? mapped : file_buffer;
     
     int b = 0;
     
@@ -474,13 +500,10 @@ void handle_cat(const char* filename) {
             read_inode(file_inode, &file_node);
             
             uint32_t file_size = file_node.i_size;
-            if (file_size > max_file_size) {
-                file_size = max_file_size;
-            }
             
             // Tampilkan isi file karakter per karakter
             for (uint32_t i = 0; i < file_size; i++) {
-                char c = file_buffer[i];
+                char c = data[i];
                 
                 if (c == '\n') {
                     // Newline - pindah ke baris baru
@@ -538,6 +561,11 @@ void handle_cat(const char* filename) {
             print_string("cat: cannot determine file size", &current_output_row, &b);
             current_output_row++;
         }
+
+        if (mapped != NULL) {
+            int8_t unmap_result;
+            user_syscall(37, (uint32_t)mapped, (uint32_t)&unmap_result, 0);
+        }
         
     } else if (result == 1) {
         print_string("cat: '", &current_output_row, &b);
@@ -560,6 +588,7 @@ void handle_cat(const char* filename) {
         print_string("'", &current_output_row, &b);
         current_output_row++;
     }
+    free(file_buffer);
 }
 void handle_help() {
     
@@ -572,13 +601,21 @@ void handle_help() {
     print_line("  cat <file>         - Display file contents");
     print_line("  cp <src> <dest>    - Copy file");
     print_line("  rm <file>          - Remove file");
-    print_line("  mv <src> <dest>    - Move/rename file");
-    print_line("  find <name>        - Search for file");
+    print_line("  rm -r <name>       - Remove directory tree");
+    print_line("  mv <src> <dest>    - Move/rename file or dir");
+    print_line("  find <name|pre*>   - Search for file");
+    print_line("  chattr +c|-c <name> - Toggle LZ4 compression");
+    print_line("  df                 - Show free space");
+    print_line("  dedup              - Share identical data blocks");
+    print_line("  snapshot [create|rollback|drop] - FS snapshot");
     
     // Process management commands
     print_line("  exec <file>        - Execute program");
     print_line("  ps                 - List running processes");
     print_line("  kill <pid>         - Terminate process by PID");
+    print_line("  fork               - Spawn copy-on-write copy of shell");
+    print_line("  slabinfo           - Kernel heap cache statistics");
+    print_line("  schedstat          - Context switch and TLB flush counters");
     
     // System commands
     print_line("  help               - Show this help message");
@@ -808,235 +845,153 @@ void handle_rm(const char* path) {
     }
 }
 
-void handle_mv(const char* source, const char* destination) {
-    int b = 0; // Column pointer for print_string
-
-    if (!source || strlen(source) == 0 || !destination || strlen(destination) == 0) {
-        print_string("mv: missing source or destination argument (usage: mv source destination)", &current_output_row, &b);
+void handle_rm_recursive(const char* path) {
+    int b = 0;
+    if (!path || strlen(path) == 0) {
+        print_string("rm: missing file/directory name", &current_output_row, &b);
         current_output_row++;
         return;
     }
 
-    print_string("mv: Attempting to move file...", &current_output_row, &b);
-    current_output_row++;
-
-    // Gunakan handle_cp dan simpan hasilnya
-    int8_t copy_result = handle_cp(source, destination);
-
-    // Cek hasil copy
-    if (copy_result == 0) { // Jika copy berhasil (0 = success)
-        print_string("Copy successful. Attempting to remove source file: ", &current_output_row, &b);
-        print_string(source, &current_output_row, &b);
-        current_output_row++;
-        handle_rm(source); // Hapus file sumber
-    } else if (copy_result == -2) { // Jika gagal karena destination already exists (-2)
-        print_string("mv: destination '", &current_output_row, &b);
-        print_string(destination, &current_output_row, &b);
-        print_string("' already exists. Aborting move.", &current_output_row, &b);
-        current_output_row++;
-    } else { // Jika ada error lain saat copy
-        print_string("mv: failed to copy file. Aborting move.", &current_output_row, &b);
+    if (strcmp(path, ".") == 0 || strcmp(path, "..") == 0 || strcmp(path, "../") == 0) {
+        print_string("rm: cannot remove '.' or '..' or '../' directories", &current_output_row, &b);
         current_output_row++;
-        // handle_cp sudah mencetak pesan error spesifiknya
-    }
-}
-
-void find_recursive(uint32_t curr_inode, const char* search_name, char* path, int* found) {
-    // Enhanced safety checks
-    if (*found || curr_inode == 0 || search_name == NULL || path == NULL) {
-        return;
-    }
-    
-    // Prevent deep recursion with static counter
-    static int recursion_depth = 0;
-    if (recursion_depth > 10) {
         return;
     }
-    recursion_depth++;
 
-    // Validate search_name is not empty
-    if (search_name[0] == '\0') {
-        recursion_depth--;
-        return;
-    }
+    struct EXT2DriverRequest request;
+    memset(&request, 0, sizeof(request));
+    request.parent_inode = current_inode;
+    request.name_len = strlen(path) < sizeof(request.name) ? strlen(path) : sizeof(request.name) - 1;
+    memcpy(request.name, path, request.name_len);
 
-    struct EXT2Inode dir_inode;
-    char* inode_ptr = (char*)&dir_inode;
-    for (unsigned int i = 0; i < sizeof(struct EXT2Inode); i++) {
-        inode_ptr[i] = 0;
+    // Syscall 33: hapus seluruh subtree dalam satu batch
+    int8_t result;
+    user_syscall(33, (uint32_t)&request, (uint32_t)&result, 0);
+
+    if (result == 0) {
+        print_string("rm: '", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        print_string("' removed recursively", &current_output_row, &b);
+    } else if (result == 1) {
+        print_string("rm: file/directory '", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        print_string("' not found", &current_output_row, &b);
+    } else {
+        print_string("rm: failed to remove '", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        print_string("'", &current_output_row, &b);
     }
-    
-    user_syscall(21, (uint32_t)&dir_inode, curr_inode, 0);
+    current_output_row++;
+}
 
-    if (dir_inode.i_size == 0 || dir_inode.i_size > 65536 || 
-        !(dir_inode.i_mode & 0x4000) || dir_inode.i_block[0] == 0) {
-        recursion_depth--;
+void handle_chattr(const char* mode, const char* path) {
+    int b = 0;
+    if (!mode || !path || strlen(path) == 0 ||
+        (strcmp(mode, "+c") != 0 && strcmp(mode, "-c") != 0)) {
+        print_string("chattr: usage: chattr +c|-c <name>", &current_output_row, &b);
+        current_output_row++;
         return;
     }
 
-    uint8_t buf[1024];
-    for (unsigned int i = 0; i < 1024; i++) {
-        buf[i] = 0;
-    }
-    
-    user_syscall(23, (uint32_t)buf, dir_inode.i_block[0], 1);
-
-    uint32_t offset = 0;
-    int entries_processed = 0;
-    const int MAX_ENTRIES = 50;
-    
-    while (offset < 1000 && !(*found) && entries_processed < MAX_ENTRIES) {
-        if (offset + sizeof(struct EXT2DirectoryEntry) > 1024) {
-            break;
-        }
-        
-        struct EXT2DirectoryEntry* entry = (struct EXT2DirectoryEntry*)(buf + offset);
+    struct EXT2DriverRequest request;
+    memset(&request, 0, sizeof(request));
+    request.parent_inode = current_inode;
+    request.name_len = strlen(path) < sizeof(request.name) ? strlen(path) : sizeof(request.name) - 1;
+    memcpy(request.name, path, request.name_len);
 
-        if (entry->rec_len == 0 || entry->rec_len < 8 || 
-            entry->rec_len > 500 || offset + entry->rec_len > 1024) {
-            break;
-        }
-        
-        if (entry->inode == 0 || entry->name_len == 0 || entry->name_len > 255) {
-            offset += entry->rec_len;
-            entries_processed++;
-            continue;
-        }
+    // Syscall 35: nyalakan/matikan kompresi LZ4, isi file lama ikut dikonversi
+    int8_t result;
+    user_syscall(35, (uint32_t)&request, mode[0] == '+', (uint32_t)&result);
 
-        char entry_name[256];
-        char* name_ptr = (char*)(entry + 1);
-        unsigned int name_len = (unsigned int)entry->name_len;
-        
-        if (name_len > 255) name_len = 255;
-        if (offset + sizeof(struct EXT2DirectoryEntry) + name_len > 1024) {
-            name_len = 1024 - offset - sizeof(struct EXT2DirectoryEntry);
-            if (name_len > 255) name_len = 255;
-        }
-        
-        for (unsigned int i = 0; i < name_len; i++) {
-            if (offset + sizeof(struct EXT2DirectoryEntry) + i >= 1024) {
-                name_len = i;
-                break;
-            }
-            if (i >= 255) {
-                name_len = i;
-                break;
-            }
-            entry_name[i] = name_ptr[i];
-        }
-        entry_name[name_len] = '\0';
+    if (result == 0) {
+        print_string("chattr: '", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        print_string(mode[0] == '+' ? "' is now compressed" : "' is now uncompressed", &current_output_row, &b);
+    } else if (result == 1) {
+        print_string("chattr: file/directory '", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        print_string("' not found", &current_output_row, &b);
+    } else {
+        print_string("chattr: failed to change '", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        print_string("' (disk full?)", &current_output_row, &b);
+    }
+    current_output_row++;
+}
 
-        if ((name_len == 1 && entry_name[0] == '.') ||
-            (name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.')) {
-            offset += entry->rec_len;
-            entries_processed++;
-            continue;
-        }
+void handle_mv(const char* source, const char* destination) {
+    int b = 0; // Column pointer for print_string
 
-        unsigned int search_len = 0;
-        while (search_name[search_len] != '\0' && search_len < 255) {
-            search_len++;
-        }
-        
-        int match = (search_len == name_len && search_len > 0);
-        for (unsigned int i = 0; match && i < search_len; i++) {
-            if (search_name[i] != entry_name[i]) {
-                match = 0;
-            }
-        }
+    if (!source || strlen(source) == 0 || !destination || strlen(destination) == 0) {
+        print_string("mv: missing source or destination argument (usage: mv source destination)", &current_output_row, &b);
+        current_output_row++;
+        return;
+    }
 
-        if (match) {
-            char result_path[512];
-            unsigned int path_pos = 0;
-            
-            while (path[path_pos] != '\0' && path_pos < 400) {
-                result_path[path_pos] = path[path_pos];
-                path_pos++;
-            }
-            
-            if (path_pos > 1 || path[0] != '/') {
-                if (path_pos < 510) {
-                    result_path[path_pos++] = '/';
-                }
-            }
-            
-            for (unsigned int i = 0; i < name_len && path_pos < 511; i++) {
-                result_path[path_pos++] = entry_name[i];
-            }
-            result_path[path_pos] = '\0';
+    // Source request: entry di direktori sekarang
+    struct EXT2DriverRequest src_request;
+    memset(&src_request, 0, sizeof(src_request));
+    src_request.parent_inode = current_inode;
+    src_request.name_len = strlen(source) < sizeof(src_request.name) ? strlen(source) : sizeof(src_request.name) - 1;
+    memcpy(src_request.name, source, src_request.name_len);
 
-            struct EXT2Inode found_inode;
-            char* found_ptr = (char*)&found_inode;
-            for (unsigned int i = 0; i < sizeof(struct EXT2Inode); i++) {
-                found_ptr[i] = 0;
-            }
-            user_syscall(21, (uint32_t)&found_inode, entry->inode, 0);
-            
-            // ✅ FIXED: Use global pointer variables
-            int b = 0;
-            if (current_output_row < 22) {
-                if (found_inode.i_mode & 0x4000) {
-                    print_string("FOUND DIR: ", &current_output_row, &b);
-                    print_string(result_path, &current_output_row, &b);
-                    current_output_row++;
-                } else {
-                    print_string("FOUND FILE: ", &current_output_row, &b);
-                    print_string(result_path, &current_output_row, &b);
-                    current_output_row++;
-                }
-            }
-            *found = 1;
-            recursion_depth--;
-            return;
-        }
+    // Jika destination adalah direktori yang ada (termasuk ".."), pindah ke dalamnya
+    // dengan nama yang sama. Selain itu rename di direktori sekarang.
+    rm_target_inode = 0;
+    rm_target_found = 0;
+    rm_is_directory = 0;
+    find_for_rm(current_inode, destination, &rm_target_found, &rm_is_directory, &rm_target_inode);
 
-        if (entry->inode != curr_inode && entry->inode > 1) {
-            struct EXT2Inode child_inode;
-            char* child_ptr = (char*)&child_inode;
-            for (unsigned int i = 0; i < sizeof(struct EXT2Inode); i++) {
-                child_ptr[i] = 0;
-            }
-            
-            user_syscall(21, (uint32_t)&child_inode, entry->inode, 0);
-            
-            if ((child_inode.i_mode & 0x4000) == 0x4000 && 
-                child_inode.i_size > 0 && child_inode.i_size < 65536 &&
-                child_inode.i_block[0] != 0) {
-                
-                char new_path[512];
-                unsigned int new_path_pos = 0;
-                
-                while (path[new_path_pos] != '\0' && new_path_pos < 400) {
-                    new_path[new_path_pos] = path[new_path_pos];
-                    new_path_pos++;
-                }
-                
-                if (new_path_pos > 1 || path[0] != '/') {
-                    if (new_path_pos < 510) {
-                        new_path[new_path_pos++] = '/';
-                    }
-                }
-                
-                for (unsigned int i = 0; i < name_len && new_path_pos < 511; i++) {
-                    new_path[new_path_pos++] = entry_name[i];
-                }
-                new_path[new_path_pos] = '\0';
+    struct EXT2DriverRequest dst_request = src_request;
+    if (rm_target_found && rm_is_directory) {
+        dst_request.parent_inode = rm_target_inode;
+    } else {
+        memset(dst_request.name, 0, sizeof(dst_request.name));
+        dst_request.name_len = strlen(destination) < sizeof(dst_request.name) ? strlen(destination) : sizeof(dst_request.name) - 1;
+        memcpy(dst_request.name, destination, dst_request.name_len);
+    }
 
-                find_recursive(entry->inode, search_name, new_path, found);
-            }
-        }
+    // Syscall 29: relink directory entry, tanpa menyalin data
+    int8_t result;
+    user_syscall(29, (uint32_t)&src_request, (uint32_t)&dst_request, (uint32_t)&result);
 
-        offset += entry->rec_len;
-        entries_processed++;
+    switch (result) {
+        case 0:
+            print_string("mv: ", &current_output_row, &b);
+            print_string(source, &current_output_row, &b);
+            print_string(" -> ", &current_output_row, &b);
+            print_string(destination, &current_output_row, &b);
+            break;
+        case -2:
+            print_string("mv: source '", &current_output_row, &b);
+            print_string(source, &current_output_row, &b);
+            print_string("' not found", &current_output_row, &b);
+            break;
+        case -3:
+            print_string("mv: destination '", &current_output_row, &b);
+            print_string(destination, &current_output_row, &b);
+            print_string("' already exists", &current_output_row, &b);
+            break;
+        case -4:
+            print_string("mv: cannot move a directory into itself", &current_output_row, &b);
+            break;
+        case -6:
+            print_string("mv: destination directory is full", &current_output_row, &b);
+            break;
+        default:
+            print_string("mv: failed to move '", &current_output_row, &b);
+            print_string(source, &current_output_row, &b);
+            print_string("'", &current_output_row, &b);
+            break;
     }
-    
-    recursion_depth--;
+    current_output_row++;
 }
 
 void handle_find(const char* filename) {
     if (filename == NULL || filename[0] == '\0') {
         int b = 0;
-        print_string("find: usage: find <filename>", &current_output_row, &b);
+        print_string("find: usage: find <name> | find <prefix>*", &current_output_row, &b);
         current_output_row++;
         return;
     }
@@ -1053,7 +1008,14 @@ void handle_find(const char* filename) {
         filename_len++;
     }
     
-    if (filename_len == 0 || filename_len > 255) {
+    // "find log*" mencari semua nama yang diawali "log"
+    struct EXT2FindRequest request;
+    memset(&request, 0, sizeof(request));
+    request.prefix = filename_len > 1 && filename[filename_len - 1] == '*';
+    request.name_len = request.prefix ? filename_len - 1 : filename_len;
+    memcpy(request.name, filename, request.name_len);
+
+    if (request.name_len == 0 || filename[filename_len] != '\0') {
         int b = 0;
         print_string("find: invalid filename length", &current_output_row, &b);
         current_output_row++;
@@ -1072,15 +1034,217 @@ void handle_find(const char* filename) {
     print_string(filename, &current_output_row, &b);
     current_output_row++;
 
-    char root_path[3] = {'/', '\0', '\0'};
-    int found = 0;
-    
-    find_recursive(2, filename, root_path, &found);
+    // Satu syscall: kernel menjawab dari name index, bukan menelusuri seluruh tree
+    static char path_buffer[2048];
+    request.buf = path_buffer;
+    request.buffer_size = sizeof(path_buffer);
+    int8_t result;
+    user_syscall(39, (uint32_t)&request, (uint32_t)&result, 0);
 
-    if (!found) {
+    if (result < 0 || request.match_count == 0) {
         b = 0;
         print_string("File or directory not found", &current_output_row, &b);
         current_output_row++;
+        return;
+    }
+
+    const char *path = path_buffer;
+    uint32_t shown = 0;
+    while (shown < request.path_count && current_output_row < 22) {
+        b = 0;
+        print_string("FOUND: ", &current_output_row, &b);
+        print_string(path, &current_output_row, &b);
+        current_output_row++;
+        path += strlen(path) + 1;
+        shown++;
+    }
+
+    if (shown < request.match_count) {
+        char more[16];
+        uint32_t remaining = request.match_count - shown, len = 0;
+        char digits[12];
+        do {
+            digits[len++] = '0' + remaining % 10;
+            remaining /= 10;
+        } while (remaining > 0);
+        for (uint32_t i = 0; i < len; i++)
+            more[i] = digits[len - 1 - i];
+        more[len] = '\0';
+        b = 0;
+        print_string("... and ", &current_output_row, &b);
+        print_string(more, &current_output_row, &b);
+        print_string(" more", &current_output_row, &b);
+        current_output_row++;
+    }
+}
+void handle_dedup() {
+    struct EXT2DedupStats stats;
+    int8_t result;
+    // Syscall 40: scan semua file, blok dengan isi sama dibagi lewat refcount
+    user_syscall(40, (uint32_t)&stats, (uint32_t)&result, 0);
+
+    int b = 0;
+    if (result != 0) {
+        print_string("dedup: filesystem has no refcount table", &current_output_row, &b);
+        current_output_row++;
+        return;
+    }
+
+    char number[16];
+    print_string("dedup: scanned ", &current_output_row, &b);
+    int_to_string((int)stats.blocks_scanned, number);
+    print_string(number, &current_output_row, &b);
+    print_string(" blocks, merged ", &current_output_row, &b);
+    int_to_string((int)stats.blocks_merged, number);
+    print_string(number, &current_output_row, &b);
+    print_string(", freed ", &current_output_row, &b);
+    int_to_string((int)stats.blocks_freed, number);
+    print_string(number, &current_output_row, &b);
+    current_output_row++;
+}
+void handle_snapshot(const char* action) {
+    uint32_t op = EXT2_SNAPSHOT_STATUS;
+    if (action != NULL && strcmp(action, "create") == 0) op = EXT2_SNAPSHOT_CREATE;
+    else if (action != NULL && strcmp(action, "rollback") == 0) op = EXT2_SNAPSHOT_ROLLBACK;
+    else if (action != NULL && strcmp(action, "drop") == 0) op = EXT2_SNAPSHOT_DROP;
+    else if (action != NULL) {
+        print_line("snapshot: usage: snapshot [create|rollback|drop]");
+        return;
+    }
+
+    // Syscall 41: snapshot copy-on-write di belakang filesystem, rollback O(blok yang berubah)
+    int8_t result;
+    uint32_t changed_blocks = 0;
+    user_syscall(41, op, (uint32_t)&result, (uint32_t)&changed_blocks);
+
+    if (result < 0) {
+        print_line("snapshot: storage too small for a snapshot");
+        return;
+    }
+    if (result == 1) {
+        print_line("snapshot: no snapshot");
+        return;
+    }
+    if (op == EXT2_SNAPSHOT_ROLLBACK) {
+        // Direktori kerja mungkin tidak ada lagi di snapshot
+        current_inode = 2; // Root inode
+        strcpy(current_working_directory, "/");
+    }
+    if (op == EXT2_SNAPSHOT_DROP) {
+        print_line("snapshot: dropped");
+        return;
+    }
+
+    int b = 0;
+    char number[16];
+    print_string(op == EXT2_SNAPSHOT_ROLLBACK ? "snapshot: rolled back, " :
+                 op == EXT2_SNAPSHOT_CREATE ? "snapshot: created, " : "snapshot: active, ",
+                 &current_output_row, &b);
+    int_to_string((int)changed_blocks, number);
+    print_string(number, &current_output_row, &b);
+    print_string(" blocks changed", &current_output_row, &b);
+    current_output_row++;
+}
+void handle_df() {
+    // Syscall 42: dijawab dari free extent index, bitmap tidak dipindai
+    struct EXT2SpaceInfo info;
+    user_syscall(42, (uint32_t)&info, 0, 0);
+
+    int b = 0;
+    char number[16];
+    print_string("blocks: ", &current_output_row, &b);
+    int_to_string((int)info.free_blocks, number);
+    print_string(number, &current_output_row, &b);
+    print_string(" free / ", &current_output_row, &b);
+    int_to_string((int)info.blocks_count, number);
+    print_string(number, &current_output_row, &b);
+    print_string(" (", &current_output_row, &b);
+    int_to_string((int)(info.free_blocks * BLOCK_SIZE / 1024), number);
+    print_string(number, &current_output_row, &b);
+    print_string(" KB free)", &current_output_row, &b);
+    current_output_row++;
+
+    b = 0;
+    print_string("free extents: ", &current_output_row, &b);
+    int_to_string((int)info.free_extents, number);
+    print_string(number, &current_output_row, &b);
+    print_string(", largest ", &current_output_row, &b);
+    int_to_string((int)info.largest_free_extent, number);
+    print_string(number, &current_output_row, &b);
+    print_string(" blocks", &current_output_row, &b);
+    current_output_row++;
+
+    b = 0;
+    print_string("inodes: ", &current_output_row, &b);
+    int_to_string((int)info.free_inodes, number);
+    print_string(number, &current_output_row, &b);
+    print_string(" free / ", &current_output_row, &b);
+    int_to_string((int)info.inodes_count, number);
+    print_string(number, &current_output_row, &b);
+    current_output_row++;
+}
+void handle_fork() {
+    // Syscall 44: anak berbagi semua page shell (copy-on-write) dan lanjut dari titik yang sama dengan result 0
+    int32_t pid = -1;
+    user_syscall(44, (uint32_t)&pid, 0, 0);
+    if (pid == 0)
+        return;
+
+    int b = 0;
+    if (pid < 0) {
+        print_string("fork: process table or memory full", &current_output_row, &b);
+    } else {
+        char number[16];
+        int_to_string(pid, number);
+        print_string("Forked shell, child PID ", &current_output_row, &b);
+        print_string(number, &current_output_row, &b);
+    }
+    current_output_row++;
+}
+void handle_slabinfo() {
+    // Syscall 43: statistik per object cache kernel heap
+    struct KmemCacheInfo info[KMEM_CACHE_COUNT_MAX];
+    uint32_t count = 0;
+    user_syscall(43, (uint32_t)info, KMEM_CACHE_COUNT_MAX, (uint32_t)&count);
+
+    int b = 0;
+    print_string("cache           size  active/total  slabs", &current_output_row, &b);
+    current_output_row++;
+    char number[16];
+    for (uint32_t i = 0; i < count; i++) {
+        b = 0;
+        print_string(info[i].name, &current_output_row, &b);
+        b = 16;
+        int_to_string((int)info[i].object_size, number);
+        print_string(number, &current_output_row, &b);
+        b = 22;
+        int_to_string((int)info[i].active_objects, number);
+        print_string(number, &current_output_row, &b);
+        print_string("/", &current_output_row, &b);
+        int_to_string((int)info[i].total_objects, number);
+        print_string(number, &current_output_row, &b);
+        b = 36;
+        int_to_string((int)info[i].slab_count, number);
+        print_string(number, &current_output_row, &b);
+        current_output_row++;
+    }
+}
+void handle_schedstat() {
+    // Syscall 45: counter context switch dan TLB sejak boot
+    struct SchedulerStatistics stat;
+    user_syscall(45, (uint32_t)&stat, 0, 0);
+
+    const char *label[6] = {"context switches  ", "same process      ", "cr3 reloads       ",
+                            "cr3 reloads saved ", "full tlb flushes  ", "invlpg            "};
+    uint32_t value[6] = {stat.switch_count, stat.same_process_count, stat.tlb.cr3_load_count,
+                         stat.tlb.cr3_load_skip_count, stat.tlb.flush_all_count, stat.tlb.flush_single_count};
+    char number[16];
+    for (int i = 0; i < 6; i++) {
+        int b = 0;
+        print_string(label[i], &current_output_row, &b);
+        int_to_string((int)value[i], number);
+        print_string(number, &current_output_row, &b);
+        current_output_row++;
     }
 }
 int string_to_int(const char* str) {
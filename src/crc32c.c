@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "header/stdlib/crc32c.h"
+
+#define CRC32C_POLY 0x82F63B78 // 0x1EDC6F41 dibalik (LSB first)
+
+// crc32c_table[k][b]: CRC byte b yang diikuti k byte nol, untuk slicing-by-8
+static uint32_t crc32c_table[8][256];
+static bool crc32c_ready = false;
+static bool crc32c_use_hw = false;
+
+#if defined(__i386__) || defined(__x86_64__)
+static bool cpu_has_sse42(void)
+{
+    uint32_t eax = 1, ebx, ecx = 0, edx;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    (void)ebx;
+    (void)edx;
+    return (ecx & (1 << 20)) != 0; // CPUID.01H:ECX.SSE4_2[bit 20]
+}
+
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, uint32_t size)
+{
+    while (size >= 4) {
+        uint32_t word = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        __asm__("crc32l %1, %0" : "+r"(crc) : "rm"(word));
+        p += 4;
+        size -= 4;
+    }
+    while (size--) {
+        __asm__("crc32b %1, %0" : "+r"(crc) : "rm"(*p));
+        p++;
+    }
+    return crc;
+}
+#else
+static bool cpu_has_sse42(void)
+{
+    return false;
+}
+
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, uint32_t size)
+{
+    (void)p;
+    (void)size;
+    return crc;
+}
+#endif
+
+static void crc32c_init(void)
+{
+    for (uint32_t b = 0; b < 256; b++) {
+        uint32_t crc = b;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+        crc32c_table[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; b++) {
+        for (int k = 1; k < 8; k++) {
+            uint32_t prev = crc32c_table[k - 1][b];
+            crc32c_table[k][b] = (prev >> 8) ^ crc32c_table[0][prev & 0xFF];
+        }
+    }
+    crc32c_use_hw = cpu_has_sse42();
+    crc32c_ready = true;
+}
+
+static uint32_t crc32c_sw(uint32_t crc, const uint8_t *p, uint32_t size)
+{
+    // Slicing-by-8: 8 byte per iterasi, 8 tabel lookup independen
+    while (size >= 8) {
+        uint32_t one = crc ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+        uint32_t two = (uint32_t)p[4] | ((uint32_t)p[5] << 8) | ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+        crc = crc32c_table[7][one & 0xFF] ^ crc32c_table[6][(one >> 8) & 0xFF] ^
+              crc32c_table[5][(one >> 16) & 0xFF] ^ crc32c_table[4][one >> 24] ^
+              crc32c_table[3][two & 0xFF] ^ crc32c_table[2][(two >> 8) & 0xFF] ^
+              crc32c_table[1][(two >> 16) & 0xFF] ^ crc32c_table[0][two >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size--)
+        crc = crc32c_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+uint32_t crc32c(uint32_t crc, const void *buf, uint32_t size)
+{
+    if (!crc32c_ready)
+        crc32c_init();
+    if (crc32c_use_hw)
+        return crc32c_hw(crc, (const uint8_t *)buf, size);
+    return crc32c_sw(crc, (const uint8_t *)buf, size);
+}
+
+bool crc32c_hw_enabled(void)
+{
+    if (!crc32c_ready)
+        crc32c_init();
+    return crc32c_use_hw;
+}
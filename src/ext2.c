@@ -3,6 +3,9 @@
 #include <stddef.h>
 #include <stdio.h>
 #include "header/stdlib/string.h"
+#include "header/stdlib/lz4.h"
+#include "header/stdlib/crc32c.h"
+#include "header/stdlib/xxhash.h"
 #include "header/filesystem/ext2.h"
 #include "header/driver/disk.h"
 
@@ -15,6 +18,36 @@
 static struct EXT2Superblock superblock;
 struct EXT2BlockGroupDescriptorTable bgd_table;
 
+// Cache refcount table (1 byte per block). Bit i di block_refcount_dirty = blok ke-i tabel berubah,
+// sync_superblock() hanya menulis balik blok tabel yang bit-nya set
+static uint8_t block_refcount[EXT2_REFCOUNT_TABLE_BLOCKS * BLOCK_SIZE];
+static uint8_t block_refcount_dirty[(EXT2_REFCOUNT_TABLE_BLOCKS + 7) / 8];
+
+// Name index (nama -> inode + parent) di memori, dibangun saat mount dan diupdate oleh
+// add_inode_to_dir / remove_inode_from_dir. Satu entri per inode karena tidak ada hard link,
+// parent == 0 berarti inode tidak terindeks (root, inode bebas)
+struct EXT2NameIndexEntry
+{
+  uint32_t parent;
+  uint8_t name_len;
+  char name[255];
+};
+
+static struct EXT2NameIndexEntry name_index[EXT2_INODES_COUNT + 1];
+static uint32_t name_index_order[EXT2_INODES_COUNT]; // inode, terurut berdasarkan (nama, inode)
+static uint32_t name_index_count = 0;
+static void name_index_rebuild(void);
+
+// Dedup index (hash isi blok data -> nomor blok) di memori, lihat DEDUPLICATION
+static bool dedup_enabled(void);
+static uint32_t dedup_lookup(const uint8_t *data, uint64_t hash, uint32_t exclude);
+static void dedup_insert(uint64_t hash, uint32_t block);
+static void dedup_forget(uint32_t block);
+static void dedup_reset(void);
+
+// Free extent index (run blok bebas) di memori, lihat FREE EXTENT INDEX
+static void free_extent_add(uint32_t start, uint32_t length);
+
 uint32_t ceil_div(uint32_t a, uint32_t b)
 {
   if (b == 0)
@@ -32,6 +65,232 @@ uint32_t ceil_div(uint32_t a, uint32_t b)
   return result;
 }
 
+/* =================== SNAPSHOT =================== */
+
+// Bitmap snapshot di-cache: bit set = isi asli blok sudah disimpan di slot-nya
+static struct
+{
+  bool active;
+  uint32_t changed_blocks;
+  uint8_t bitmap[EXT2_SNAPSHOT_BITMAP_BLOCKS * BLOCK_SIZE];
+} snapshot;
+
+/**
+ * @brief Simpan isi asli blok ke slot snapshot sebelum ditimpa pertama kali.
+ *        Urutan tulis: slot dulu, baru bit, sehingga rollback tidak pernah membaca slot kosong
+ */
+static void snapshot_preserve(uint32_t block)
+{
+  if (block >= BLOCKS_COUNT || (snapshot.bitmap[block / 8] & (1 << (block % 8))))
+    return;
+
+  struct BlockBuffer original;
+  read_blocks(&original, block, 1);
+  write_blocks(&original, EXT2_SNAPSHOT_DATA_LOCATION + block, 1);
+
+  snapshot.bitmap[block / 8] |= 1 << (block % 8);
+  uint32_t bitmap_block = block / (BLOCK_SIZE * 8);
+  write_blocks(snapshot.bitmap + bitmap_block * BLOCK_SIZE, EXT2_SNAPSHOT_LOCATION + 1 + bitmap_block, 1);
+  snapshot.changed_blocks++;
+}
+
+/**
+ * @brief Semua tulisan filesystem lewat sini: selama ada snapshot, isi lama blok disimpan dulu
+ */
+static void fs_write_blocks(const void *ptr, uint32_t logical_block_address, uint8_t block_count)
+{
+  if (snapshot.active)
+  {
+    for (uint32_t i = 0; i < block_count; i++)
+      snapshot_preserve(logical_block_address + i);
+  }
+  write_blocks(ptr, logical_block_address, block_count);
+}
+
+static void snapshot_write_header(bool active)
+{
+  struct BlockBuffer buffer;
+  memset(&buffer, 0, sizeof(buffer));
+  if (active)
+  {
+    struct EXT2SnapshotHeader *header = (struct EXT2SnapshotHeader *)buffer.buf;
+    header->magic = EXT2_SNAPSHOT_MAGIC;
+    header->blocks_count = BLOCKS_COUNT;
+  }
+  write_blocks(&buffer, EXT2_SNAPSHOT_LOCATION, 1);
+}
+
+static void snapshot_clear_bitmap(void)
+{
+  memset(snapshot.bitmap, 0, sizeof(snapshot.bitmap));
+  write_blocks(snapshot.bitmap, EXT2_SNAPSHOT_LOCATION + 1, EXT2_SNAPSHOT_BITMAP_BLOCKS);
+  snapshot.changed_blocks = 0;
+}
+
+/**
+ * @brief Baca header & bitmap snapshot saat mount
+ */
+static void snapshot_load(void)
+{
+  snapshot.active = false;
+  snapshot.changed_blocks = 0;
+  if (!EXT2_SNAPSHOT_SUPPORTED)
+    return;
+
+  struct BlockBuffer buffer;
+  read_blocks(&buffer, EXT2_SNAPSHOT_LOCATION, 1);
+  struct EXT2SnapshotHeader *header = (struct EXT2SnapshotHeader *)buffer.buf;
+  if (header->magic != EXT2_SNAPSHOT_MAGIC || header->blocks_count != BLOCKS_COUNT)
+    return;
+
+  read_blocks(snapshot.bitmap, EXT2_SNAPSHOT_LOCATION + 1, EXT2_SNAPSHOT_BITMAP_BLOCKS);
+  for (uint32_t block = 0; block < BLOCKS_COUNT; block++)
+  {
+    if (snapshot.bitmap[block / 8] & (1 << (block % 8)))
+      snapshot.changed_blocks++;
+  }
+  snapshot.active = true;
+}
+
+int8_t snapshot_create(void)
+{
+  if (!EXT2_SNAPSHOT_SUPPORTED)
+    return -1;
+
+  // Metadata di memori (superblock, BGD, refcount) ditulis dulu agar ikut membeku
+  snapshot.active = false;
+  sync_superblock();
+
+  snapshot_clear_bitmap();
+  snapshot_write_header(true);
+  snapshot.active = true;
+  return 0;
+}
+
+int8_t snapshot_rollback(void)
+{
+  if (!EXT2_SNAPSHOT_SUPPORTED)
+    return -1;
+  if (!snapshot.active)
+    return 1;
+
+  // Hanya blok yang berubah sejak snapshot yang disalin balik; aman diulang jika terputus
+  struct BlockBuffer original;
+  for (uint32_t byte = 0; byte < sizeof(snapshot.bitmap); byte++)
+  {
+    if (snapshot.bitmap[byte] == 0)
+      continue;
+    for (uint32_t bit = 0; bit < 8; bit++)
+    {
+      uint32_t block = byte * 8 + bit;
+      if (!(snapshot.bitmap[byte] & (1 << bit)) || block >= BLOCKS_COUNT)
+        continue;
+      read_blocks(&original, EXT2_SNAPSHOT_DATA_LOCATION + block, 1);
+      write_blocks(&original, block, 1);
+    }
+  }
+  snapshot_clear_bitmap();
+
+  // Semua cache di memori (superblock, refcount, name index, dedup) dibaca ulang dari disk
+  initialize_filesystem_ext2();
+  return 0;
+}
+
+int8_t snapshot_drop(void)
+{
+  if (!EXT2_SNAPSHOT_SUPPORTED)
+    return -1;
+  if (!snapshot.active)
+    return 1;
+
+  snapshot.active = false;
+  snapshot_write_header(false);
+  return 0;
+}
+
+bool snapshot_status(uint32_t *changed_blocks)
+{
+  *changed_blocks = snapshot.active ? snapshot.changed_blocks : 0;
+  return snapshot.active;
+}
+
+/* =================== METADATA CHECKSUM =================== */
+
+static bool metadata_csum_enabled(void)
+{
+  return (superblock.s_feature_ro_compat & EXT2_FEATURE_RO_COMPAT_METADATA_CSUM) != 0;
+}
+
+/**
+ * @brief Checksum tidak cocok: tandai filesystem error (ikut tertulis pada sync_superblock()
+ *        berikutnya), operasi tetap dilanjutkan sesuai s_errors = continue
+ */
+static void report_checksum_error(const char *what, uint32_t id)
+{
+  DEBUG_PRINT("Error: checksum %s %u tidak cocok\n", what, id);
+  (void)what;
+  (void)id;
+  superblock.s_state = EXT2_ERROR_FS;
+}
+
+static uint32_t superblock_checksum(const struct EXT2Superblock *sb)
+{
+  return crc32c(~0u, sb, offsetof(struct EXT2Superblock, s_checksum));
+}
+
+static uint32_t group_desc_checksum(uint32_t group, const struct EXT2BlockGroupDescriptor *desc)
+{
+  uint32_t crc = crc32c(~0u, &group, sizeof(group));
+  crc = crc32c(crc, desc, offsetof(struct EXT2BlockGroupDescriptor, bg_checksum));
+  return crc32c(crc, desc->bg_reserved, sizeof(desc->bg_reserved));
+}
+
+static uint32_t inode_checksum(uint32_t inode, const struct EXT2Inode *node)
+{
+  uint32_t crc = crc32c(~0u, &inode, sizeof(inode));
+  return crc32c(crc, node, offsetof(struct EXT2Inode, i_checksum));
+}
+
+static uint32_t dir_block_checksum(uint32_t block, const uint8_t *buf)
+{
+  uint32_t crc = crc32c(~0u, &block, sizeof(block));
+  return crc32c(crc, buf, BLOCK_SIZE - sizeof(struct EXT2DirectoryTail));
+}
+
+uint32_t get_dir_data_size(void)
+{
+  return metadata_csum_enabled() ? BLOCK_SIZE - sizeof(struct EXT2DirectoryTail) : BLOCK_SIZE;
+}
+
+bool read_dir_block(void *buf, uint32_t block)
+{
+  read_blocks(buf, block, 1);
+  if (!metadata_csum_enabled())
+    return true;
+
+  struct EXT2DirectoryTail *tail = (struct EXT2DirectoryTail *)((uint8_t *)buf + BLOCK_SIZE - sizeof(struct EXT2DirectoryTail));
+  if (tail->det_rec_len != sizeof(struct EXT2DirectoryTail) || tail->det_reserved_ft != EXT2_FT_DIR_CSUM ||
+      tail->det_checksum != dir_block_checksum(block, buf))
+  {
+    report_checksum_error("directory block", block);
+    return false;
+  }
+  return true;
+}
+
+void write_dir_block(void *buf, uint32_t block)
+{
+  if (metadata_csum_enabled())
+  {
+    struct EXT2DirectoryTail *tail = (struct EXT2DirectoryTail *)((uint8_t *)buf + BLOCK_SIZE - sizeof(struct EXT2DirectoryTail));
+    memset(tail, 0, sizeof(*tail));
+    tail->det_rec_len = sizeof(struct EXT2DirectoryTail);
+    tail->det_reserved_ft = EXT2_FT_DIR_CSUM;
+    tail->det_checksum = dir_block_checksum(block, buf);
+  }
+  fs_write_blocks(buf, block, 1);
+}
+
 bool is_inode_used(uint32_t inode)
 {
   uint32_t group = inode_to_bgd(inode);
@@ -54,7 +313,7 @@ void set_inode_used(uint32_t inode)
   struct BlockBuffer buffer;
   read_blocks(&buffer, bgd_table.table[group].bg_inode_bitmap, 1);
   buffer.buf[byte_offset] |= (1 << bit_offset);
-  write_blocks(&buffer, bgd_table.table[group].bg_inode_bitmap, 1);
+  fs_write_blocks(&buffer, bgd_table.table[group].bg_inode_bitmap, 1);
 }
 
 void clear_inode_used(uint32_t inode)
@@ -67,7 +326,8 @@ void clear_inode_used(uint32_t inode)
   struct BlockBuffer buffer;
   read_blocks(&buffer, bgd_table.table[group].bg_inode_bitmap, 1);
   buffer.buf[byte_offset] &= ~(1 << bit_offset);
-  write_blocks(&buffer, bgd_table.table[group].bg_inode_bitmap, 1);
+  fs_write_blocks(&buffer, bgd_table.table[group].bg_inode_bitmap, 1);
+  name_index_remove(inode);
 }
 
 void init_directory_table(struct EXT2Inode *node, uint32_t inode, uint32_t parent_inode)
@@ -88,12 +348,12 @@ void init_directory_table(struct EXT2Inode *node, uint32_t inode, uint32_t paren
   entry->inode = parent_inode;
   entry->name_len = 2;
   entry->file_type = EXT2_FT_DIR;
-  entry->rec_len = BLOCK_SIZE - 12;
+  entry->rec_len = get_dir_data_size() - 12;
   name = (char *)(entry + 1);
   name[0] = '.';
   name[1] = '.';
 
-  write_blocks(dir_data, node->i_block[0], 1);
+  write_dir_block(dir_data, node->i_block[0]);
 }
 
 /**
@@ -103,6 +363,11 @@ uint32_t get_physical_block_from_logical(struct EXT2Inode *inode, uint32_t logic
 {
     const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t); // 128 untuk BLOCK_SIZE=512
     
+    // Inline data tidak punya blok fisik
+    if (inode->i_flags & EXT2_INLINE_DATA_FL) {
+        return 0;
+    }
+
     if (logical_block_idx < 12) {
         // Direct blocks (0-11)
         return inode->i_block[logical_block_idx];
@@ -141,31 +406,141 @@ uint32_t get_physical_block_from_logical(struct EXT2Inode *inode, uint32_t logic
     return 0;
 }
 
+/**
+ * @brief Pindahkan inline data ke blok data pertama, i_block kembali menjadi block map
+ * @return false jika alokasi blok gagal (inode tidak berubah)
+ */
+static bool uninline_data(struct EXT2Inode *inode, uint32_t preferred_bgd)
+{
+    int32_t block = allocate_block(preferred_bgd);
+    if (block < 0)
+        return false;
+
+    struct BlockBuffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    memcpy(buffer.buf, inode->i_block, EXT2_INLINE_DATA_MAX);
+    fs_write_blocks(&buffer, block, 1);
+
+    memset(inode->i_block, 0, sizeof(inode->i_block));
+    inode->i_block[0] = block;
+    inode->i_blocks = 1;
+    inode->i_flags &= ~EXT2_INLINE_DATA_FL;
+    return true;
+}
+
+/**
+ * @brief Salin blok yang sedang dibagi (shared) ke blok baru untuk copy-on-write
+ * @return nomor blok baru, atau 0 jika alokasi gagal
+ */
+static uint32_t copy_shared_block(uint32_t block, uint32_t preferred_bgd)
+{
+    int32_t new_block = allocate_block(preferred_bgd);
+    if (new_block < 0)
+        return 0;
+
+    struct BlockBuffer buffer;
+    read_blocks(&buffer, block, 1);
+    fs_write_blocks(&buffer, new_block, 1);
+
+    // Pemilik lain tetap memegang blok lama
+    block_ref_put(block);
+    return new_block;
+}
+
 /**
  * @brief Mengalokasi blok pada indeks logis tertentu
  */
+/**
+ * @brief Alokasi satu blok, 0 jika disk penuh (allocate_block() mengembalikan -1)
+ */
+static uint32_t allocate_block_or_zero(uint32_t preferred_bgd)
+{
+    int32_t block = allocate_block(preferred_bgd);
+    return block < 0 ? 0 : (uint32_t)block;
+}
+
+/**
+ * @brief Alokasi blok tabel indirect baru yang sudah diisi nol (semua entri = hole)
+ */
+static uint32_t allocate_map_block(uint32_t preferred_bgd)
+{
+    uint32_t block = allocate_block_or_zero(preferred_bgd);
+    if (block != 0) {
+        struct BlockBuffer zero_table;
+        memset(&zero_table, 0, sizeof(zero_table));
+        fs_write_blocks(&zero_table, block, 1);
+    }
+    return block;
+}
+
+// Isi akhir blok yang sedang ditulis lewat write_logical_block(), dibaca ensure_owned_entry()
+static struct
+{
+    const uint8_t *data; // NULL: dedup tidak dipakai untuk alokasi ini
+    uint64_t hash;
+    bool hit;            // entri diarahkan ke blok lain yang isinya sama
+} dedup_pending;
+
+/**
+ * @brief Pastikan entri map[idx] menunjuk blok data milik inode ini:
+ *        hole dialokasi, blok yang masih dibagi di-copy-on-write
+ * @return true jika entri berubah dan tabel perlu ditulis ulang
+ */
+static bool ensure_owned_entry(uint32_t *entry, uint32_t preferred_bgd)
+{
+    // Isi akhir blok sudah ada di blok lain: ikut memakai blok itu, tidak perlu alokasi / COW.
+    // Blok lama dilepas (dibebaskan jika inode ini pemilik terakhirnya)
+    if (dedup_pending.data != NULL) {
+        uint32_t twin = dedup_lookup(dedup_pending.data, dedup_pending.hash, 0);
+        if (twin != 0 && (twin == *entry || block_ref_get(twin))) {
+            dedup_pending.hit = true;
+            if (twin == *entry)
+                return false;
+            deallocate_block(*entry);
+            *entry = twin;
+            return true;
+        }
+        // Twin sudah EXT2_REFCOUNT_MAX pemilik: keluarkan dari index supaya blok yang ditulis
+        // sekarang menjadi twin berikutnya, bukan dicocokkan (dan dibaca) ulang di setiap tulisan
+        if (twin != 0 && twin != *entry)
+            dedup_forget(twin);
+    }
+    if (*entry == 0) {
+        *entry = allocate_block_or_zero(preferred_bgd);
+        return *entry != 0;
+    }
+    if (is_block_shared(*entry)) {
+        uint32_t copy = copy_shared_block(*entry, preferred_bgd);
+        if (copy == 0) return false;
+        *entry = copy;
+        return true;
+    }
+    return false;
+}
+
 uint32_t allocate_logical_block(struct EXT2Inode *inode, uint32_t logical_block_idx, uint32_t preferred_bgd)
 {
+    // Inline data harus dipindah ke blok data dulu sebelum punya block map
+    if ((inode->i_flags & EXT2_INLINE_DATA_FL) && !uninline_data(inode, preferred_bgd)) {
+        return 0;
+    }
+
     const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
     
     if (logical_block_idx < 12) {
         // Direct blocks
-        if (inode->i_block[logical_block_idx] == 0) {
-            inode->i_block[logical_block_idx] = allocate_block(preferred_bgd);
-        }
-        return inode->i_block[logical_block_idx];
+        uint32_t entry = inode->i_block[logical_block_idx];
+        ensure_owned_entry(&entry, preferred_bgd);
+        inode->i_block[logical_block_idx] = entry;
+        return entry;
     }
     else if (logical_block_idx < 12 + ptrs_per_block) {
         // Single indirect block
         
         // Alokasi blok untuk indirect table jika belum ada
         if (inode->i_block[12] == 0) {
-            inode->i_block[12] = allocate_block(preferred_bgd);
-            
-            // Inisialisasi indirect table dengan nol
-            uint32_t zero_table[ptrs_per_block];
-            memset(zero_table, 0, BLOCK_SIZE);
-            write_blocks(zero_table, inode->i_block[12], 1);
+            inode->i_block[12] = allocate_map_block(preferred_bgd);
+            if (inode->i_block[12] == 0) return 0;
         }
         
         // Baca indirect table
@@ -174,10 +549,9 @@ uint32_t allocate_logical_block(struct EXT2Inode *inode, uint32_t logical_block_
         
         uint32_t indirect_idx = logical_block_idx - 12;
         
-        // Alokasi blok data jika belum ada
-        if (indirect_table[indirect_idx] == 0) {
-            indirect_table[indirect_idx] = allocate_block(preferred_bgd);
-            write_blocks(indirect_table, inode->i_block[12], 1);
+        // Alokasi blok data jika belum ada (hole), atau salin jika masih dibagi
+        if (ensure_owned_entry(&indirect_table[indirect_idx], preferred_bgd)) {
+            fs_write_blocks(indirect_table, inode->i_block[12], 1);
         }
         
         return indirect_table[indirect_idx];
@@ -187,11 +561,8 @@ uint32_t allocate_logical_block(struct EXT2Inode *inode, uint32_t logical_block_
         
         // Alokasi blok untuk double indirect table jika belum ada
         if (inode->i_block[13] == 0) {
-            inode->i_block[13] = allocate_block(preferred_bgd);
-            
-            uint32_t zero_table[ptrs_per_block];
-            memset(zero_table, 0, BLOCK_SIZE);
-            write_blocks(zero_table, inode->i_block[13], 1);
+            inode->i_block[13] = allocate_map_block(preferred_bgd);
+            if (inode->i_block[13] == 0) return 0;
         }
         
         // Baca double indirect table
@@ -205,22 +576,18 @@ uint32_t allocate_logical_block(struct EXT2Inode *inode, uint32_t logical_block_
         
         // Alokasi blok untuk indirect table level kedua jika belum ada
         if (double_indirect_table[first_level_idx] == 0) {
-            double_indirect_table[first_level_idx] = allocate_block(preferred_bgd);
-            write_blocks(double_indirect_table, inode->i_block[13], 1);
-            
-            uint32_t zero_table[ptrs_per_block];
-            memset(zero_table, 0, BLOCK_SIZE);
-            write_blocks(zero_table, double_indirect_table[first_level_idx], 1);
+            double_indirect_table[first_level_idx] = allocate_map_block(preferred_bgd);
+            if (double_indirect_table[first_level_idx] == 0) return 0;
+            fs_write_blocks(double_indirect_table, inode->i_block[13], 1);
         }
         
         // Baca indirect table level kedua
         uint32_t indirect_table[ptrs_per_block];
         read_blocks(indirect_table, double_indirect_table[first_level_idx], 1);
         
-        // Alokasi blok data jika belum ada
-        if (indirect_table[second_level_idx] == 0) {
-            indirect_table[second_level_idx] = allocate_block(preferred_bgd);
-            write_blocks(indirect_table, double_indirect_table[first_level_idx], 1);
+        // Alokasi blok data jika belum ada (hole), atau salin jika masih dibagi
+        if (ensure_owned_entry(&indirect_table[second_level_idx], preferred_bgd)) {
+            fs_write_blocks(indirect_table, double_indirect_table[first_level_idx], 1);
         }
         
         return indirect_table[second_level_idx];
@@ -230,193 +597,704 @@ uint32_t allocate_logical_block(struct EXT2Inode *inode, uint32_t logical_block_
 }
 
 /**
- * @brief Membaca data dari inode dengan dukungan indirect blocks
+ * @brief Tulis satu blok data penuh pada indeks logis. Jika isi yang sama sudah ada
+ *        di blok lain, entri cukup diarahkan ke blok itu (online dedup, refcount naik)
+ * @param block_data isi akhir blok, BLOCK_SIZE byte
+ * @return nomor blok fisik, 0 jika alokasi gagal
  */
-void read_inode_data_extended(struct EXT2Inode *inode, void *buf, uint32_t size)
+static uint32_t write_logical_block(struct EXT2Inode *inode, uint32_t logical_block_idx, const uint8_t *block_data, uint32_t preferred_bgd)
 {
-    if (inode == NULL || size == 0)
-        return;
-
-    uint32_t bytes_read = 0;
-    uint32_t logical_block_idx = 0;
-    uint32_t total_blocks = ceil_div(inode->i_size, BLOCK_SIZE);
-    
-    uint8_t *output_buffer = (uint8_t *)buf;
-
-    while (bytes_read < size && logical_block_idx < total_blocks)
-    {
-        // Dapatkan nomor blok fisik
-        uint32_t physical_block = get_physical_block_from_logical(inode, logical_block_idx);
-        
-        if (physical_block != 0) {
-            uint8_t block_buf[BLOCK_SIZE];
-            read_blocks(block_buf, physical_block, 1);
-
-            uint32_t to_read = size - bytes_read;
-            if (to_read > BLOCK_SIZE)
-                to_read = BLOCK_SIZE;
-                
-            // Untuk blok terakhir, batasi sesuai ukuran file sebenarnya
-            uint32_t file_bytes_remaining = inode->i_size - bytes_read;
-            if (to_read > file_bytes_remaining)
-                to_read = file_bytes_remaining;
-
-            memcpy(output_buffer + bytes_read, block_buf, to_read);
-            bytes_read += to_read;
-        } else {
-            // Blok tidak dialokasi, isi dengan nol (sparse file)
-            uint32_t to_read = size - bytes_read;
-            if (to_read > BLOCK_SIZE)
-                to_read = BLOCK_SIZE;
-                
-            uint32_t file_bytes_remaining = inode->i_size - bytes_read;
-            if (to_read > file_bytes_remaining)
-                to_read = file_bytes_remaining;
-            
-            memset(output_buffer + bytes_read, 0, to_read);
-            bytes_read += to_read;
-        }
-        
-        logical_block_idx++;
+    bool dedup = EXT2_DEDUP_ONLINE && dedup_enabled();
+    dedup_pending.data = dedup ? block_data : NULL;
+    dedup_pending.hash = dedup_pending.data != NULL ? xxh64(block_data, BLOCK_SIZE, 0) : 0;
+    dedup_pending.hit = false;
+
+    uint32_t physical_block = allocate_logical_block(inode, logical_block_idx, preferred_bgd);
+    bool hit = dedup_pending.hit;
+    dedup_pending.data = NULL;
+
+    if (physical_block != 0 && !hit) {
+        fs_write_blocks(block_data, physical_block, 1);
+        if (dedup)
+            dedup_insert(dedup_pending.hash, physical_block);
     }
+    return physical_block;
 }
 
 /**
- * @brief Mengalokasi blok untuk inode dengan dukungan indirect blocks
+ * @brief Membaca data dari inode dengan dukungan indirect blocks
  */
-void allocate_node_blocks_extended(void *ptr, struct EXT2Inode *node, uint32_t preferred_bgd)
+/**
+ * @brief Cache tabel indirect terakhir saat block map ditelusuri berurutan,
+ *        sehingga tabel yang sama tidak dibaca ulang untuk setiap blok data
+ */
+struct BlockMapCursor
 {
-    uint32_t blocks_needed = ceil_div(node->i_size, BLOCK_SIZE);
-    uint8_t *data = (uint8_t *)ptr;
-    
-    // Update jumlah blok yang dialokasikan
-    node->i_blocks = blocks_needed;
-    
-    // Batasi maksimum blok yang didukung untuk filesystem 4MB
-    const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t); // 128
-    uint32_t max_direct = 12;
-    uint32_t max_single_indirect = ptrs_per_block; // 128
-    uint32_t max_double_indirect = ptrs_per_block * ptrs_per_block; // 16384
-    uint32_t max_supported = max_direct + max_single_indirect + max_double_indirect; // 16524
-    
-    if (blocks_needed > max_supported) {
-        DEBUG_PRINT("Error: File terlalu besar. Max blok yang didukung: %u, diminta: %u\n", 
-                   max_supported, blocks_needed);
-        blocks_needed = max_supported;
-        node->i_blocks = blocks_needed;
-    }
+    uint32_t table_block[2]; // blok tabel yang sedang di-cache (0 = kosong)
+    uint32_t table[2][BLOCK_SIZE / sizeof(uint32_t)];
+};
 
-    // Alokasi blok secara berurutan
-    for (uint32_t logical_block_idx = 0; logical_block_idx < blocks_needed; logical_block_idx++) {
-        uint32_t physical_block = allocate_logical_block(node, logical_block_idx, preferred_bgd);
-        
-        if (physical_block != 0) {
-            // Tulis data ke blok
-            uint32_t bytes_to_write = node->i_size - (logical_block_idx * BLOCK_SIZE);
-            if (bytes_to_write > BLOCK_SIZE)
-                bytes_to_write = BLOCK_SIZE;
-
-            uint8_t buffer[BLOCK_SIZE] = {0};
-            if (data != NULL) {
-                memcpy(buffer, data + (logical_block_idx * BLOCK_SIZE), bytes_to_write);
-            }
-            write_blocks(buffer, physical_block, 1);
-        } else {
-            DEBUG_PRINT("Error: Gagal mengalokasi blok logis %u\n", logical_block_idx);
-            break;
-        }
+static uint32_t *cursor_table(struct BlockMapCursor *cursor, uint32_t level, uint32_t block)
+{
+    if (cursor->table_block[level] != block) {
+        read_blocks(cursor->table[level], block, 1);
+        cursor->table_block[level] = block;
     }
+    return cursor->table[level];
 }
 
 /**
- * @brief Fungsi dealokasi blok dengan dukungan indirect blocks
+ * @brief Seperti get_physical_block_from_logical() tetapi memakai cursor.
+ *        Hole di bawah tabel indirect yang belum dialokasi langsung 0 tanpa I/O
  */
-void deallocate_node_blocks_extended(struct EXT2Inode *inode)
+static uint32_t cursor_physical_block(struct EXT2Inode *inode, uint32_t logical_block_idx, struct BlockMapCursor *cursor)
 {
-    if (inode == NULL) return;
-    
     const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
-    
-    // Dealokasi direct blocks (0-11)
-    for (uint32_t i = 0; i < 12 && i < inode->i_blocks; i++) {
-        if (inode->i_block[i] != 0) {
-            set_block_free(inode->i_block[i]);
-            inode->i_block[i] = 0;
-        }
-    }
 
-    // Dealokasi single indirect blocks
-    if (inode->i_block[12] != 0) {
-        uint32_t indirect_table[ptrs_per_block];
-        read_blocks(indirect_table, inode->i_block[12], 1);
-        
-        // Dealokasi semua blok data yang dirujuk
-        for (uint32_t i = 0; i < ptrs_per_block; i++) {
-            if (indirect_table[i] != 0) {
-                set_block_free(indirect_table[i]);
-            }
-        }
-        
-        // Dealokasi blok indirect table itu sendiri
-        set_block_free(inode->i_block[12]);
-        inode->i_block[12] = 0;
-    }
+    if (logical_block_idx < 12)
+        return inode->i_block[logical_block_idx];
 
-    // Dealokasi double indirect blocks
-    if (inode->i_block[13] != 0) {
-        uint32_t double_indirect_table[ptrs_per_block];
-        read_blocks(double_indirect_table, inode->i_block[13], 1);
-        
-        for (uint32_t i = 0; i < ptrs_per_block; i++) {
-            if (double_indirect_table[i] != 0) {
-                uint32_t indirect_table[ptrs_per_block];
-                read_blocks(indirect_table, double_indirect_table[i], 1);
-                
-                // Dealokasi semua blok data yang dirujuk
-                for (uint32_t j = 0; j < ptrs_per_block; j++) {
-                    if (indirect_table[j] != 0) {
-                        set_block_free(indirect_table[j]);
-                    }
-                }
-                
-                // Dealokasi indirect table level kedua
-                set_block_free(double_indirect_table[i]);
-            }
-        }
-        
-        // Dealokasi double indirect table itu sendiri
-        set_block_free(inode->i_block[13]);
-        inode->i_block[13] = 0;
+    logical_block_idx -= 12;
+    if (logical_block_idx < ptrs_per_block) {
+        if (inode->i_block[12] == 0) return 0;
+        return cursor_table(cursor, 0, inode->i_block[12])[logical_block_idx];
     }
 
-    // Reset semua pointer
-    for (uint32_t i = 0; i < 15; i++) {
-        inode->i_block[i] = 0;
+    logical_block_idx -= ptrs_per_block;
+    if (logical_block_idx < ptrs_per_block * ptrs_per_block) {
+        if (inode->i_block[13] == 0) return 0;
+        uint32_t second_level = cursor_table(cursor, 0, inode->i_block[13])[logical_block_idx / ptrs_per_block];
+        if (second_level == 0) return 0;
+        return cursor_table(cursor, 1, second_level)[logical_block_idx % ptrs_per_block];
     }
-    inode->i_blocks = 0;
+
+    return 0; // Triple indirect tidak didukung
 }
 
-void allocate_node_blocks(void *ptr, struct EXT2Inode *node, uint32_t prefered_bgd)
+/**
+ * @brief Cek apakah seluruh byte bernilai nol (blok seperti ini disimpan sebagai hole)
+ */
+static bool is_zero_data(const uint8_t *data, uint32_t size)
 {
-  uint32_t blocks_needed = ceil_div(node->i_size, BLOCK_SIZE);
-  uint8_t *data = (uint8_t *)ptr;
+    for (uint32_t i = 0; i < size; i++) {
+        if (data[i] != 0)
+            return false;
+    }
+    return true;
+}
 
-  // Batasi jumlah blok yang digunakan (hanya direct blocks)
-  uint32_t blocks_to_allocate = blocks_needed > 12 ? 12 : blocks_needed;
-  node->i_blocks = blocks_to_allocate;
+/* =================== COMPRESSED CLUSTERS =================== */
 
-  for (uint32_t i = 0; i < blocks_to_allocate; i++)
-  {
-    node->i_block[i] = allocate_block(prefered_bgd);
+// Buffer kerja cluster (driver ext2 tidak dipanggil secara reentrant):
+// compr_block_buf menampung header + data LZ4, compr_data_buf isi cluster asli
+static uint8_t compr_block_buf[EXT2_COMPR_CLUSTER_SIZE];
+static uint8_t compr_data_buf[EXT2_COMPR_CLUSTER_SIZE];
 
-    // Tulis data ke blok ini
-    uint32_t bytes_to_write = node->i_size - (i * BLOCK_SIZE);
-    if (bytes_to_write > BLOCK_SIZE)
-      bytes_to_write = BLOCK_SIZE;
+/**
+ * @brief Data inode disimpan dalam cluster terkompresi (inline data & direktori tidak)
+ */
+static bool is_compressed_file(struct EXT2Inode *inode)
+{
+    return (inode->i_flags & EXT2_COMPR_FL) && !(inode->i_flags & EXT2_INLINE_DATA_FL) &&
+           !is_directory(inode);
+}
+
+/**
+ * @brief Jumlah blok cluster ke-cluster_idx yang berada di dalam file berukuran file_size
+ */
+static uint32_t cluster_block_count(uint32_t file_size, uint32_t cluster_idx)
+{
+    uint32_t first = cluster_idx * EXT2_COMPR_CLUSTER_BLOCKS;
+    uint32_t total = ceil_div(file_size, BLOCK_SIZE);
+    if (first >= total)
+        return 0;
+    return total - first < EXT2_COMPR_CLUSTER_BLOCKS ? total - first : EXT2_COMPR_CLUSTER_BLOCKS;
+}
+
+/**
+ * @brief Jadikan blok logis hole: entri block map dikosongkan dan blok dilepas
+ *        (blok reflink cukup dikurangi refcount-nya). Tabel indirect dibiarkan
+ */
+static void punch_logical_block(struct EXT2Inode *inode, uint32_t logical_block_idx)
+{
+    const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
+    uint32_t block;
+
+    if (logical_block_idx < 12) {
+        block = inode->i_block[logical_block_idx];
+        inode->i_block[logical_block_idx] = 0;
+    } else {
+        uint32_t table_block, entry;
+        uint32_t idx = logical_block_idx - 12;
+
+        if (idx < ptrs_per_block) {
+            table_block = inode->i_block[12];
+            entry = idx;
+        } else if (idx - ptrs_per_block < ptrs_per_block * ptrs_per_block) {
+            idx -= ptrs_per_block;
+            if (inode->i_block[13] == 0) return;
+            uint32_t double_indirect_table[ptrs_per_block];
+            read_blocks(double_indirect_table, inode->i_block[13], 1);
+            table_block = double_indirect_table[idx / ptrs_per_block];
+            entry = idx % ptrs_per_block;
+        } else {
+            return; // Triple indirect tidak didukung
+        }
+
+        if (table_block == 0) return;
+        uint32_t table[ptrs_per_block];
+        read_blocks(table, table_block, 1);
+        block = table[entry];
+        if (block == 0) return;
+        table[entry] = 0;
+        fs_write_blocks(table, table_block, 1);
+    }
+
+    if (block != 0) {
+        deallocate_block(block);
+        if (inode->i_blocks > 0)
+            inode->i_blocks--;
+    }
+}
+
+/**
+ * @brief Baca isi satu cluster ke out (minimal EXT2_COMPR_CLUSTER_SIZE byte, sisa diisi nol).
+ *        Cluster terkompresi: blok pertama terisi, blok terakhir (dalam i_size) hole,
+ *        dan header valid. Selain itu blok dibaca apa adanya, hole menjadi nol
+ */
+static void read_cluster(struct EXT2Inode *inode, uint32_t cluster_idx, uint8_t *out, struct BlockMapCursor *cursor)
+{
+    uint32_t n = cluster_block_count(inode->i_size, cluster_idx);
+    uint32_t first = cluster_idx * EXT2_COMPR_CLUSTER_BLOCKS;
+    uint32_t physical[EXT2_COMPR_CLUSTER_BLOCKS];
+
+    memset(out, 0, EXT2_COMPR_CLUSTER_SIZE);
+    for (uint32_t i = 0; i < n; i++)
+        physical[i] = cursor_physical_block(inode, first + i, cursor);
+
+    if (is_compressed_file(inode) && n > 1 && physical[0] != 0 && physical[n - 1] == 0) {
+        uint32_t used = 0;
+        while (used < n && physical[used] != 0) {
+            read_blocks(compr_block_buf + used * BLOCK_SIZE, physical[used], 1);
+            used++;
+        }
+
+        struct EXT2ComprClusterHeader *header = (struct EXT2ComprClusterHeader *)compr_block_buf;
+        if (header->magic == EXT2_COMPR_MAGIC &&
+            header->compressed_size <= used * BLOCK_SIZE - sizeof(*header) &&
+            header->original_size <= n * BLOCK_SIZE &&
+            lz4_decompress(compr_block_buf + sizeof(*header), header->compressed_size, out,
+                           n * BLOCK_SIZE) == (int32_t)header->original_size)
+            return;
+
+        DEBUG_PRINT("Warning: cluster %u rusak, dibaca sebagai blok biasa\n", cluster_idx);
+        memset(out, 0, EXT2_COMPR_CLUSTER_SIZE);
+    }
+
+    // Cluster biasa: blok fisik berurutan digabung menjadi satu read_blocks()
+    uint32_t i = 0;
+    while (i < n) {
+        if (physical[i] == 0) {
+            i++;
+            continue;
+        }
+        uint32_t run = 1;
+        while (i + run < n && physical[i + run] == physical[i] + run)
+            run++;
+        read_blocks(out + i * BLOCK_SIZE, physical[i], run);
+        i += run;
+    }
+}
+
+/**
+ * @brief Tulis data[0..len) sebagai isi cluster ke-cluster_idx (len <= EXT2_COMPR_CLUSTER_SIZE).
+ *        File terkompresi: dikompresi jika menghemat minimal satu blok, selain itu semua blok
+ *        ditulis mentah. File biasa: blok nol menjadi hole. Blok sisa cluster dijadikan hole
+ * @return false jika disk penuh
+ */
+static bool write_cluster(struct EXT2Inode *inode, uint32_t cluster_idx, const uint8_t *data, uint32_t len, uint32_t preferred_bgd)
+{
+    uint32_t first = cluster_idx * EXT2_COMPR_CLUSTER_BLOCKS;
+    uint32_t n = ceil_div(len, BLOCK_SIZE);
+    bool compressed_file = is_compressed_file(inode);
+    const uint8_t *src = data;
+    uint32_t src_len = len;
+    uint32_t used = n;
+
+    if (is_zero_data(data, len)) {
+        used = 0;
+    } else if (compressed_file && n > 1) {
+        struct EXT2ComprClusterHeader *header = (struct EXT2ComprClusterHeader *)compr_block_buf;
+        uint32_t compressed_size = lz4_compress(data, len, compr_block_buf + sizeof(*header),
+                                                (n - 1) * BLOCK_SIZE - sizeof(*header));
+        if (compressed_size > 0) {
+            header->magic = EXT2_COMPR_MAGIC;
+            header->compressed_size = compressed_size;
+            header->original_size = len;
+            header->reserved = 0;
+            src = compr_block_buf;
+            src_len = sizeof(*header) + compressed_size;
+            used = ceil_div(src_len, BLOCK_SIZE);
+        }
+    }
+
+    for (uint32_t i = 0; i < used; i++) {
+        uint32_t bytes = src_len - i * BLOCK_SIZE;
+        if (bytes > BLOCK_SIZE)
+            bytes = BLOCK_SIZE;
+
+        // File biasa tetap sparse per blok; cluster mentah file terkompresi harus penuh
+        if (!compressed_file && is_zero_data(src + i * BLOCK_SIZE, bytes)) {
+            punch_logical_block(inode, first + i);
+            continue;
+        }
+
+        bool was_hole = get_physical_block_from_logical(inode, first + i) == 0;
+        uint32_t physical_block = allocate_logical_block(inode, first + i, preferred_bgd);
+        if (physical_block == 0)
+            return false;
+        if (was_hole)
+            inode->i_blocks++;
+
+        if (bytes == BLOCK_SIZE) {
+            fs_write_blocks(src + i * BLOCK_SIZE, physical_block, 1);
+        } else {
+            uint8_t block_buf[BLOCK_SIZE];
+            memset(block_buf, 0, BLOCK_SIZE);
+            memcpy(block_buf, src + i * BLOCK_SIZE, bytes);
+            fs_write_blocks(block_buf, physical_block, 1);
+        }
+    }
+
+    for (uint32_t i = used; i < EXT2_COMPR_CLUSTER_BLOCKS; i++)
+        punch_logical_block(inode, first + i);
+    return true;
+}
+
+/**
+ * @brief Baca size byte pertama file terkompresi, cluster per cluster.
+ *        Cluster yang muat didekompresi langsung ke buffer tujuan
+ */
+static void read_compressed_data(struct EXT2Inode *inode, uint8_t *buf, uint32_t size)
+{
+    struct BlockMapCursor cursor;
+    cursor.table_block[0] = cursor.table_block[1] = 0;
+
+    for (uint32_t offset = 0, cluster_idx = 0; offset < size; offset += EXT2_COMPR_CLUSTER_SIZE, cluster_idx++) {
+        uint32_t len = size - offset;
+        if (len >= EXT2_COMPR_CLUSTER_SIZE) {
+            read_cluster(inode, cluster_idx, buf + offset, &cursor);
+        } else {
+            read_cluster(inode, cluster_idx, compr_data_buf, &cursor);
+            memcpy(buf + offset, compr_data_buf, len);
+        }
+    }
+}
+
+/**
+ * @brief Tulis ulang setiap cluster yang tersentuh range [offset, offset+size) dari
+ *        isi lama + data baru. Cluster terakhir yang lama ikut ditulis ulang bila file
+ *        membesar, karena jumlah bloknya (dan cara membacanya) berubah
+ * @return false jika disk penuh
+ */
+static bool write_compressed_range(struct EXT2Inode *inode, const uint8_t *data, uint32_t offset, uint32_t size,
+                                   uint32_t new_size, uint32_t preferred_bgd)
+{
+    uint32_t end = offset + size;
+    uint32_t first_cluster = offset / EXT2_COMPR_CLUSTER_SIZE;
+    uint32_t last_cluster = (end - 1) / EXT2_COMPR_CLUSTER_SIZE;
+    if (new_size > inode->i_size && inode->i_size > 0 && (inode->i_size - 1) / EXT2_COMPR_CLUSTER_SIZE < first_cluster)
+        first_cluster = (inode->i_size - 1) / EXT2_COMPR_CLUSTER_SIZE;
+
+    for (uint32_t cluster_idx = first_cluster; cluster_idx <= last_cluster; cluster_idx++) {
+        uint32_t cluster_start = cluster_idx * EXT2_COMPR_CLUSTER_SIZE;
+
+        // Block map berubah setiap write_cluster(), cursor tidak boleh dipakai ulang
+        struct BlockMapCursor cursor;
+        cursor.table_block[0] = cursor.table_block[1] = 0;
+        read_cluster(inode, cluster_idx, compr_data_buf, &cursor);
+
+        uint32_t lo = offset > cluster_start ? offset : cluster_start;
+        uint32_t hi = end < cluster_start + EXT2_COMPR_CLUSTER_SIZE ? end : cluster_start + EXT2_COMPR_CLUSTER_SIZE;
+        if (lo < hi)
+            memcpy(compr_data_buf + (lo - cluster_start), data + (lo - offset), hi - lo);
+
+        uint32_t len = new_size - cluster_start;
+        if (len > EXT2_COMPR_CLUSTER_SIZE)
+            len = EXT2_COMPR_CLUSTER_SIZE;
+        if (!write_cluster(inode, cluster_idx, compr_data_buf, len, preferred_bgd))
+            return false;
+    }
+    return true;
+}
+
+void read_inode_data_extended(struct EXT2Inode *inode, void *buf, uint32_t size)
+{
+    if (inode == NULL || size == 0)
+        return;
+
+    // Inline data: isi file ada di i_block, tidak perlu baca blok data
+    if (inode->i_flags & EXT2_INLINE_DATA_FL)
+    {
+        uint32_t to_read = size < inode->i_size ? size : inode->i_size;
+        if (to_read > EXT2_INLINE_DATA_MAX)
+            to_read = EXT2_INLINE_DATA_MAX;
+        memcpy(buf, inode->i_block, to_read);
+        return;
+    }
+
+    if (size > inode->i_size)
+        size = inode->i_size;
+
+    // File terkompresi: setiap cluster didekompresi, lebih sedikit blok yang dibaca dari disk
+    if (is_compressed_file(inode))
+    {
+        read_compressed_data(inode, (uint8_t *)buf, size);
+        return;
+    }
+
+    uint8_t *output_buffer = (uint8_t *)buf;
+    uint32_t full_blocks = size / BLOCK_SIZE;
+    struct BlockMapCursor cursor;
+    cursor.table_block[0] = cursor.table_block[1] = 0;
+
+    // Blok penuh dibaca langsung ke buffer tujuan, blok fisik yang berurutan
+    // digabung menjadi satu read_blocks(). Hole diisi nol tanpa I/O
+    uint32_t logical_block_idx = 0;
+    while (logical_block_idx < full_blocks)
+    {
+        uint32_t physical_block = cursor_physical_block(inode, logical_block_idx, &cursor);
+        uint8_t *dst = output_buffer + logical_block_idx * BLOCK_SIZE;
+
+        if (physical_block == 0) {
+            memset(dst, 0, BLOCK_SIZE);
+            logical_block_idx++;
+            continue;
+        }
+
+        uint32_t run = 1;
+        while (logical_block_idx + run < full_blocks && run < 255 &&
+               cursor_physical_block(inode, logical_block_idx + run, &cursor) == physical_block + run)
+            run++;
+
+        read_blocks(dst, physical_block, run);
+        logical_block_idx += run;
+    }
+
+    // Sisa blok terakhir yang tidak penuh
+    uint32_t tail = size - full_blocks * BLOCK_SIZE;
+    if (tail > 0)
+    {
+        uint32_t physical_block = cursor_physical_block(inode, full_blocks, &cursor);
+        uint8_t *dst = output_buffer + full_blocks * BLOCK_SIZE;
+        if (physical_block == 0) {
+            memset(dst, 0, tail);
+        } else {
+            uint8_t block_buf[BLOCK_SIZE];
+            read_blocks(block_buf, physical_block, 1);
+            memcpy(dst, block_buf, tail);
+        }
+    }
+}
+
+uint32_t read_inode_range(struct EXT2Inode *inode, void *buf, uint32_t offset, uint32_t size)
+{
+    if (inode == NULL || offset >= inode->i_size)
+        return 0;
+    if (size > inode->i_size - offset)
+        size = inode->i_size - offset;
+    if (size == 0)
+        return 0;
+
+    // Dari awal file: jalur biasa sudah menggabung blok berurutan
+    if (offset == 0) {
+        read_inode_data_extended(inode, buf, size);
+        return size;
+    }
+
+    uint8_t *out = (uint8_t *)buf;
+    if (inode->i_flags & EXT2_INLINE_DATA_FL) {
+        memcpy(out, (uint8_t *)inode->i_block + offset, size);
+        return size;
+    }
+
+    struct BlockMapCursor cursor;
+    cursor.table_block[0] = cursor.table_block[1] = 0;
+    uint32_t pos = offset, end = offset + size;
+
+    // File terkompresi: hanya cluster yang tersentuh range yang didekompresi
+    if (is_compressed_file(inode)) {
+        while (pos < end) {
+            uint32_t cluster_idx = pos / EXT2_COMPR_CLUSTER_SIZE;
+            uint32_t in_cluster = pos % EXT2_COMPR_CLUSTER_SIZE;
+            uint32_t len = EXT2_COMPR_CLUSTER_SIZE - in_cluster;
+            if (len > end - pos)
+                len = end - pos;
+            read_cluster(inode, cluster_idx, compr_data_buf, &cursor);
+            memcpy(out + (pos - offset), compr_data_buf + in_cluster, len);
+            pos += len;
+        }
+        return size;
+    }
+
+    while (pos < end) {
+        uint32_t in_block = pos % BLOCK_SIZE;
+        uint32_t len = BLOCK_SIZE - in_block;
+        if (len > end - pos)
+            len = end - pos;
+        uint8_t *dst = out + (pos - offset);
+        uint32_t physical_block = cursor_physical_block(inode, pos / BLOCK_SIZE, &cursor);
+
+        if (physical_block == 0) {
+            memset(dst, 0, len);
+        } else if (len == BLOCK_SIZE) {
+            read_blocks(dst, physical_block, 1);
+        } else {
+            uint8_t block_buf[BLOCK_SIZE];
+            read_blocks(block_buf, physical_block, 1);
+            memcpy(dst, block_buf + in_block, len);
+        }
+        pos += len;
+    }
+    return size;
+}
+
+/**
+ * @brief Mengalokasi blok untuk inode dengan dukungan indirect blocks
+ */
+void allocate_node_blocks_extended(void *ptr, struct EXT2Inode *node, uint32_t preferred_bgd)
+{
+    uint32_t blocks_needed = ceil_div(node->i_size, BLOCK_SIZE);
+    uint8_t *data = (uint8_t *)ptr;
+    
+    // i_blocks hanya menghitung blok data yang benar-benar dialokasi (hole tidak dihitung)
+    node->i_blocks = 0;
+    
+    // Batasi maksimum blok yang didukung untuk filesystem 4MB
+    const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t); // 128
+    uint32_t max_direct = 12;
+    uint32_t max_single_indirect = ptrs_per_block; // 128
+    uint32_t max_double_indirect = ptrs_per_block * ptrs_per_block; // 16384
+    uint32_t max_supported = max_direct + max_single_indirect + max_double_indirect; // 16524
+    
+    if (blocks_needed > max_supported) {
+        DEBUG_PRINT("Error: File terlalu besar. Max blok yang didukung: %u, diminta: %u\n", 
+                   max_supported, blocks_needed);
+        blocks_needed = max_supported;
+    }
+
+    // Tanpa data (ptr == NULL) seluruh file adalah hole
+    if (data == NULL)
+        return;
+
+    // Best-fit: seluruh file (plus tabel indirect) dicarikan satu run bebas yang cukup
+    uint32_t map_blocks = blocks_needed > 12 ? 1 + ceil_div(blocks_needed - 12, ptrs_per_block) : 0;
+    preferred_bgd = plan_contiguous_allocation(blocks_needed + map_blocks, preferred_bgd);
+
+    // File terkompresi ditulis per cluster
+    if (is_compressed_file(node)) {
+        for (uint32_t offset = 0, cluster_idx = 0; offset < node->i_size; offset += EXT2_COMPR_CLUSTER_SIZE, cluster_idx++) {
+            uint32_t len = node->i_size - offset;
+            if (len > EXT2_COMPR_CLUSTER_SIZE)
+                len = EXT2_COMPR_CLUSTER_SIZE;
+            if (!write_cluster(node, cluster_idx, data + offset, len, preferred_bgd)) {
+                DEBUG_PRINT("Error: Gagal menulis cluster %u\n", cluster_idx);
+                break;
+            }
+        }
+        return;
+    }
+
+    // Alokasi blok secara berurutan, blok yang seluruhnya nol dilewati (sparse)
+    for (uint32_t logical_block_idx = 0; logical_block_idx < blocks_needed; logical_block_idx++) {
+        uint32_t bytes_to_write = node->i_size - (logical_block_idx * BLOCK_SIZE);
+        if (bytes_to_write > BLOCK_SIZE)
+            bytes_to_write = BLOCK_SIZE;
+
+        uint8_t *block_data = data + (logical_block_idx * BLOCK_SIZE);
+        if (is_zero_data(block_data, bytes_to_write))
+            continue;
+
+        // Blok terakhir dipad nol dulu supaya isi yang di-hash sama dengan isi di disk
+        uint8_t buffer[BLOCK_SIZE];
+        if (bytes_to_write < BLOCK_SIZE) {
+            memset(buffer, 0, BLOCK_SIZE);
+            memcpy(buffer, block_data, bytes_to_write);
+            block_data = buffer;
+        }
+
+        uint32_t physical_block = write_logical_block(node, logical_block_idx, block_data, preferred_bgd);
+        if (physical_block == 0) {
+            DEBUG_PRINT("Error: Gagal mengalokasi blok logis %u\n", logical_block_idx);
+            break;
+        }
+        node->i_blocks++;
+    }
+}
+
+/* =================== BATCHED FREE =================== */
+
+// Bitmap di-cache selama satu batch dealokasi lalu ditulis sekali di akhir,
+// bukan read-modify-write per blok
+static struct
+{
+  struct BlockBuffer block_bitmap[GROUPS_COUNT];
+  struct BlockBuffer inode_bitmap[GROUPS_COUNT];
+  uint32_t freed_blocks[GROUPS_COUNT];
+  uint32_t freed_inodes[GROUPS_COUNT];
+  uint32_t freed_dirs[GROUPS_COUNT];
+} free_batch;
+
+static void free_batch_begin(void)
+{
+  for (uint32_t g = 0; g < GROUPS_COUNT; g++)
+  {
+    read_blocks(&free_batch.block_bitmap[g], bgd_table.table[g].bg_block_bitmap, 1);
+    read_blocks(&free_batch.inode_bitmap[g], bgd_table.table[g].bg_inode_bitmap, 1);
+    free_batch.freed_blocks[g] = 0;
+    free_batch.freed_inodes[g] = 0;
+    free_batch.freed_dirs[g] = 0;
+  }
+}
+
+static void free_batch_block(uint32_t block)
+{
+  if (block == 0 || block >= BLOCKS_COUNT)
+    return;
+
+  // Blok masih dipakai inode lain (reflink), cukup kurangi refcount
+  if (!block_ref_put(block))
+    return;
+
+  uint32_t group = block / BLOCKS_PER_GROUP;
+  uint32_t local_block = block % BLOCKS_PER_GROUP;
+  uint8_t *byte = &free_batch.block_bitmap[group].buf[local_block / 8];
+  uint8_t mask = 1 << (local_block % 8);
+
+  if (*byte & mask)
+  {
+    *byte &= ~mask;
+    free_batch.freed_blocks[group]++;
+    dedup_forget(block);
+    free_extent_add(block, 1);
+  }
+}
+
+static void free_batch_map_block(uint32_t map_block, uint32_t level)
+{
+  if (map_block == 0 || map_block >= BLOCKS_COUNT)
+    return;
+
+  const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
+  uint32_t table[ptrs_per_block];
+  read_blocks(table, map_block, 1);
+
+  for (uint32_t i = 0; i < ptrs_per_block; i++)
+  {
+    if (level > 1)
+      free_batch_map_block(table[i], level - 1);
+    else
+      free_batch_block(table[i]);
+  }
+  free_batch_block(map_block);
+}
+
+static void free_batch_inode_blocks(struct EXT2Inode *inode)
+{
+  // Inline data: i_block berisi data, bukan nomor blok
+  if (inode->i_flags & EXT2_INLINE_DATA_FL)
+  {
+    memset(inode->i_block, 0, sizeof(inode->i_block));
+    inode->i_flags &= ~EXT2_INLINE_DATA_FL;
+    return;
+  }
+
+  // Semua direct pointer diperiksa, tidak bergantung pada i_blocks
+  for (uint32_t i = 0; i < 12; i++)
+    free_batch_block(inode->i_block[i]);
+
+  free_batch_map_block(inode->i_block[12], 1);
+  free_batch_map_block(inode->i_block[13], 2);
+  free_batch_map_block(inode->i_block[14], 3);
+
+  memset(inode->i_block, 0, sizeof(inode->i_block));
+  inode->i_blocks = 0;
+}
+
+static bool free_batch_inode_used(uint32_t inode)
+{
+  uint32_t local_inode = inode_to_local(inode);
+  return free_batch.inode_bitmap[inode_to_bgd(inode)].buf[local_inode / 8] & (1 << (local_inode % 8));
+}
+
+static void free_batch_inode(uint32_t inode, struct EXT2Inode *node)
+{
+  uint32_t group = inode_to_bgd(inode);
+  uint32_t local_inode = inode_to_local(inode);
+
+  if (is_directory(node))
+    free_batch.freed_dirs[group]++;
+  free_batch_inode_blocks(node);
+
+  free_batch.inode_bitmap[group].buf[local_inode / 8] &= ~(1 << (local_inode % 8));
+  free_batch.freed_inodes[group]++;
+  name_index_remove(inode);
+}
+
+/**
+ * @brief Tulis bitmap yang berubah dan update counter; superblock tetap
+ *        ditulis oleh pemanggil lewat sync_superblock()
+ */
+static void free_batch_commit(void)
+{
+  for (uint32_t g = 0; g < GROUPS_COUNT; g++)
+  {
+    if (free_batch.freed_blocks[g] != 0)
+      fs_write_blocks(&free_batch.block_bitmap[g], bgd_table.table[g].bg_block_bitmap, 1);
+    if (free_batch.freed_inodes[g] != 0)
+      fs_write_blocks(&free_batch.inode_bitmap[g], bgd_table.table[g].bg_inode_bitmap, 1);
+
+    bgd_table.table[g].bg_free_blocks_count += free_batch.freed_blocks[g];
+    bgd_table.table[g].bg_free_inodes_count += free_batch.freed_inodes[g];
+    bgd_table.table[g].bg_used_dirs_count -= free_batch.freed_dirs[g];
+    superblock.s_free_blocks_count += free_batch.freed_blocks[g];
+    superblock.s_free_inodes_count += free_batch.freed_inodes[g];
+  }
+}
+
+/**
+ * @brief Fungsi dealokasi blok dengan dukungan indirect blocks
+ */
+void deallocate_node_blocks_extended(struct EXT2Inode *inode)
+{
+    if (inode == NULL) return;
+
+    free_batch_begin();
+    free_batch_inode_blocks(inode);
+    free_batch_commit();
+}
+
+void allocate_node_blocks(void *ptr, struct EXT2Inode *node, uint32_t prefered_bgd)
+{
+  uint32_t blocks_needed = ceil_div(node->i_size, BLOCK_SIZE);
+  uint8_t *data = (uint8_t *)ptr;
+
+  // Batasi jumlah blok yang digunakan (hanya direct blocks)
+  uint32_t blocks_to_allocate = blocks_needed > 12 ? 12 : blocks_needed;
+  node->i_blocks = blocks_to_allocate;
+
+  for (uint32_t i = 0; i < blocks_to_allocate; i++)
+  {
+    node->i_block[i] = allocate_block(prefered_bgd);
+
+    // Tulis data ke blok ini
+    uint32_t bytes_to_write = node->i_size - (i * BLOCK_SIZE);
+    if (bytes_to_write > BLOCK_SIZE)
+      bytes_to_write = BLOCK_SIZE;
 
     uint8_t buffer[BLOCK_SIZE] = {0};
     memcpy(buffer, data + (i * BLOCK_SIZE), bytes_to_write);
-    write_blocks(buffer, node->i_block[i], 1);
+    fs_write_blocks(buffer, node->i_block[i], 1);
   }
 }
 
@@ -441,11 +1319,11 @@ int8_t write(struct EXT2DriverRequest request)
     return -1;
   }
 
-  // Validasi buffer
+  // Validasi buffer: buf == NULL dengan buffer_size > 0 membuat file sparse
+  // (seluruh isi berupa hole, tidak ada blok yang dialokasi)
   if (request.buffer_size > 0 && request.buf == NULL)
   {
-    DEBUG_PRINT("Error: Buffer is NULL but size is non-zero\n");
-    return -1;
+    DEBUG_PRINT("DEBUG: Buffer is NULL, creating sparse file of %u bytes\n", request.buffer_size);
   }
 
   // Perbesar batasan ukuran file karena sekarang mendukung indirect blocks
@@ -517,6 +1395,8 @@ int8_t write(struct EXT2DriverRequest request)
       new_node.i_blocks = 1;
       new_node.i_block[0] = allocate_block(inode_to_bgd(new_inode));
 
+      new_node.i_flags = parent_inode.i_flags & EXT2_COMPR_FL;
+
       // Inisialisasi entri direktori (. dan ..)
       init_directory_table(&new_node, new_inode, request.parent_inode);
   }
@@ -525,9 +1405,17 @@ int8_t write(struct EXT2DriverRequest request)
     // Buat file dengan dukungan indirect blocks
     new_node.i_mode = EXT2_S_IFREG;
     new_node.i_size = request.buffer_size;
+    new_node.i_flags = parent_inode.i_flags & EXT2_COMPR_FL; // kompresi diwarisi dari direktori
 
+    if (request.buffer_size > 0 && request.buffer_size <= EXT2_INLINE_DATA_MAX && request.buf != NULL)
+    {
+      // File kecil: simpan langsung di i_block, tanpa blok data
+      new_node.i_flags |= EXT2_INLINE_DATA_FL;
+      new_node.i_blocks = 0;
+      memcpy(new_node.i_block, request.buf, request.buffer_size);
+    }
     // GUNAKAN FUNGSI EXTENDED UNTUK ALOKASI BLOK DENGAN DUKUNGAN INDIRECT
-    if (request.buffer_size > 0 && request.buf != NULL)
+    else if (request.buffer_size > 0)
     {
       DEBUG_PRINT("DEBUG: Using extended allocation for file size: %u bytes\n", request.buffer_size);
       allocate_node_blocks_extended(request.buf, &new_node, inode_to_bgd(new_inode));
@@ -544,8 +1432,16 @@ int8_t write(struct EXT2DriverRequest request)
   // Tulis inode ke disk
   sync_node(&new_node, new_inode);
 
-  // Tambahkan entri ke direktori parent dengan nama yang sudah disalin
-  add_inode_to_dir(&parent_inode, new_inode, name_copy);
+  // Tambahkan entri ke direktori parent dengan nama yang sudah disalin. Blok direktori parent
+  // penuh: blok data & inode dilepas lagi, counter belum disentuh
+  if (!add_inode_to_dir(&parent_inode, new_inode, name_copy))
+  {
+    DEBUG_PRINT("Error: Parent directory full\n");
+    deallocate_node_blocks_extended(&new_node);
+    clear_inode_used(new_inode);
+    sync_superblock();
+    return 3;
+  }
 
   // Update counter
   uint32_t group = inode_to_bgd(new_inode);
@@ -564,122 +1460,610 @@ int8_t write(struct EXT2DriverRequest request)
   return 0;
 }
 
-int32_t allocate_block(uint32_t preferred_bgd)
-{
-  for (uint32_t i = 0; i < GROUPS_COUNT; i++)
-  {
-    uint32_t group = (preferred_bgd + i) % GROUPS_COUNT;
-    struct BlockBuffer buffer;
-    read_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
+// Next-fit: pencarian blok bebas dilanjutkan dari alokasi terakhir per group, sehingga
+// blok file yang ditulis berurutan bersebelahan di disk dan bitmap tidak dipindai dari awal
+static uint32_t block_alloc_goal[GROUPS_COUNT];
 
-    for (uint32_t j = 0; j < BLOCK_SIZE * 8; j++)
-    {
-      uint32_t byte_offset = j / 8;
-      uint32_t bit_offset = j % 8;
+/* =================== FREE EXTENT INDEX =================== */
 
-      if (!(buffer.buf[byte_offset] & (1 << bit_offset)))
-      {
-        buffer.buf[byte_offset] |= (1 << bit_offset);
-        write_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
-        return group * BLOCKS_PER_GROUP + j;
-      }
-    }
-  }
-  return -1;
-}
+// Run blok bebas di memori dalam dua AVL tree yang berbagi node: satu terurut berdasarkan
+// start (cari blok bebas dari goal, gabung tetangga saat free), satu berdasarkan
+// (length, start) untuk best-fit. Dibangun dari bitmap saat mount, diupdate setiap
+// alokasi / dealokasi blok. Run maksimal tidak pernah bersebelahan, jadi jumlahnya
+// paling banyak BLOCKS_COUNT / 2 + 1. Jika pool habis index dimatikan dan
+// allocate_block() kembali memindai bitmap
+#define FREE_EXTENT_BY_START 0
+#define FREE_EXTENT_BY_LENGTH 1
+#define FREE_EXTENT_NODE_MAX (BLOCKS_COUNT / 2 + 1)
+#define FREE_EXTENT_NONE 0xFFFFFFFF
 
-void sync_superblock(void)
+struct FreeExtent
 {
-  write_blocks(&superblock, 1, 1);
-  write_blocks(&bgd_table, 2, 1);
-}
+  uint32_t start;
+  uint32_t length;
+  uint32_t left[2]; // indeks node per tree, 0 = kosong
+  uint32_t right[2];
+  uint8_t height[2];
+};
+
+static struct
+{
+  struct FreeExtent node[FREE_EXTENT_NODE_MAX + 1]; // node[0] dipakai sebagai nil
+  uint32_t root[2];
+  uint32_t unused; // node yang belum dipakai, disambung lewat left[0]
+  uint32_t count;
+  uint32_t free_blocks;
+  bool valid;
+} free_extents;
+
+#define EXTENT(n) (free_extents.node[n])
+
+static bool free_extent_less(uint32_t tree, uint32_t a, uint32_t b)
+{
+  if (tree == FREE_EXTENT_BY_LENGTH && EXTENT(a).length != EXTENT(b).length)
+    return EXTENT(a).length < EXTENT(b).length;
+  return EXTENT(a).start < EXTENT(b).start;
+}
+
+static uint8_t free_extent_height(uint32_t tree, uint32_t n)
+{
+  return n == 0 ? 0 : EXTENT(n).height[tree];
+}
+
+static void free_extent_update(uint32_t tree, uint32_t n)
+{
+  uint8_t left = free_extent_height(tree, EXTENT(n).left[tree]);
+  uint8_t right = free_extent_height(tree, EXTENT(n).right[tree]);
+  EXTENT(n).height[tree] = 1 + (left > right ? left : right);
+}
+
+static uint32_t free_extent_rotate_right(uint32_t tree, uint32_t n)
+{
+  uint32_t l = EXTENT(n).left[tree];
+  EXTENT(n).left[tree] = EXTENT(l).right[tree];
+  EXTENT(l).right[tree] = n;
+  free_extent_update(tree, n);
+  free_extent_update(tree, l);
+  return l;
+}
+
+static uint32_t free_extent_rotate_left(uint32_t tree, uint32_t n)
+{
+  uint32_t r = EXTENT(n).right[tree];
+  EXTENT(n).right[tree] = EXTENT(r).left[tree];
+  EXTENT(r).left[tree] = n;
+  free_extent_update(tree, n);
+  free_extent_update(tree, r);
+  return r;
+}
+
+static uint32_t free_extent_balance(uint32_t tree, uint32_t n)
+{
+  free_extent_update(tree, n);
+  uint32_t l = EXTENT(n).left[tree];
+  uint32_t r = EXTENT(n).right[tree];
+  int32_t factor = (int32_t)free_extent_height(tree, l) - free_extent_height(tree, r);
+
+  if (factor > 1)
+  {
+    if (free_extent_height(tree, EXTENT(l).left[tree]) < free_extent_height(tree, EXTENT(l).right[tree]))
+      EXTENT(n).left[tree] = free_extent_rotate_left(tree, l);
+    return free_extent_rotate_right(tree, n);
+  }
+  if (factor < -1)
+  {
+    if (free_extent_height(tree, EXTENT(r).right[tree]) < free_extent_height(tree, EXTENT(r).left[tree]))
+      EXTENT(n).right[tree] = free_extent_rotate_right(tree, r);
+    return free_extent_rotate_left(tree, n);
+  }
+  return n;
+}
+
+static uint32_t free_extent_tree_insert(uint32_t tree, uint32_t root, uint32_t n)
+{
+  if (root == 0)
+    return n;
+  if (free_extent_less(tree, n, root))
+    EXTENT(root).left[tree] = free_extent_tree_insert(tree, EXTENT(root).left[tree], n);
+  else
+    EXTENT(root).right[tree] = free_extent_tree_insert(tree, EXTENT(root).right[tree], n);
+  return free_extent_balance(tree, root);
+}
+
+static uint32_t free_extent_tree_remove_min(uint32_t tree, uint32_t root, uint32_t *min)
+{
+  if (EXTENT(root).left[tree] == 0)
+  {
+    *min = root;
+    return EXTENT(root).right[tree];
+  }
+  EXTENT(root).left[tree] = free_extent_tree_remove_min(tree, EXTENT(root).left[tree], min);
+  return free_extent_balance(tree, root);
+}
+
+static uint32_t free_extent_tree_remove(uint32_t tree, uint32_t root, uint32_t n)
+{
+  if (root == 0)
+    return 0;
+  if (root == n)
+  {
+    uint32_t left = EXTENT(n).left[tree];
+    uint32_t right = EXTENT(n).right[tree];
+    if (right == 0)
+      return left;
+    uint32_t min;
+    right = free_extent_tree_remove_min(tree, right, &min);
+    EXTENT(min).left[tree] = left;
+    EXTENT(min).right[tree] = right;
+    return free_extent_balance(tree, min);
+  }
+  if (free_extent_less(tree, n, root))
+    EXTENT(root).left[tree] = free_extent_tree_remove(tree, EXTENT(root).left[tree], n);
+  else
+    EXTENT(root).right[tree] = free_extent_tree_remove(tree, EXTENT(root).right[tree], n);
+  return free_extent_balance(tree, root);
+}
+
+static void free_extent_attach(uint32_t n)
+{
+  for (uint32_t tree = 0; tree < 2; tree++)
+  {
+    EXTENT(n).left[tree] = EXTENT(n).right[tree] = 0;
+    EXTENT(n).height[tree] = 1;
+    free_extents.root[tree] = free_extent_tree_insert(tree, free_extents.root[tree], n);
+  }
+  free_extents.count++;
+}
+
+static void free_extent_detach(uint32_t n)
+{
+  for (uint32_t tree = 0; tree < 2; tree++)
+    free_extents.root[tree] = free_extent_tree_remove(tree, free_extents.root[tree], n);
+  free_extents.count--;
+}
+
+static uint32_t free_extent_new(uint32_t start, uint32_t length)
+{
+  uint32_t n = free_extents.unused;
+  if (n == 0)
+  {
+    free_extents.valid = false;
+    return 0;
+  }
+  free_extents.unused = EXTENT(n).left[0];
+  EXTENT(n).start = start;
+  EXTENT(n).length = length;
+  return n;
+}
+
+static void free_extent_release(uint32_t n)
+{
+  EXTENT(n).left[0] = free_extents.unused;
+  free_extents.unused = n;
+}
+
+/**
+ * @brief Run dengan start terbesar yang <= block, 0 jika tidak ada
+ */
+static uint32_t free_extent_floor(uint32_t block)
+{
+  uint32_t found = 0;
+  for (uint32_t n = free_extents.root[FREE_EXTENT_BY_START]; n != 0;)
+  {
+    if (EXTENT(n).start <= block)
+    {
+      found = n;
+      n = EXTENT(n).right[FREE_EXTENT_BY_START];
+    }
+    else
+    {
+      n = EXTENT(n).left[FREE_EXTENT_BY_START];
+    }
+  }
+  return found;
+}
+
+/**
+ * @brief Blok bebas pertama >= block, FREE_EXTENT_NONE jika tidak ada
+ */
+static uint32_t free_extent_first_from(uint32_t block)
+{
+  uint32_t next = FREE_EXTENT_NONE;
+  for (uint32_t n = free_extents.root[FREE_EXTENT_BY_START]; n != 0;)
+  {
+    if (EXTENT(n).start <= block)
+    {
+      if (block < EXTENT(n).start + EXTENT(n).length)
+        return block;
+      n = EXTENT(n).right[FREE_EXTENT_BY_START];
+    }
+    else
+    {
+      next = EXTENT(n).start;
+      n = EXTENT(n).left[FREE_EXTENT_BY_START];
+    }
+  }
+  return next;
+}
+
+/**
+ * @brief Best-fit: run terkecil dengan length >= count (start terkecil jika sama),
+ *        run terbesar jika tidak ada yang cukup, 0 jika tidak ada blok bebas
+ */
+static uint32_t free_extent_best_fit(uint32_t count)
+{
+  uint32_t found = 0, largest = 0;
+  for (uint32_t n = free_extents.root[FREE_EXTENT_BY_LENGTH]; n != 0;)
+  {
+    if (EXTENT(n).length >= count)
+    {
+      found = n;
+      n = EXTENT(n).left[FREE_EXTENT_BY_LENGTH];
+    }
+    else
+    {
+      n = EXTENT(n).right[FREE_EXTENT_BY_LENGTH];
+    }
+  }
+  if (found != 0)
+    return found;
+  for (uint32_t n = free_extents.root[FREE_EXTENT_BY_LENGTH]; n != 0; n = EXTENT(n).right[FREE_EXTENT_BY_LENGTH])
+    largest = n;
+  return largest;
+}
+
+static void free_extent_add(uint32_t start, uint32_t length)
+{
+  if (!free_extents.valid || length == 0)
+    return;
+
+  // Blok yang sudah bebas tidak boleh masuk dua kali
+  uint32_t left = free_extent_floor(start + length - 1);
+  if (left != 0 && EXTENT(left).start + EXTENT(left).length > start)
+    return;
+  free_extents.free_blocks += length;
+
+  // Gabung dengan run tepat di kiri / kanan
+  if (left != 0 && EXTENT(left).start + EXTENT(left).length == start)
+  {
+    free_extent_detach(left);
+    start = EXTENT(left).start;
+    length += EXTENT(left).length;
+    free_extent_release(left);
+  }
+  uint32_t right = free_extent_first_from(start + length) == start + length ? free_extent_floor(start + length) : 0;
+  if (right != 0)
+  {
+    free_extent_detach(right);
+    length += EXTENT(right).length;
+    free_extent_release(right);
+  }
+
+  uint32_t n = free_extent_new(start, length);
+  if (n != 0)
+    free_extent_attach(n);
+}
+
+static void free_extent_take(uint32_t block)
+{
+  if (!free_extents.valid)
+    return;
+  uint32_t n = free_extent_floor(block);
+  if (n == 0 || block >= EXTENT(n).start + EXTENT(n).length)
+    return;
+
+  // Run dipecah jadi bagian sebelum dan sesudah block
+  uint32_t start = EXTENT(n).start;
+  uint32_t end = start + EXTENT(n).length;
+  free_extent_detach(n);
+  free_extents.free_blocks--;
+
+  if (block > start)
+  {
+    EXTENT(n).length = block - start;
+    free_extent_attach(n);
+    n = 0;
+  }
+  if (block + 1 < end)
+  {
+    if (n == 0)
+      n = free_extent_new(block + 1, end - block - 1);
+    else
+    {
+      EXTENT(n).start = block + 1;
+      EXTENT(n).length = end - block - 1;
+    }
+    if (n != 0)
+      free_extent_attach(n);
+    n = 0;
+  }
+  if (n != 0)
+    free_extent_release(n);
+}
+
+/**
+ * @brief Bangun ulang index dari block bitmap semua group
+ */
+static void free_extent_rebuild(void)
+{
+  memset(free_extents.root, 0, sizeof(free_extents.root));
+  free_extents.unused = 0;
+  for (uint32_t n = FREE_EXTENT_NODE_MAX; n >= 1; n--)
+    free_extent_release(n);
+  free_extents.count = 0;
+  free_extents.free_blocks = 0;
+  free_extents.valid = true;
+
+  struct BlockBuffer bitmap;
+  for (uint32_t group = 0; group < GROUPS_COUNT; group++)
+  {
+    read_blocks(&bitmap, bgd_table.table[group].bg_block_bitmap, 1);
+    uint32_t run_start = 0, run_length = 0;
+    for (uint32_t j = 0; j < BLOCKS_PER_GROUP; j++)
+    {
+      if (!(bitmap.buf[j / 8] & (1 << (j % 8))))
+      {
+        if (run_length++ == 0)
+          run_start = group * BLOCKS_PER_GROUP + j;
+        continue;
+      }
+      free_extent_add(run_start, run_length);
+      run_length = 0;
+    }
+    free_extent_add(run_start, run_length);
+  }
+}
+
+uint32_t plan_contiguous_allocation(uint32_t block_count, uint32_t preferred_bgd)
+{
+  if (!free_extents.valid || block_count < 2)
+    return preferred_bgd;
+
+  uint32_t n = free_extent_best_fit(block_count);
+  if (n == 0)
+    return preferred_bgd;
+
+  // allocate_block() mulai dari goal, blok berikutnya mengikuti di run yang sama
+  uint32_t group = EXTENT(n).start / BLOCKS_PER_GROUP;
+  block_alloc_goal[group] = EXTENT(n).start % BLOCKS_PER_GROUP;
+  return group;
+}
+
+void get_space_info(struct EXT2SpaceInfo *info)
+{
+  memset(info, 0, sizeof(*info));
+  info->blocks_count = BLOCKS_COUNT;
+  info->inodes_count = EXT2_INODES_COUNT;
+  info->free_inodes = superblock.s_free_inodes_count;
+  info->free_blocks = superblock.s_free_blocks_count;
+  if (!free_extents.valid)
+    return;
+
+  info->free_blocks = free_extents.free_blocks;
+  info->free_extents = free_extents.count;
+  for (uint32_t n = free_extents.root[FREE_EXTENT_BY_LENGTH]; n != 0; n = EXTENT(n).right[FREE_EXTENT_BY_LENGTH])
+    info->largest_free_extent = EXTENT(n).length;
+}
+
+
+/**
+ * @brief Tandai blok terpakai di bitmap group-nya
+ */
+static int32_t claim_block(uint32_t group, uint32_t local_block, struct BlockBuffer *bitmap)
+{
+  bitmap->buf[local_block / 8] |= (1 << (local_block % 8));
+  fs_write_blocks(bitmap, bgd_table.table[group].bg_block_bitmap, 1);
+  bgd_table.table[group].bg_free_blocks_count--;
+  superblock.s_free_blocks_count--;
+  block_alloc_goal[group] = local_block + 1;
+  free_extent_take(group * BLOCKS_PER_GROUP + local_block);
+  return group * BLOCKS_PER_GROUP + local_block;
+}
+
+int32_t allocate_block(uint32_t preferred_bgd)
+{
+  for (uint32_t i = 0; i < GROUPS_COUNT && free_extents.valid; i++)
+  {
+    uint32_t group = (preferred_bgd + i) % GROUPS_COUNT;
+    if (bgd_table.table[group].bg_free_blocks_count == 0)
+      continue;
+
+    // Blok bebas pertama dari goal lewat index, wrap ke awal group
+    uint32_t group_start = group * BLOCKS_PER_GROUP;
+    uint32_t group_end = group_start + BLOCKS_PER_GROUP;
+    uint32_t block = free_extent_first_from(group_start + block_alloc_goal[group] % BLOCKS_PER_GROUP);
+    if (block >= group_end)
+      block = free_extent_first_from(group_start);
+    if (block >= group_end)
+      continue;
+
+    struct BlockBuffer buffer;
+    read_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
+    return claim_block(group, block - group_start, &buffer);
+  }
+  if (free_extents.valid)
+    return -1;
+
+  // Index tidak tersedia: pindai bitmap
+  for (uint32_t i = 0; i < GROUPS_COUNT; i++)
+  {
+    uint32_t group = (preferred_bgd + i) % GROUPS_COUNT;
+    if (bgd_table.table[group].bg_free_blocks_count == 0)
+      continue;
+
+    struct BlockBuffer buffer;
+    read_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
 
-void add_inode_to_dir(struct EXT2Inode *parent_inode, uint32_t inode, const char *name)
+    uint32_t goal = block_alloc_goal[group] % BLOCKS_PER_GROUP;
+    for (uint32_t scanned = 0; scanned < BLOCKS_PER_GROUP; scanned++)
+    {
+      uint32_t j = (goal + scanned) % BLOCKS_PER_GROUP;
+      uint32_t byte_offset = j / 8;
+      uint32_t bit_offset = j % 8;
+
+      // Byte penuh dilewati sekaligus
+      if (bit_offset == 0 && buffer.buf[byte_offset] == 0xFF && scanned + 8 <= BLOCKS_PER_GROUP)
+      {
+        scanned += 7;
+        continue;
+      }
+
+      if (!(buffer.buf[byte_offset] & (1 << bit_offset)))
+        return claim_block(group, j, &buffer);
+    }
+  }
+  return -1;
+}
+
+void sync_superblock(void)
+{
+  // Checksum dihitung ulang setiap kali metadata ditulis
+  for (uint32_t i = 0; i < GROUPS_COUNT; i++)
+    bgd_table.table[i].bg_checksum = group_desc_checksum(i, &bgd_table.table[i]);
+  superblock.s_checksum = superblock_checksum(&superblock);
+
+  // Struct lebih kecil dari satu blok, tulis lewat buffer penuh
+  struct BlockBuffer buffer;
+  memset(&buffer, 0, sizeof(buffer));
+  memcpy(buffer.buf, &superblock, sizeof(superblock));
+  fs_write_blocks(&buffer, 1, 1);
+
+  memset(&buffer, 0, sizeof(buffer));
+  memcpy(buffer.buf, &bgd_table, sizeof(bgd_table));
+  fs_write_blocks(&buffer, 2, 1);
+
+  if (superblock.s_refcount_table != 0)
+  {
+    // Blok tabel yang berurutan ditulis dalam satu panggilan
+    uint32_t i = 0;
+    while (i < EXT2_REFCOUNT_TABLE_BLOCKS)
+    {
+      if (!(block_refcount_dirty[i / 8] & (1 << (i % 8))))
+      {
+        i++;
+        continue;
+      }
+      uint32_t run = 0;
+      while (i + run < EXT2_REFCOUNT_TABLE_BLOCKS && run < 0xFF &&
+             (block_refcount_dirty[(i + run) / 8] & (1 << ((i + run) % 8))))
+        run++;
+      fs_write_blocks(block_refcount + i * BLOCK_SIZE, superblock.s_refcount_table + i, run);
+      i += run;
+    }
+  }
+  memset(block_refcount_dirty, 0, sizeof(block_refcount_dirty));
+}
+
+bool add_inode_to_dir(struct EXT2Inode *parent_inode, uint32_t inode, const char *name)
 {
   // Validasi input
   if (!parent_inode || !name || strlen(name) == 0 || strlen(name) > 255)
   {
     DEBUG_PRINT("Error: Invalid parameters to add_inode_to_dir\n");
-    return;
+    return false;
   }
 
   uint8_t buffer[BLOCK_SIZE];
-  read_blocks(buffer, parent_inode->i_block[0], 1);
+  read_dir_block(buffer, parent_inode->i_block[0]);
+
+  // Hitung ukuran entri baru dengan padding (4 bytes alignment)
+  uint8_t name_len = strlen(name);
+  uint16_t entry_size = get_entry_record_len(name_len);
 
-  // Cari tempat untuk entri baru
+  // Cari entri yang punya sisa ruang cukup (slack setelah nama, atau entri kosong).
+  // Checksum tail di akhir blok tidak boleh dipakai ulang
+  uint32_t dir_data_size = get_dir_data_size();
   uint32_t offset = 0;
-  struct EXT2DirectoryEntry *entry;
+  struct EXT2DirectoryEntry *new_entry = NULL;
 
-  while (offset < BLOCK_SIZE)
+  while (offset < dir_data_size)
   {
-    entry = (struct EXT2DirectoryEntry *)(buffer + offset);
+    struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(buffer + offset);
+    if (entry->rec_len == 0 || offset + entry->rec_len > dir_data_size)
+      break;
 
-    // Jika ini adalah entri terakhir atau kosong
-    if (entry->rec_len == 0 || offset + entry->rec_len >= BLOCK_SIZE)
+    if (entry->inode == 0 && entry->rec_len >= entry_size)
     {
+      // Pakai ulang entri yang sudah dihapus, rec_len dipertahankan
+      new_entry = entry;
       break;
     }
 
-    offset += entry->rec_len;
-  }
-
-  // Hitung ukuran entri baru dengan padding
-  uint8_t name_len = strlen(name);
-  uint16_t entry_size = sizeof(struct EXT2DirectoryEntry) + name_len;
+    uint16_t used = get_entry_record_len(entry->name_len);
+    if (entry->inode != 0 && entry->rec_len >= used + entry_size)
+    {
+      // Pecah entri: sisa ruang dipakai entri baru
+      new_entry = (struct EXT2DirectoryEntry *)(buffer + offset + used);
+      new_entry->rec_len = entry->rec_len - used;
+      entry->rec_len = used;
+      break;
+    }
 
-  // Alignment to 4 bytes
-  if (entry_size % 4 != 0)
-  {
-    entry_size += 4 - (entry_size % 4);
+    offset += entry->rec_len;
   }
 
-  // Pastikan ada ruang untuk entri baru
-  if (offset + entry_size > BLOCK_SIZE)
+  if (new_entry == NULL)
   {
     DEBUG_PRINT("Error: Not enough space in directory block\n");
-    return;
+    return false;
   }
 
-  // Buat entri baru
-  struct EXT2DirectoryEntry *new_entry = (struct EXT2DirectoryEntry *)(buffer + offset);
-  memset(new_entry, 0, entry_size); // Clear the entry first
+  // Tipe entri mengikuti mode inode
+  struct EXT2Inode node;
+  read_inode(inode, &node);
 
   new_entry->inode = inode;
-  new_entry->rec_len = BLOCK_SIZE - offset; // Takes rest of the block
   new_entry->name_len = name_len;
-  new_entry->file_type = EXT2_FT_REG_FILE; // Assume regular file
-
-  // Salin nama dengan aman
-  char *entry_name = (char *)(new_entry + 1);
-  memcpy(entry_name, name, name_len);
+  new_entry->file_type = is_directory(&node) ? EXT2_FT_DIR : EXT2_FT_REG_FILE;
+  memcpy(get_entry_name(new_entry), name, name_len);
 
   // Tulis kembali ke disk
-  write_blocks(buffer, parent_inode->i_block[0], 1);
+  write_dir_block(buffer, parent_inode->i_block[0]);
+
+  // Entri pertama blok directory selalu "." => nomor inode directory ini
+  name_index_add(get_directory_entry(buffer, 0)->inode, inode, name, name_len);
 
   DEBUG_PRINT("DEBUG: Added directory entry for '%s' with inode %u\n", name, inode);
+  return true;
 }
 
 bool is_empty_directory(struct EXT2Inode *inode)
 {
   uint8_t buf[BLOCK_SIZE];
-  read_blocks(buf, inode->i_block[0], 1);
-
-  uint32_t offset = get_dir_first_child_offset(buf);
-  struct EXT2DirectoryEntry *entry = get_directory_entry(buf, offset);
+  read_dir_block(buf, inode->i_block[0]);
 
-  return entry->inode == 0 || offset >= BLOCK_SIZE;
+  // Header entri dicek muat di blok sebelum dibaca: rec_len rusak tidak boleh membaca di luar buf
+  uint32_t dir_data_size = get_dir_data_size();
+  uint32_t offset = 0;
+  while (offset + sizeof(struct EXT2DirectoryEntry) <= dir_data_size)
+  {
+    struct EXT2DirectoryEntry *entry = get_directory_entry(buf, offset);
+    if (entry->rec_len == 0)
+      break;
+    if (entry->inode != 0 && offset + sizeof(struct EXT2DirectoryEntry) + entry->name_len <= dir_data_size)
+    {
+      char *entry_name = get_entry_name(entry);
+      bool is_dot = entry->name_len == 1 && entry_name[0] == '.';
+      bool is_dot_dot = entry->name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.';
+      if (!is_dot && !is_dot_dot)
+        return false;
+    }
+    offset += entry->rec_len;
+  }
+  return true;
 }
 
 void remove_inode_from_dir(struct EXT2Inode *dir_inode, const char *name)
 {
   uint8_t buf[BLOCK_SIZE];
-  read_blocks(buf, dir_inode->i_block[0], 1);
+  read_dir_block(buf, dir_inode->i_block[0]);
 
+  uint32_t dir_data_size = get_dir_data_size();
   uint32_t offset = 0;
   struct EXT2DirectoryEntry *prev_entry = NULL;
   struct EXT2DirectoryEntry *entry;
 
-  while (offset < BLOCK_SIZE)
+  while (offset < dir_data_size)
   {
     entry = get_directory_entry(buf, offset);
     if (entry->inode != 0)
@@ -688,6 +2072,15 @@ void remove_inode_from_dir(struct EXT2Inode *dir_inode, const char *name)
       if (strlen(name) == entry->name_len &&
           memcmp(entry_name, name, entry->name_len) == 0)
       {
+        // Hanya lepas dari index jika index memang menunjuk entri ini: move_file sudah
+        // menambah entri tujuan (inode yang sama) sebelum entri asal dihapus
+        if (entry->inode <= EXT2_INODES_COUNT)
+        {
+          struct EXT2NameIndexEntry *indexed = &name_index[entry->inode];
+          if (indexed->parent == get_directory_entry(buf, 0)->inode && indexed->name_len == entry->name_len &&
+              memcmp(indexed->name, entry_name, entry->name_len) == 0)
+            name_index_remove(entry->inode);
+        }
         if (prev_entry)
           prev_entry->rec_len += entry->rec_len;
         entry->inode = 0;
@@ -698,7 +2091,7 @@ void remove_inode_from_dir(struct EXT2Inode *dir_inode, const char *name)
     offset += entry->rec_len;
   }
 
-  write_blocks(buf, dir_inode->i_block[0], 1);
+  write_dir_block(buf, dir_inode->i_block[0]);
 }
 
 bool find_dir(uint32_t inode, uint32_t *out_inode_idx)
@@ -716,7 +2109,7 @@ bool find_dir(uint32_t inode, uint32_t *out_inode_idx)
 bool find_inode_in_dir(struct EXT2Inode *dir_inode, const char *name, uint32_t *out_inode)
 {
   uint8_t buf[BLOCK_SIZE];
-  read_blocks(buf, dir_inode->i_block[0], 1);
+  read_dir_block(buf, dir_inode->i_block[0]);
 
   uint32_t offset = 0;
   while (offset < BLOCK_SIZE)
@@ -773,11 +2166,19 @@ void read_inode(uint32_t inode, struct EXT2Inode *out_inode)
     return;
   }
 
-  struct EXT2InodeTable inode_table;
-  memset(&inode_table, 0, sizeof(inode_table)); // Clear the buffer first
+  // Cukup baca blok inode table yang memuat inode ini (maks. 2 blok jika melintasi batas)
+  uint32_t byte_offset = local_inode * INODE_SIZE;
+  uint32_t first_block = byte_offset / BLOCK_SIZE;
+  uint32_t last_block = (byte_offset + INODE_SIZE - 1) / BLOCK_SIZE;
+  uint8_t buf[2 * BLOCK_SIZE];
 
-  read_blocks(&inode_table, bgd_table.table[group].bg_inode_table, INODES_TABLE_BLOCK_COUNT);
-  *out_inode = inode_table.table[local_inode];
+  read_blocks(buf, bgd_table.table[group].bg_inode_table + first_block, last_block - first_block + 1);
+  memcpy(out_inode, buf + byte_offset % BLOCK_SIZE, INODE_SIZE);
+
+  // Slot inode yang belum pernah ditulis (i_mode 0) tidak punya checksum
+  if (metadata_csum_enabled() && out_inode->i_mode != 0 &&
+      out_inode->i_checksum != inode_checksum(inode, out_inode))
+    report_checksum_error("inode", inode);
 }
 
 void read_inode_data(struct EXT2Inode *inode, void *buf, uint32_t size)
@@ -788,6 +2189,11 @@ void read_inode_data(struct EXT2Inode *inode, void *buf, uint32_t size)
 
 void set_block_free(uint32_t block)
 {
+  // Blok masih dipakai inode lain (reflink), cukup kurangi refcount
+  if (!block_ref_put(block))
+    return;
+  dedup_forget(block);
+
   uint32_t group = block / superblock.s_blocks_per_group;
   uint32_t local_block = block % superblock.s_blocks_per_group;
   uint32_t byte_offset = local_block / 8;
@@ -796,7 +2202,8 @@ void set_block_free(uint32_t block)
   struct BlockBuffer buffer;
   read_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
   buffer.buf[byte_offset] &= ~(1 << bit_offset);
-  write_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
+  fs_write_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
+  free_extent_add(block, 1);
 }
 
 const uint8_t fs_signature[BLOCK_SIZE] = {
@@ -864,12 +2271,19 @@ void create_ext2(void)
   // Implementasi untuk membuat filesystem EXT2 baru
   // Inisialisasi superblock
   memset(&superblock, 0, sizeof(superblock));
+  memset(block_alloc_goal, 0, sizeof(block_alloc_goal));
+  dedup_reset();
+
+  // Format ulang: snapshot lama tidak berlaku lagi
+  snapshot.active = false;
+  if (EXT2_SNAPSHOT_SUPPORTED)
+    snapshot_write_header(false);
   superblock.s_magic = EXT2_SUPER_MAGIC;
 
   // Atur nilai penting lainnya
   superblock.s_inodes_count = INODES_PER_GROUP * GROUPS_COUNT;
   superblock.s_blocks_count = BLOCKS_PER_GROUP * GROUPS_COUNT;
-  superblock.s_free_blocks_count = superblock.s_blocks_count - 9; // Boot(0), super(1), BGD(2), block_bitmap(3), inode_bitmap(4), inode_table(5-8)
+  superblock.s_free_blocks_count = GROUPS_COUNT * (BLOCKS_PER_GROUP - EXT2_RESERVED_BLOCKS); // Boot, super, BGD, block_bitmap, inode_bitmap, inode_table, refcount table (ditandai di bitmap setiap group)
   superblock.s_free_inodes_count = superblock.s_inodes_count - 1; // Root inode will be allocated
   superblock.s_first_data_block = 0;
   superblock.s_log_block_size = 0; // 0 means 1024 byte blocks
@@ -881,7 +2295,7 @@ void create_ext2(void)
   superblock.s_wtime = 0;
   superblock.s_mnt_count = 0;
   superblock.s_max_mnt_count = 20;
-  superblock.s_state = 1;  // Clean
+  superblock.s_state = EXT2_VALID_FS;
   superblock.s_errors = 1; // Continue on errors
   superblock.s_minor_rev_level = 0;
   superblock.s_lastcheck = 0;
@@ -891,9 +2305,14 @@ void create_ext2(void)
   superblock.s_def_resuid = 0;
   superblock.s_def_resgid = 0;
   superblock.s_first_ino = 11; // First non-reserved inode
+  superblock.s_refcount_table = EXT2_REFCOUNT_TABLE_LOCATION;
+  superblock.s_refcount_blocks = EXT2_REFCOUNT_TABLE_BLOCKS;
+  superblock.s_feature_ro_compat = EXT2_FEATURE_RO_COMPAT_METADATA_CSUM;
 
-  // Tulis superblock
-  write_blocks(&superblock, 1, 1);
+  // Belum ada blok yang dibagi
+  memset(block_refcount, 0, sizeof(block_refcount));
+  fs_write_blocks(block_refcount, superblock.s_refcount_table, superblock.s_refcount_blocks);
+  memset(block_refcount_dirty, 0, sizeof(block_refcount_dirty));
 
   // Inisialisasi BGD table
   memset(&bgd_table, 0, sizeof(bgd_table));
@@ -902,20 +2321,20 @@ void create_ext2(void)
     bgd_table.table[i].bg_block_bitmap = 3 + i * (1 + 1 + INODES_TABLE_BLOCK_COUNT);
     bgd_table.table[i].bg_inode_bitmap = 4 + i * (1 + 1 + INODES_TABLE_BLOCK_COUNT);
     bgd_table.table[i].bg_inode_table = 5 + i * (1 + 1 + INODES_TABLE_BLOCK_COUNT);
-    bgd_table.table[i].bg_free_blocks_count = BLOCKS_PER_GROUP - 9; // Account for reserved blocks
+    bgd_table.table[i].bg_free_blocks_count = BLOCKS_PER_GROUP - EXT2_RESERVED_BLOCKS; // Account for reserved blocks
     bgd_table.table[i].bg_free_inodes_count = INODES_PER_GROUP;
   }
 
-  // Tulis BGD table
-  write_blocks(&bgd_table, 2, 1);
+  // Superblock & BGD table ditulis lewat sync_superblock()
+  sync_superblock();
 
   // Inisialisasi block dan inode bitmap
   uint8_t block_bitmap[BLOCK_SIZE] = {0};
   uint8_t inode_bitmap[BLOCK_SIZE] = {0};
 
-  // Mark reserved blocks as used (boot sector, superblock, BGD table, bitmaps, inode table)
-  // Blocks 0-8 are reserved for: boot(0), super(1), bgd(2), block_bitmap(3), inode_bitmap(4), inode_table(5-8)
-  for (uint32_t i = 0; i < 9; i++)
+  // Mark reserved blocks as used (boot sector, superblock, BGD table, bitmaps, inode table, refcount table)
+  // Blocks [0, EXT2_RESERVED_BLOCKS) are reserved for: boot(0), super(1), bgd(2), block_bitmap(3), inode_bitmap(4), inode_table, refcount table
+  for (uint32_t i = 0; i < EXT2_RESERVED_BLOCKS; i++)
   {
     uint32_t byte_offset = i / 8;
     uint32_t bit_offset = i % 8;
@@ -924,9 +2343,10 @@ void create_ext2(void)
 
   for (uint32_t i = 0; i < GROUPS_COUNT; i++)
   {
-    write_blocks(block_bitmap, bgd_table.table[i].bg_block_bitmap, 1);
-    write_blocks(inode_bitmap, bgd_table.table[i].bg_inode_bitmap, 1);
+    fs_write_blocks(block_bitmap, bgd_table.table[i].bg_block_bitmap, 1);
+    fs_write_blocks(inode_bitmap, bgd_table.table[i].bg_inode_bitmap, 1);
   }
+  free_extent_rebuild();
 
   // Buat root directory (inode 2)
   struct EXT2Inode root_inode = {0};
@@ -937,38 +2357,21 @@ void create_ext2(void)
   // Alokasi block untuk root directory
   root_inode.i_block[0] = allocate_block(0);
 
-  // Inisialisasi directory table untuk root
-  uint8_t dir_data[BLOCK_SIZE] = {0};
-  struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)dir_data;
-
-  // Entri "."
-  entry->inode = 2; // Root inode
-  entry->name_len = 1;
-  entry->file_type = EXT2_FT_DIR;
-  entry->rec_len = 12; // Size of entry + 1 byte name + padding
-  char *name = (char *)(entry + 1);
-  name[0] = '.';
-
-  // Entri ".."
-  entry = (struct EXT2DirectoryEntry *)(dir_data + entry->rec_len);
-  entry->inode = 2; // Parent is also root
-  entry->name_len = 2;
-  entry->file_type = EXT2_FT_DIR;
-  entry->rec_len = BLOCK_SIZE - 12; // Rest of the block
-  name = (char *)(entry + 1);
-  name[0] = '.';
-  name[1] = '.';
-
-  // Tulis directory data
-  write_blocks(dir_data, root_inode.i_block[0], 1);
+  // Inisialisasi directory table untuk root (parent root adalah dirinya sendiri)
+  init_directory_table(&root_inode, 2, 2);
 
-  // Tulis root inode
-  struct EXT2InodeTable inode_table = {0};
-  inode_table.table[1] = root_inode; // Inode 2 adalah index 1 dalam table
-  write_blocks(&inode_table, bgd_table.table[0].bg_inode_table, INODES_TABLE_BLOCK_COUNT);
+  // Inode table dikosongkan, root inode ditulis lewat sync_node() agar ber-checksum
+  // (per blok, inode table geometri besar bisa melebihi 255 blok / batas stack)
+  struct BlockBuffer zero_block = {0};
+  for (uint32_t i = 0; i < GROUPS_COUNT; i++)
+    for (uint32_t b = 0; b < INODES_TABLE_BLOCK_COUNT; b++)
+      fs_write_blocks(&zero_block, bgd_table.table[i].bg_inode_table + b, 1);
+  sync_node(&root_inode, 2);
 
   // Set bitmap untuk root inode dan blok yang digunakan
   set_inode_used(2);
+  bgd_table.table[0].bg_free_inodes_count--;
+  bgd_table.table[0].bg_used_dirs_count++;
 
   // Sync
   sync_superblock();
@@ -982,10 +2385,40 @@ void initialize_filesystem_ext2(void)
   }
   else
   {
-    // Baca superblock dan BGD table
-    read_blocks(&superblock, 1, 1);
-    read_blocks(&bgd_table, 2, 1);
+    // Baca superblock dan BGD table (struct lebih kecil dari satu blok)
+    struct BlockBuffer buffer;
+    read_blocks(&buffer, 1, 1);
+    memcpy(&superblock, buffer.buf, sizeof(superblock));
+    read_blocks(&buffer, 2, 1);
+    memcpy(&bgd_table, buffer.buf, sizeof(bgd_table));
+
+    if (metadata_csum_enabled())
+    {
+      if (superblock.s_checksum != superblock_checksum(&superblock))
+        report_checksum_error("superblock", 1);
+      for (uint32_t i = 0; i < GROUPS_COUNT; i++)
+      {
+        if (bgd_table.table[i].bg_checksum != group_desc_checksum(i, &bgd_table.table[i]))
+          report_checksum_error("group descriptor", i);
+      }
+    }
+
+    // Image lama tanpa refcount table: reflink dimatikan, cp kembali menyalin blok
+    memset(block_refcount, 0, sizeof(block_refcount));
+    if (superblock.s_refcount_table != 0 && superblock.s_refcount_blocks == EXT2_REFCOUNT_TABLE_BLOCKS)
+    {
+      read_blocks(block_refcount, superblock.s_refcount_table, superblock.s_refcount_blocks);
+    }
+    else
+    {
+      superblock.s_refcount_table = 0;
+    }
+    memset(block_refcount_dirty, 0, sizeof(block_refcount_dirty));
+    snapshot_load();
+    free_extent_rebuild();
   }
+  dedup_reset();
+  name_index_rebuild();
 }
 
 uint32_t allocate_node(void)
@@ -1003,7 +2436,7 @@ uint32_t allocate_node(void)
       if (!(buffer.buf[byte_offset] & (1 << bit_offset)))
       {
         buffer.buf[byte_offset] |= (1 << bit_offset);
-        write_blocks(&buffer, bgd_table.table[i].bg_inode_bitmap, 1);
+        fs_write_blocks(&buffer, bgd_table.table[i].bg_inode_bitmap, 1);
         return i * INODES_PER_GROUP + j + 1;
       }
     }
@@ -1016,12 +2449,16 @@ void sync_node(struct EXT2Inode *node, uint32_t inode)
   uint32_t group = inode_to_bgd(inode);
   uint32_t local_inode = inode_to_local(inode);
 
-  struct EXT2InodeTable inode_table;
-  read_blocks(&inode_table, bgd_table.table[group].bg_inode_table, INODES_TABLE_BLOCK_COUNT);
+  // Read-modify-write hanya blok yang memuat inode ini
+  uint32_t byte_offset = local_inode * INODE_SIZE;
+  uint32_t first_block = byte_offset / BLOCK_SIZE;
+  uint32_t block_count = (byte_offset + INODE_SIZE - 1) / BLOCK_SIZE - first_block + 1;
+  uint8_t buf[2 * BLOCK_SIZE];
 
-  inode_table.table[local_inode] = *node;
-
-  write_blocks(&inode_table, bgd_table.table[group].bg_inode_table, INODES_TABLE_BLOCK_COUNT);
+  node->i_checksum = inode_checksum(inode, node);
+  read_blocks(buf, bgd_table.table[group].bg_inode_table + first_block, block_count);
+  memcpy(buf + byte_offset % BLOCK_SIZE, node, INODE_SIZE);
+  fs_write_blocks(buf, bgd_table.table[group].bg_inode_table + first_block, block_count);
 }
 
 void deallocate_node(uint32_t inode)
@@ -1049,6 +2486,10 @@ void deallocate_node(uint32_t inode)
 void deallocate_block(uint32_t block_num)
 {
     if (block_num == 0) return; // Tidak ada yang perlu didealokasi
+
+    // Blok masih dipakai inode lain (reflink), cukup kurangi refcount
+    if (!block_ref_put(block_num)) return;
+    dedup_forget(block_num);
     
     // Tentukan block group dari nomor blok
     uint32_t group = (block_num - superblock.s_first_data_block) / superblock.s_blocks_per_group;
@@ -1066,7 +2507,8 @@ void deallocate_block(uint32_t block_num)
     buffer.buf[byte_offset] &= ~(1 << bit_offset);
     
     // Tulis kembali bitmap yang sudah diupdate
-    write_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
+    fs_write_blocks(&buffer, bgd_table.table[group].bg_block_bitmap, 1);
+    free_extent_add(block_num, 1);
     
     // Update counter blok bebas di block group descriptor
     bgd_table.table[group].bg_free_blocks_count++;
@@ -1083,28 +2525,10 @@ void deallocate_block(uint32_t block_num)
 void deallocate_indirect_block(uint32_t indirect_block, uint32_t level)
 {
     if (indirect_block == 0) return;
-    
-    const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
-    uint32_t indirect_table[ptrs_per_block];
-    
-    // Baca indirect table
-    read_blocks(indirect_table, indirect_block, 1);
-    
-    // Dealokasi semua blok yang direferensikan
-    for (uint32_t i = 0; i < ptrs_per_block; i++) {
-        if (indirect_table[i] != 0) {
-            if (level > 1) {
-                // Recursive dealokasi untuk double/triple indirect
-                deallocate_indirect_block(indirect_table[i], level - 1);
-            } else {
-                // Dealokasi blok data langsung
-                deallocate_block(indirect_table[i]);
-            }
-        }
-    }
-    
-    // Dealokasi indirect block itu sendiri
-    deallocate_block(indirect_block);
+
+    free_batch_begin();
+    free_batch_map_block(indirect_block, level);
+    free_batch_commit();
 }
 
 /**
@@ -1113,38 +2537,12 @@ void deallocate_indirect_block(uint32_t indirect_block, uint32_t level)
 void deallocate_inode_blocks(struct EXT2Inode *inode)
 {
     if (inode == NULL) return;
-    
-    uint32_t total_blocks = ceil_div(inode->i_size, BLOCK_SIZE);
-    const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
-    
-    // Dealokasi direct blocks (0-11)
-    for (uint32_t i = 0; i < 12 && i < total_blocks; i++) {
-        if (inode->i_block[i] != 0) {
-            deallocate_block(inode->i_block[i]);
-            inode->i_block[i] = 0;
-        }
-    }
-    
-    // Dealokasi single indirect block (12)
-    if (total_blocks > 12 && inode->i_block[12] != 0) {
-        deallocate_indirect_block(inode->i_block[12], 1);
-        inode->i_block[12] = 0;
-    }
-    
-    // Dealokasi double indirect block (13)
-    if (total_blocks > 12 + ptrs_per_block && inode->i_block[13] != 0) {
-        deallocate_indirect_block(inode->i_block[13], 2);
-        inode->i_block[13] = 0;
-    }
-    
-    // Dealokasi triple indirect block (14) - jika diperlukan
-    if (total_blocks > 12 + ptrs_per_block + (ptrs_per_block * ptrs_per_block) && inode->i_block[14] != 0) {
-        deallocate_indirect_block(inode->i_block[14], 3);
-        inode->i_block[14] = 0;
-    }
-    
-    // Reset block count
-    inode->i_blocks = 0;
+
+    // Satu batch: bitmap ditulis sekali untuk seluruh blok inode
+    free_batch_begin();
+    free_batch_inode_blocks(inode);
+    free_batch_commit();
+
     inode->i_size = 0;
     
     DEBUG_PRINT("Deallocated all blocks for inode\n");
@@ -1177,7 +2575,7 @@ void deallocate_logical_block_range(struct EXT2Inode *inode, uint32_t start_logi
                     uint32_t indirect_idx = logical_idx - 12;
                     indirect_table[indirect_idx] = 0;
                     
-                    write_blocks(indirect_table, inode->i_block[12], 1);
+                    fs_write_blocks(indirect_table, inode->i_block[12], 1);
                     
                     // Cek apakah semua entry dalam indirect table kosong
                     bool all_empty = true;
@@ -1239,6 +2637,200 @@ bool is_block_allocated(uint32_t block_num)
     return (buffer.buf[byte_offset] & (1 << bit_offset)) != 0;
 }
 
+int8_t write_at(struct EXT2DriverRequest request, uint32_t offset)
+{
+  uint32_t parent_inode_idx;
+  if (!find_dir(request.parent_inode, &parent_inode_idx))
+    return 3;
+
+  struct EXT2Inode parent_inode;
+  read_inode(parent_inode_idx, &parent_inode);
+
+  // name_len uint8_t, selalu muat di buffer 256
+  char name[256];
+  memcpy(name, request.name, request.name_len);
+  name[request.name_len] = '\0';
+
+  uint32_t inode_idx;
+  if (!find_inode_in_dir(&parent_inode, name, &inode_idx))
+    return 1;
+
+  return write_inode_at(inode_idx, request.buf, request.buffer_size, offset);
+}
+
+int8_t write_inode_at(uint32_t inode_idx, const void *buf, uint32_t size, uint32_t offset)
+{
+  struct EXT2Inode node;
+  read_inode(inode_idx, &node);
+  if (is_directory(&node))
+    return 2;
+
+  if (size == 0)
+    return 0;
+  if (buf == NULL)
+    return -1;
+
+  const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
+  const uint32_t max_file_size = (12 + ptrs_per_block + ptrs_per_block * ptrs_per_block) * BLOCK_SIZE;
+  if (offset > max_file_size || size > max_file_size - offset)
+    return -1;
+
+  const uint8_t *data = (const uint8_t *)buf;
+  uint32_t end = offset + size;
+  uint32_t new_size = end > node.i_size ? end : node.i_size;
+  uint32_t bgd = inode_to_bgd(inode_idx);
+
+  // Hasil akhir masih muat di i_block: tetap (atau jadi) inline data
+  if (new_size <= EXT2_INLINE_DATA_MAX && ((node.i_flags & EXT2_INLINE_DATA_FL) || node.i_size == 0))
+  {
+    uint8_t inline_data[EXT2_INLINE_DATA_MAX];
+    memset(inline_data, 0, sizeof(inline_data));
+    if (node.i_flags & EXT2_INLINE_DATA_FL)
+      memcpy(inline_data, node.i_block, sizeof(inline_data));
+    memcpy(inline_data + offset, data, size);
+
+    memcpy(node.i_block, inline_data, sizeof(inline_data));
+    node.i_flags |= EXT2_INLINE_DATA_FL;
+    node.i_size = new_size;
+    sync_node(&node, inode_idx);
+    return 0;
+  }
+
+  if ((node.i_flags & EXT2_INLINE_DATA_FL) && !uninline_data(&node, bgd))
+    return -1;
+
+  // File terkompresi: cluster yang tersentuh didekompresi, diubah, lalu dikompresi ulang
+  if (is_compressed_file(&node))
+  {
+    int8_t result = 0;
+    if (!write_compressed_range(&node, data, offset, size, new_size, bgd))
+      result = -1;
+    node.i_size = new_size;
+    sync_node(&node, inode_idx);
+    sync_superblock();
+    return result;
+  }
+
+  // Tulisan beberapa blok sekaligus dicarikan run bebas yang cukup (best-fit)
+  bgd = plan_contiguous_allocation(ceil_div(end, BLOCK_SIZE) - offset / BLOCK_SIZE, bgd);
+
+  // Hanya blok yang benar-benar ditulis yang dialokasi, seek melewati EOF
+  // meninggalkan hole. Data nol yang jatuh di hole tidak dialokasi sama sekali
+  int8_t result = 0;
+  uint32_t pos = offset;
+  while (pos < end)
+  {
+    uint32_t logical_block_idx = pos / BLOCK_SIZE;
+    uint32_t in_block = pos % BLOCK_SIZE;
+    uint32_t len = BLOCK_SIZE - in_block;
+    if (len > end - pos)
+      len = end - pos;
+    const uint8_t *chunk = data + (pos - offset);
+
+    uint32_t old_block = get_physical_block_from_logical(&node, logical_block_idx);
+    bool was_hole = old_block == 0;
+    if (was_hole && is_zero_data(chunk, len))
+    {
+      pos += len;
+      continue;
+    }
+
+    // Isi akhir blok disusun dulu (read-modify-write) supaya bisa dicocokkan untuk dedup
+    uint8_t block_buf[BLOCK_SIZE];
+    const uint8_t *block_data = chunk;
+    if (len < BLOCK_SIZE)
+    {
+      if (was_hole)
+        memset(block_buf, 0, BLOCK_SIZE);
+      else
+        read_blocks(block_buf, old_block, 1);
+      memcpy(block_buf + in_block, chunk, len);
+      block_data = block_buf;
+    }
+
+    if (write_logical_block(&node, logical_block_idx, block_data, bgd) == 0)
+    {
+      // Disk penuh: simpan apa yang sudah tertulis
+      new_size = pos > node.i_size ? pos : node.i_size;
+      result = -1;
+      break;
+    }
+
+    if (was_hole)
+      node.i_blocks++;
+    pos += len;
+  }
+
+  node.i_size = new_size;
+  sync_node(&node, inode_idx);
+  sync_superblock();
+  return result;
+}
+
+int8_t set_compression(struct EXT2DriverRequest request, bool enable)
+{
+  uint32_t parent_inode_idx;
+  if (!find_dir(request.parent_inode, &parent_inode_idx))
+    return 3;
+
+  struct EXT2Inode parent_inode;
+  read_inode(parent_inode_idx, &parent_inode);
+
+  char name[256];
+  memcpy(name, request.name, request.name_len);
+  name[request.name_len] = '\0';
+
+  uint32_t inode_idx;
+  if (!find_inode_in_dir(&parent_inode, name, &inode_idx))
+    return 1;
+
+  struct EXT2Inode node;
+  read_inode(inode_idx, &node);
+
+  uint32_t old_flags = node.i_flags;
+  uint32_t new_flags = enable ? (old_flags | EXT2_COMPR_FL) : (old_flags & ~EXT2_COMPR_FL);
+  if (new_flags == old_flags)
+    return 0;
+
+  // Direktori, inline data, dan file kosong tidak punya cluster untuk dikonversi
+  if (is_directory(&node) || (node.i_flags & EXT2_INLINE_DATA_FL) || node.i_size == 0)
+  {
+    node.i_flags = new_flags;
+    sync_node(&node, inode_idx);
+    return 0;
+  }
+
+  // Baca setiap cluster dengan format lama lalu tulis dengan format baru
+  int8_t result = 0;
+  uint32_t bgd = inode_to_bgd(inode_idx);
+  for (uint32_t offset = 0, cluster_idx = 0; offset < node.i_size; offset += EXT2_COMPR_CLUSTER_SIZE, cluster_idx++)
+  {
+    struct BlockMapCursor cursor;
+    cursor.table_block[0] = cursor.table_block[1] = 0;
+
+    node.i_flags = old_flags;
+    read_cluster(&node, cluster_idx, compr_data_buf, &cursor);
+
+    uint32_t len = node.i_size - offset;
+    if (len > EXT2_COMPR_CLUSTER_SIZE)
+      len = EXT2_COMPR_CLUSTER_SIZE;
+
+    node.i_flags = new_flags;
+    if (!write_cluster(&node, cluster_idx, compr_data_buf, len, bgd))
+    {
+      // Disk penuh saat dekompresi: campuran cluster mentah & terkompresi
+      // hanya terbaca benar sebagai file terkompresi
+      node.i_flags = old_flags | EXT2_COMPR_FL;
+      result = -1;
+      break;
+    }
+  }
+
+  sync_node(&node, inode_idx);
+  sync_superblock();
+  return result;
+}
+
 int8_t delete(struct EXT2DriverRequest request)
 {
   uint32_t inode_idx;
@@ -1248,14 +2840,25 @@ int8_t delete(struct EXT2DriverRequest request)
   struct EXT2Inode dir_inode;
   read_inode(inode_idx, &dir_inode);
 
+  // name_len uint8_t, selalu muat di buffer 256
+  char name[256];
+  memcpy(name, request.name, request.name_len);
+  name[request.name_len] = '\0';
+
+  if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+    return 2;
+
   uint32_t target_inode;
-  if (!find_inode_in_dir(&dir_inode, request.name, &target_inode))
+  if (!find_inode_in_dir(&dir_inode, name, &target_inode))
     return 1;
 
   struct EXT2Inode file_inode;
   read_inode(target_inode, &file_inode);
 
-  if (request.is_directory)
+  // Cek dari mode inode, bukan request.is_directory: direktori berisi yang terhapus
+  // lewat flag yang salah meninggalkan subtree yatim (inode & index tidak pernah bebas)
+  bool target_is_dir = is_directory(&file_inode);
+  if (request.is_directory || target_is_dir)
   {
     // Cek apakah direktori kosong
     if (!is_empty_directory(&file_inode))
@@ -1263,10 +2866,91 @@ int8_t delete(struct EXT2DriverRequest request)
   }
 
   // Hapus dari parent directory
-  remove_inode_from_dir(&dir_inode, request.name);
+  remove_inode_from_dir(&dir_inode, name);
 
-  // Dealokasi node
+  // Dealokasi node, deallocate_node hanya menambah counter free
   deallocate_node(target_inode);
+  if (target_is_dir)
+    bgd_table.table[inode_to_bgd(target_inode)].bg_used_dirs_count--;
+
+  sync_superblock();
+  return 0;
+}
+
+int8_t delete_recursive(struct EXT2DriverRequest request)
+{
+  uint32_t inode_idx;
+  if (!find_dir(request.parent_inode, &inode_idx))
+    return 3;
+
+  struct EXT2Inode dir_inode;
+  read_inode(inode_idx, &dir_inode);
+
+  // name_len uint8_t, selalu muat di buffer 256
+  char name[256];
+  memcpy(name, request.name, request.name_len);
+  name[request.name_len] = '\0';
+
+  if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+    return 2;
+
+  uint32_t target_inode;
+  if (!find_inode_in_dir(&dir_inode, name, &target_inode))
+    return 1;
+
+  // Lepas subtree dari parent dulu, sisanya tidak lagi terjangkau dari root
+  remove_inode_from_dir(&dir_inode, name);
+
+  // Telusuri subtree secara iteratif dengan stack eksplisit. Inode yang sudah
+  // dibebaskan di batch ini dilewati, sehingga entri ganda tidak di-free dua kali
+  static uint32_t stack[INODES_PER_GROUP * GROUPS_COUNT];
+  uint32_t top = 0;
+  stack[top++] = target_inode;
+
+  free_batch_begin();
+  while (top > 0)
+  {
+    uint32_t inode = stack[--top];
+    if (inode == 0 || inode > INODES_PER_GROUP * GROUPS_COUNT || !free_batch_inode_used(inode))
+      continue;
+
+    struct EXT2Inode node;
+    read_inode(inode, &node);
+
+    if (is_directory(&node))
+    {
+      uint8_t buf[BLOCK_SIZE];
+      for (uint32_t b = 0; b < 12; b++)
+      {
+        if (node.i_block[b] == 0)
+          continue;
+        read_dir_block(buf, node.i_block[b]);
+
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE)
+        {
+          struct EXT2DirectoryEntry *entry = get_directory_entry(buf, offset);
+          if (entry->rec_len == 0)
+            break;
+
+          char *entry_name = get_entry_name(entry);
+          bool is_dot = entry->name_len == 1 && entry_name[0] == '.';
+          bool is_dotdot = entry->name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.';
+          if (entry->inode != 0 && !is_dot && !is_dotdot)
+          {
+            if (top < sizeof(stack) / sizeof(stack[0]))
+              stack[top++] = entry->inode;
+            else
+              DEBUG_PRINT("Warning: delete stack full, inode %u leaked\n", entry->inode);
+          }
+          offset += entry->rec_len;
+        }
+      }
+    }
+
+    free_batch_inode(inode, &node);
+  }
+  free_batch_commit();
 
   sync_superblock();
   return 0;
@@ -1402,4 +3086,1176 @@ int8_t read(struct EXT2DriverRequest request)
   }
 
   return 0; // Success
-}
\ No newline at end of file
+}
+/* =================== SHARED BLOCKS (REFLINK) =================== */
+
+bool is_block_shared(uint32_t block)
+{
+  if (superblock.s_refcount_table == 0 || block == 0 || block >= BLOCKS_COUNT)
+    return false;
+  return block_refcount[block] != 0;
+}
+
+bool block_ref_get(uint32_t block)
+{
+  if (superblock.s_refcount_table == 0 || block == 0 || block >= BLOCKS_COUNT)
+    return false;
+  if (block_refcount[block] == EXT2_REFCOUNT_MAX)
+    return false;
+
+  block_refcount[block]++;
+  block_refcount_dirty[block / BLOCK_SIZE / 8] |= 1 << (block / BLOCK_SIZE % 8);
+  return true;
+}
+
+bool block_ref_put(uint32_t block)
+{
+  if (superblock.s_refcount_table == 0 || block >= BLOCKS_COUNT || block_refcount[block] == 0)
+    return true;
+
+  block_refcount[block]--;
+  block_refcount_dirty[block / BLOCK_SIZE / 8] |= 1 << (block / BLOCK_SIZE % 8);
+  return false;
+}
+
+/**
+ * @brief Blok data untuk salinan reflink: blok sumber dibagi, atau disalin jika
+ *        sudah dipegang EXT2_REFCOUNT_MAX pemilik (misal hasil dedup) agar cp tidak gagal total
+ * @return nomor blok untuk salinan, 0 jika disk penuh
+ */
+static uint32_t reflink_data_block(uint32_t src_block, uint32_t preferred_bgd)
+{
+  if (block_ref_get(src_block))
+    return src_block;
+
+  // Blok lain dengan isi sama yang belum penuh (index dedup) dipakai sebelum menyalin
+  struct BlockBuffer buffer;
+  read_blocks(&buffer, src_block, 1);
+  bool dedup = EXT2_DEDUP_ONLINE && dedup_enabled();
+  uint64_t hash = dedup ? xxh64(buffer.buf, BLOCK_SIZE, 0) : 0;
+  if (dedup)
+  {
+    uint32_t twin = dedup_lookup(buffer.buf, hash, src_block);
+    if (twin != 0 && block_ref_get(twin))
+      return twin;
+    dedup_forget(twin);
+  }
+
+  int32_t new_block = allocate_block(preferred_bgd);
+  if (new_block < 0)
+    return 0;
+  fs_write_blocks(&buffer, new_block, 1);
+  if (dedup)
+    dedup_insert(hash, new_block);
+  return new_block;
+}
+
+/**
+ * @brief Duplikasi satu blok peta (indirect table) untuk reflink.
+ *        Blok peta selalu milik satu inode, blok data di bawahnya dibagi.
+ * @param level 1 = single indirect, 2 = double indirect
+ */
+static bool reflink_map_block(uint32_t src_block, uint32_t *dst_block, uint32_t level, uint32_t preferred_bgd)
+{
+  const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
+  uint32_t src_table[ptrs_per_block];
+  uint32_t dst_table[ptrs_per_block];
+
+  int32_t new_block = allocate_block(preferred_bgd);
+  if (new_block < 0)
+    return false;
+  *dst_block = new_block;
+
+  read_blocks(src_table, src_block, 1);
+  memset(dst_table, 0, BLOCK_SIZE);
+
+  bool ok = true;
+  for (uint32_t i = 0; i < ptrs_per_block && ok; i++)
+  {
+    if (src_table[i] == 0)
+      continue;
+
+    if (level > 1)
+      ok = reflink_map_block(src_table[i], &dst_table[i], level - 1, preferred_bgd);
+    else
+      ok = (dst_table[i] = reflink_data_block(src_table[i], preferred_bgd)) != 0;
+  }
+
+  // Tetap ditulis walau gagal agar rollback bisa menelusuri tabel parsial
+  fs_write_blocks(dst_table, new_block, 1);
+  return ok;
+}
+
+bool reflink_inode_blocks(struct EXT2Inode *src, struct EXT2Inode *dst, uint32_t preferred_bgd)
+{
+  // Inline data langsung ikut tersalin bersama i_block
+  if (src->i_flags & EXT2_INLINE_DATA_FL)
+  {
+    memcpy(dst->i_block, src->i_block, sizeof(dst->i_block));
+    dst->i_flags |= EXT2_INLINE_DATA_FL;
+    dst->i_blocks = 0;
+    return true;
+  }
+
+  if (superblock.s_refcount_table == 0)
+    return false;
+
+  const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
+  uint32_t total_blocks = ceil_div(src->i_size, BLOCK_SIZE);
+
+  memset(dst->i_block, 0, sizeof(dst->i_block));
+  dst->i_blocks = src->i_blocks;
+
+  // Direct blocks: cukup salin pointer dan naikkan refcount
+  for (uint32_t i = 0; i < 12 && i < total_blocks; i++)
+  {
+    if (src->i_block[i] == 0)
+      continue;
+    dst->i_block[i] = reflink_data_block(src->i_block[i], preferred_bgd);
+    if (dst->i_block[i] == 0)
+      goto rollback;
+  }
+
+  // Indirect & double indirect: tabel peta diduplikasi (inode packed, pakai variabel lokal)
+  for (uint32_t level = 1; level <= 2; level++)
+  {
+    uint32_t first_logical = 12 + (level == 2 ? ptrs_per_block : 0);
+    uint32_t map_block = 0;
+    if (total_blocks <= first_logical || src->i_block[11 + level] == 0)
+      continue;
+
+    bool ok = reflink_map_block(src->i_block[11 + level], &map_block, level, preferred_bgd);
+    dst->i_block[11 + level] = map_block;
+    if (!ok)
+      goto rollback;
+  }
+
+  return true;
+
+rollback:
+  // Lepas semua referensi & blok peta yang sudah diambil
+  deallocate_node_blocks_extended(dst);
+  dst->i_blocks = 0;
+  return false;
+}
+
+uint32_t unshare_logical_block(struct EXT2Inode *inode, uint32_t logical_block_idx, uint32_t preferred_bgd)
+{
+  if (get_physical_block_from_logical(inode, logical_block_idx) == 0)
+    return 0;
+  // allocate_logical_block() melakukan copy-on-write jika blok masih dibagi
+  return allocate_logical_block(inode, logical_block_idx, preferred_bgd);
+}
+
+/* =================== DEDUPLICATION =================== */
+
+// Tabel hash isi blok data (xxHash64) -> nomor blok, hanya di memori: kosong saat mount,
+// diisi oleh setiap blok data yang ditulis dan oleh dedup_filesystem(). Open addressing
+// dengan probe terbatas, slot penuh menimpa slot asal. Entri bisa basi (blok ditimpa
+// in-place), jadi setiap kecocokan hash diverifikasi dengan membandingkan isi blok
+#define EXT2_DEDUP_TABLE_SIZE BLOCKS_COUNT
+#define EXT2_DEDUP_PROBE_MAX 8
+
+struct EXT2DedupEntry
+{
+  uint64_t hash;
+  uint32_t block; // 0 = slot kosong
+};
+
+static struct EXT2DedupEntry dedup_table[EXT2_DEDUP_TABLE_SIZE];
+static uint32_t dedup_slot_of_block[BLOCKS_COUNT]; // slot + 1, 0 = blok tidak ada di tabel
+
+static bool dedup_enabled(void)
+{
+  // Berbagi blok butuh refcount table, sama seperti reflink
+  return superblock.s_refcount_table != 0;
+}
+
+static uint32_t dedup_home_slot(uint64_t hash)
+{
+  return (uint32_t)(hash ^ (hash >> 32)) % EXT2_DEDUP_TABLE_SIZE;
+}
+
+static void dedup_reset(void)
+{
+  memset(dedup_table, 0, sizeof(dedup_table));
+  memset(dedup_slot_of_block, 0, sizeof(dedup_slot_of_block));
+}
+
+static void dedup_forget(uint32_t block)
+{
+  if (block == 0 || block >= BLOCKS_COUNT || dedup_slot_of_block[block] == 0)
+    return;
+  dedup_table[dedup_slot_of_block[block] - 1].block = 0;
+  dedup_slot_of_block[block] = 0;
+}
+
+static void dedup_insert(uint64_t hash, uint32_t block)
+{
+  if (block == 0 || block >= BLOCKS_COUNT)
+    return;
+  dedup_forget(block);
+
+  uint32_t home = dedup_home_slot(hash);
+  uint32_t slot = home;
+  for (uint32_t probe = 0; probe < EXT2_DEDUP_PROBE_MAX; probe++)
+  {
+    uint32_t candidate = (home + probe) % EXT2_DEDUP_TABLE_SIZE;
+    if (dedup_table[candidate].block == 0)
+    {
+      slot = candidate;
+      break;
+    }
+  }
+
+  dedup_forget(dedup_table[slot].block);
+  dedup_table[slot].hash = hash;
+  dedup_table[slot].block = block;
+  dedup_slot_of_block[block] = slot + 1;
+}
+
+/**
+ * @brief Cari blok lain yang isinya sama persis dengan data
+ * @param exclude blok yang tidak boleh dikembalikan (blok asal data itu sendiri), 0 jika tidak ada
+ * @return nomor blok, 0 jika tidak ditemukan
+ */
+static uint32_t dedup_lookup(const uint8_t *data, uint64_t hash, uint32_t exclude)
+{
+  uint32_t home = dedup_home_slot(hash);
+  for (uint32_t probe = 0; probe < EXT2_DEDUP_PROBE_MAX; probe++)
+  {
+    struct EXT2DedupEntry *entry = &dedup_table[(home + probe) % EXT2_DEDUP_TABLE_SIZE];
+    if (entry->block == 0 || entry->block == exclude || entry->hash != hash)
+      continue;
+
+    uint8_t candidate[BLOCK_SIZE];
+    read_blocks(candidate, entry->block, 1);
+    if (memcmp(candidate, data, BLOCK_SIZE) == 0)
+      return entry->block;
+  }
+  return 0;
+}
+
+/**
+ * @brief Gabungkan satu entri block map ke blok lain yang isinya sama
+ * @return true jika entri berubah dan tabel pemiliknya perlu ditulis ulang
+ */
+static bool dedup_merge_entry(uint32_t *entry, struct EXT2DedupStats *stats)
+{
+  if (*entry == 0 || *entry >= BLOCKS_COUNT)
+    return false;
+
+  uint8_t data[BLOCK_SIZE];
+  read_blocks(data, *entry, 1);
+  uint64_t hash = xxh64(data, BLOCK_SIZE, 0);
+  stats->blocks_scanned++;
+
+  uint32_t twin = dedup_lookup(data, hash, *entry);
+  if (twin == 0 || !block_ref_get(twin))
+  {
+    // Twin penuh (EXT2_REFCOUNT_MAX) digantikan blok ini di index
+    dedup_forget(twin);
+    dedup_insert(hash, *entry);
+    return false;
+  }
+
+  // Blok lama dilepas; benar-benar bebas jika inode ini pemilik terakhirnya
+  if (!is_block_shared(*entry))
+    stats->blocks_freed++;
+  deallocate_block(*entry);
+  *entry = twin;
+  stats->blocks_merged++;
+  return true;
+}
+
+static void dedup_merge_map_block(uint32_t map_block, uint32_t level, struct EXT2DedupStats *stats)
+{
+  if (map_block == 0 || map_block >= BLOCKS_COUNT)
+    return;
+
+  const uint32_t ptrs_per_block = BLOCK_SIZE / sizeof(uint32_t);
+  uint32_t table[ptrs_per_block];
+  read_blocks(table, map_block, 1);
+
+  bool changed = false;
+  for (uint32_t i = 0; i < ptrs_per_block; i++)
+  {
+    if (level > 1)
+      dedup_merge_map_block(table[i], level - 1, stats);
+    else if (dedup_merge_entry(&table[i], stats))
+      changed = true;
+  }
+  if (changed)
+    fs_write_blocks(table, map_block, 1);
+}
+
+int8_t dedup_filesystem(struct EXT2DedupStats *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  if (!dedup_enabled())
+    return -1;
+
+  // Index dibangun ulang dari isi disk, entri basi dari tulisan sebelumnya ikut dibuang
+  dedup_reset();
+  for (uint32_t inode_idx = 1; inode_idx <= EXT2_INODES_COUNT; inode_idx++)
+  {
+    if (!is_inode_used(inode_idx))
+      continue;
+
+    // Hanya blok data file biasa: blok direktori ditulis in-place tanpa copy-on-write
+    struct EXT2Inode node;
+    read_inode(inode_idx, &node);
+    if ((node.i_mode & 0xF000) != EXT2_S_IFREG || (node.i_flags & EXT2_INLINE_DATA_FL))
+      continue;
+
+    bool changed = false;
+    for (uint32_t i = 0; i < 12; i++)
+    {
+      uint32_t entry = node.i_block[i]; // inode packed, pakai variabel lokal
+      if (dedup_merge_entry(&entry, stats))
+      {
+        node.i_block[i] = entry;
+        changed = true;
+      }
+    }
+    dedup_merge_map_block(node.i_block[12], 1, stats);
+    dedup_merge_map_block(node.i_block[13], 2, stats);
+
+    if (changed)
+      sync_node(&node, inode_idx);
+  }
+
+  sync_superblock();
+  return 0;
+}
+
+/* =================== NAME INDEX =================== */
+
+static int32_t name_index_compare(const char *name, uint8_t name_len, uint32_t inode, uint32_t other)
+{
+  struct EXT2NameIndexEntry *entry = &name_index[other];
+  uint8_t common = name_len < entry->name_len ? name_len : entry->name_len;
+  int32_t diff = memcmp(name, entry->name, common);
+  if (diff != 0)
+    return diff;
+  if (name_len != entry->name_len)
+    return (int32_t)name_len - (int32_t)entry->name_len;
+  return inode < other ? -1 : (inode > other ? 1 : 0);
+}
+
+/**
+ * @brief Posisi pertama di name_index_order yang >= (name, inode)
+ */
+static uint32_t name_index_lower_bound(const char *name, uint8_t name_len, uint32_t inode)
+{
+  uint32_t low = 0, high = name_index_count;
+  while (low < high)
+  {
+    uint32_t mid = (low + high) / 2;
+    if (name_index_compare(name, name_len, inode, name_index_order[mid]) > 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+void name_index_remove(uint32_t inode)
+{
+  if (inode == 0 || inode > EXT2_INODES_COUNT || name_index[inode].parent == 0)
+    return;
+
+  struct EXT2NameIndexEntry *entry = &name_index[inode];
+  uint32_t pos = name_index_lower_bound(entry->name, entry->name_len, inode);
+  if (pos < name_index_count && name_index_order[pos] == inode)
+  {
+    memmove(&name_index_order[pos], &name_index_order[pos + 1], (name_index_count - pos - 1) * sizeof(uint32_t));
+    name_index_count--;
+  }
+  entry->parent = 0;
+}
+
+void name_index_add(uint32_t parent, uint32_t inode, const char *name, uint8_t name_len)
+{
+  if (inode == 0 || inode > EXT2_INODES_COUNT || parent == 0 || name_len == 0)
+    return;
+
+  name_index_remove(inode);
+  uint32_t pos = name_index_lower_bound(name, name_len, inode);
+  memmove(&name_index_order[pos + 1], &name_index_order[pos], (name_index_count - pos) * sizeof(uint32_t));
+  name_index_order[pos] = inode;
+  name_index_count++;
+
+  name_index[inode].parent = parent;
+  name_index[inode].name_len = name_len;
+  memcpy(name_index[inode].name, name, name_len);
+}
+
+/**
+ * @brief Bangun ulang index dari isi disk: satu pembacaan blok per direktori (BFS dari root)
+ */
+static void name_index_rebuild(void)
+{
+  memset(name_index, 0, sizeof(name_index));
+  name_index_count = 0;
+
+  static uint32_t queue[EXT2_INODES_COUNT];
+  uint32_t head = 0, tail = 0;
+  queue[tail++] = 2;
+
+  uint8_t buf[BLOCK_SIZE];
+  while (head < tail)
+  {
+    uint32_t dir = queue[head++];
+    struct EXT2Inode dir_inode;
+    read_inode(dir, &dir_inode);
+    if (!is_directory(&dir_inode) || dir_inode.i_block[0] == 0)
+      continue;
+    read_dir_block(buf, dir_inode.i_block[0]);
+
+    uint32_t dir_data_size = get_dir_data_size();
+    uint32_t offset = get_dir_first_child_offset(buf);
+    while (offset < dir_data_size)
+    {
+      struct EXT2DirectoryEntry *entry = get_directory_entry(buf, offset);
+      if (entry->rec_len == 0 || offset + entry->rec_len > dir_data_size)
+        break;
+      // "." dan ".." bukan child (".." root menunjuk root sendiri).
+      // Inode yang sudah terindeks (directory entry rusak / loop) tidak ditelusuri lagi
+      char *entry_name = get_entry_name(entry);
+      bool is_dot = entry->name_len == 1 && entry_name[0] == '.';
+      bool is_dotdot = entry->name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.';
+      if (entry->inode != 0 && entry->inode <= EXT2_INODES_COUNT && !is_dot && !is_dotdot &&
+          name_index[entry->inode].parent == 0)
+      {
+        name_index_add(dir, entry->inode, entry_name, entry->name_len);
+        if (entry->file_type == EXT2_FT_DIR && tail < EXT2_INODES_COUNT)
+          queue[tail++] = entry->inode;
+      }
+      offset += entry->rec_len;
+    }
+  }
+}
+
+/**
+ * @brief Tulis path absolut inode ke out dengan menelusuri parent di index
+ * @return panjang path (tanpa '\0'), 0 jika tidak muat
+ */
+static uint32_t name_index_build_path(uint32_t inode, char *out, uint32_t out_size)
+{
+  // Hitung panjang dulu, lalu isi dari belakang
+  uint32_t length = 0, depth = 0;
+  for (uint32_t walk = inode; walk != 2 && depth <= EXT2_INODES_COUNT; walk = name_index[walk].parent, depth++)
+  {
+    if (walk == 0 || walk > EXT2_INODES_COUNT || name_index[walk].parent == 0)
+      return 0;
+    length += 1 + name_index[walk].name_len;
+  }
+  if (depth > EXT2_INODES_COUNT || length + 1 > out_size)
+    return 0;
+
+  out[length] = '\0';
+  uint32_t pos = length;
+  for (uint32_t walk = inode; walk != 2; walk = name_index[walk].parent)
+  {
+    pos -= name_index[walk].name_len;
+    memcpy(out + pos, name_index[walk].name, name_index[walk].name_len);
+    out[--pos] = '/';
+  }
+  return length;
+}
+
+int8_t find_by_name(struct EXT2FindRequest *request)
+{
+  if (request == NULL || request->name_len == 0)
+    return -1;
+
+  request->match_count = 0;
+  request->path_count = 0;
+  uint32_t used = 0;
+  int8_t result = 0;
+
+  // Semua nama dengan prefix yang sama berurutan di name_index_order: O(log n + match)
+  uint32_t pos = name_index_lower_bound(request->name, request->name_len, 0);
+  for (; pos < name_index_count; pos++)
+  {
+    uint32_t inode = name_index_order[pos];
+    struct EXT2NameIndexEntry *entry = &name_index[inode];
+    if (entry->name_len < request->name_len || memcmp(entry->name, request->name, request->name_len) != 0)
+      break;
+    if (!request->prefix && entry->name_len != request->name_len)
+      break;
+
+    request->match_count++;
+    if (request->buf == NULL || result != 0)
+      continue;
+    uint32_t length = name_index_build_path(inode, request->buf + used, request->buffer_size - used);
+    if (length == 0)
+    {
+      result = 1; // buffer penuh, sisa match hanya dihitung
+      continue;
+    }
+    used += length + 1;
+    request->path_count++;
+  }
+  return result;
+}
+
+/* =================== FILE OPERATIONS (SYSCALL) =================== */
+
+int8_t copy_file(struct EXT2DriverRequest *src_request, struct EXT2DriverRequest *dst_request) {
+    // Validasi input parameter
+    if (!src_request || !dst_request) {
+        return -1; // Invalid parameters
+    }
+    
+    if (src_request->name_len == 0 || dst_request->name_len == 0) {
+        return -1; // Invalid file names
+    }
+    
+    // 1. Cari source file dalam parent directory
+    struct EXT2Inode parent_inode;
+    read_inode(src_request->parent_inode, &parent_inode);
+    
+    // Pastikan parent adalah directory
+    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
+        return -1; // Parent is not a directory
+    }
+    
+    uint8_t dir_block[BLOCK_SIZE];
+    uint32_t source_inode_idx = 0;
+    bool source_found = false;
+    
+    // Cari source file
+    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
+        if (parent_inode.i_block[block_idx] == 0) continue;
+        
+        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
+        
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE) {
+            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
+            
+            if (entry->inode == 0 || entry->rec_len == 0) break;
+            if (offset + entry->rec_len > BLOCK_SIZE) break;
+            
+            // Bandingkan nama dengan source
+            char *entry_name = (char *)(entry + 1);
+            if (entry->name_len == src_request->name_len) {
+                bool names_match = true;
+                for (uint8_t i = 0; i < entry->name_len; i++) {
+                    if (entry_name[i] != src_request->name[i]) {
+                        names_match = false;
+                        break;
+                    }
+                }
+                if (names_match) {
+                    source_inode_idx = entry->inode;
+                    source_found = true;
+                    
+                    // Pastikan source bukan directory
+                    if (entry->file_type == EXT2_FT_DIR) {
+                        return -3; // Cannot copy directory
+                    }
+                    break;
+                }
+            }
+            
+            offset += entry->rec_len;
+        }
+        
+        if (source_found) break;
+    }
+    
+    if (!source_found) {
+        return -1; // Source file not found
+    }
+    
+    // 2. Cek apakah destination file sudah ada
+    bool dest_exists = false;
+    
+    // Reset untuk pencarian destination
+    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
+        if (parent_inode.i_block[block_idx] == 0) continue;
+        
+        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
+        
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE) {
+            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
+            
+            if (entry->inode == 0 || entry->rec_len == 0) break;
+            if (offset + entry->rec_len > BLOCK_SIZE) break;
+            
+            // Bandingkan nama dengan destination
+            char *entry_name = (char *)(entry + 1);
+            if (entry->name_len == dst_request->name_len) {
+                bool names_match = true;
+                for (uint8_t i = 0; i < entry->name_len; i++) {
+                    if (entry_name[i] != dst_request->name[i]) {
+                        names_match = false;
+                        break;
+                    }
+                }
+                if (names_match) {
+                    dest_exists = true;
+                    break;
+                }
+            }
+            
+            offset += entry->rec_len;
+        }
+        
+        if (dest_exists) break;
+    }
+    
+    if (dest_exists) {
+        return -2; // Destination already exists
+    }
+    
+    // 3. Baca source file inode dan data
+    struct EXT2Inode source_inode;
+    read_inode(source_inode_idx, &source_inode);
+    
+    // Pastikan source adalah file reguler
+    if (source_inode.i_mode & EXT2_S_IFDIR) {
+        return -3; // Source is a directory
+    }
+    
+    // 4. Alokasi inode baru untuk destination
+    uint32_t new_inode_idx = allocate_node();
+    if (new_inode_idx == 0) {
+        return -4; // Failed to allocate inode
+    }
+    uint32_t bgd_idx = inode_to_bgd(new_inode_idx);
+    bgd_table.table[bgd_idx].bg_free_inodes_count--;
+    superblock.s_free_inodes_count--;
+    
+    // 5. Copy source inode properties ke destination inode
+    struct EXT2Inode dest_inode;
+    // Copy semua properties dari source
+    for (int i = 0; i < (int)sizeof(struct EXT2Inode); i++) {
+        ((uint8_t*)&dest_inode)[i] = ((uint8_t*)&source_inode)[i];
+    }
+    
+    // Reset block pointers untuk destination
+    for (int i = 0; i < 15; i++) {
+        dest_inode.i_block[i] = 0;
+    }
+    
+    // 6. Reflink: destination berbagi blok data dengan source (copy-on-write),
+    //    blok baru baru dibuat ketika salah satu file ditulis
+    dest_inode.i_blocks = 0;
+
+    if (!reflink_inode_blocks(&source_inode, &dest_inode, bgd_idx)) {
+        // Fallback: salin blok satu per satu (termasuk indirect blocks)
+        uint32_t blocks_to_copy = ceil_div(source_inode.i_size, BLOCK_SIZE);
+        uint8_t file_block[BLOCK_SIZE];
+
+        dest_inode.i_blocks = source_inode.i_blocks;
+        for (uint32_t i = 0; i < blocks_to_copy; i++) {
+            uint32_t src_block = get_physical_block_from_logical(&source_inode, i);
+            if (src_block == 0) continue;
+
+            read_blocks(file_block, src_block, 1);
+            if (write_logical_block(&dest_inode, i, file_block, bgd_idx) == 0) {
+                // Cleanup: dealokasi inode dan blocks yang sudah dialokasi
+                deallocate_node_blocks_extended(&dest_inode);
+                clear_inode_used(new_inode_idx);
+                bgd_table.table[bgd_idx].bg_free_inodes_count++;
+                superblock.s_free_inodes_count++;
+                return -5; // Failed to allocate blocks
+            }
+        }
+    }
+    
+    // 7. Sync destination inode ke disk
+    sync_node(&dest_inode, new_inode_idx);
+    
+    // 8. Tambahkan entry untuk destination file ke parent directory
+    char dst_name[256];
+    memcpy(dst_name, dst_request->name, dst_request->name_len);
+    dst_name[dst_request->name_len] = '\0';
+    if (!add_inode_to_dir(&parent_inode, new_inode_idx, dst_name)) {
+        // Cleanup jika gagal menambahkan entry
+        clear_inode_used(new_inode_idx);
+        bgd_table.table[bgd_idx].bg_free_inodes_count++;
+        superblock.s_free_inodes_count++;
+        deallocate_node_blocks_extended(&dest_inode);
+        sync_superblock();
+        return -8; // Parent directory full
+    }
+    
+    // 9. Sync parent directory dan superblock
+    sync_node(&parent_inode, src_request->parent_inode);
+    sync_superblock();
+    
+    return 0; // Success
+}
+int8_t create_directory(struct EXT2DriverRequest *request) {
+    // Validasi input parameter
+    if (!request || request->name_len == 0) {
+        return -1; // Invalid parameter
+    }
+    
+    // 1. Validasi parent directory exists dan valid
+    struct EXT2Inode parent_inode;
+    read_inode(request->parent_inode, &parent_inode);
+    
+    // Pastikan parent adalah directory
+    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
+        return -2; // Parent is not a directory
+    }
+    
+    // 2. Cek apakah file/directory dengan nama yang sama sudah ada
+    // Baca directory entries secara manual untuk pengecekan yang lebih akurat
+    uint8_t dir_block[BLOCK_SIZE];
+    bool name_exists = false;
+    
+    // Periksa setiap block dari parent directory
+    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
+        if (parent_inode.i_block[block_idx] == 0) continue;
+        
+        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
+        
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE) {
+            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
+            
+            if (entry->inode == 0 || entry->rec_len == 0) break;
+            if (offset + entry->rec_len > BLOCK_SIZE) break;
+            
+            // Bandingkan nama
+            char *entry_name = (char *)(entry + 1);
+            if (entry->name_len == request->name_len) {
+                bool names_match = true;
+                for (uint8_t i = 0; i < entry->name_len; i++) {
+                    if (entry_name[i] != request->name[i]) {
+                        names_match = false;
+                        break;
+                    }
+                }
+                if (names_match) {
+                    name_exists = true;
+                    break;
+                }
+            }
+            
+            offset += entry->rec_len;
+        }
+        
+        if (name_exists) break;
+    }
+    
+    if (name_exists) {
+        return -3; // Directory/file already exists
+    }
+    
+    // 3. Alokasi inode baru untuk directory
+    uint32_t new_inode_idx = allocate_node();
+    if (new_inode_idx == 0) {
+        return -4; // Failed to allocate inode
+    }
+    uint32_t bgd_idx = inode_to_bgd(new_inode_idx);
+    bgd_table.table[bgd_idx].bg_free_inodes_count--;
+    bgd_table.table[bgd_idx].bg_used_dirs_count++;
+    superblock.s_free_inodes_count--;
+    
+    // 4. Initialize inode untuk directory
+    struct EXT2Inode new_dir_inode;
+    // Clear semua field terlebih dahulu
+    for (int i = 0; i < (int)sizeof(struct EXT2Inode); i++) {
+        ((uint8_t*)&new_dir_inode)[i] = 0;
+    }
+
+    // Set directory properties
+    new_dir_inode.i_mode = EXT2_S_IFDIR; // Set sebagai directory
+    new_dir_inode.i_size = BLOCK_SIZE; // Ukuran minimal directory (1 block)
+    new_dir_inode.i_blocks = 1; // Menggunakan 1 block
+    
+    // 5. Alokasi block untuk directory entries
+    int32_t new_block = allocate_block(bgd_idx);
+    if (new_block < 0) {
+        // Gagal alokasi block, dealokasi inode
+        clear_inode_used(new_inode_idx);
+        bgd_table.table[bgd_idx].bg_free_inodes_count++;
+        bgd_table.table[bgd_idx].bg_used_dirs_count--;
+        superblock.s_free_inodes_count++;
+        return -5; // Failed to allocate block
+    }
+    
+    new_dir_inode.i_block[0] = new_block;
+    
+    // 6. Buat directory table dengan entries "." dan ".." lalu tulis ke disk
+    init_directory_table(&new_dir_inode, new_inode_idx, request->parent_inode);
+    
+    // 8. Sync inode baru ke disk
+    sync_node(&new_dir_inode, new_inode_idx);
+    
+    // 9. Tambahkan entry baru ke parent directory
+    char name[256];
+    memcpy(name, request->name, request->name_len);
+    name[request->name_len] = '\0';
+    if (!add_inode_to_dir(&parent_inode, new_inode_idx, name)) {
+        // Untuk sederhananya, return error jika parent directory penuh
+        // Dalam implementasi lengkap, kita harus alokasi block baru untuk parent
+        clear_inode_used(new_inode_idx);
+        bgd_table.table[bgd_idx].bg_free_inodes_count++;
+        bgd_table.table[bgd_idx].bg_used_dirs_count--;
+        superblock.s_free_inodes_count++;
+        deallocate_block(new_block);
+        sync_superblock();
+        return -6; // Parent directory full
+    }
+    
+    // 10. Sync parent directory inode ke disk (update i_size jika diperlukan)
+    sync_node(&parent_inode, request->parent_inode);
+    
+    // 11. Update superblock untuk mencerminkan penggunaan resource baru
+    sync_superblock();
+    
+    return 0; // Success
+}
+int8_t delete_file(struct EXT2DriverRequest *request) {
+    // Validasi input parameter
+    if (!request || request->name_len == 0) {
+        return -1; // Invalid parameter
+    }
+    
+    // 1. Validasi parent directory exists dan valid
+    struct EXT2Inode parent_inode;
+    read_inode(request->parent_inode, &parent_inode);
+    
+    // Pastikan parent adalah directory
+    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
+        return -2; // Parent is not a directory
+    }
+    
+    // 2. Cari file yang akan dihapus dalam parent directory
+    uint8_t dir_block[BLOCK_SIZE];
+    uint32_t target_inode_idx = 0;
+    bool file_found = false;
+    
+    // Periksa setiap block dari parent directory
+    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
+        if (parent_inode.i_block[block_idx] == 0) continue;
+        
+        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
+        
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE) {
+            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
+            
+            if (entry->inode == 0 || entry->rec_len == 0) break;
+            if (offset + entry->rec_len > BLOCK_SIZE) break;
+            
+            // Bandingkan nama
+            char *entry_name = (char *)(entry + 1);
+            if (entry->name_len == request->name_len) {
+                bool names_match = true;
+                for (uint8_t i = 0; i < entry->name_len; i++) {
+                    if (entry_name[i] != request->name[i]) {
+                        names_match = false;
+                        break;
+                    }
+                }
+                if (names_match) {
+                    // Pastikan ini adalah file, bukan directory
+                    if (entry->file_type == EXT2_FT_DIR) {
+                        return -6; // Target is a directory, not a file
+                    }
+                    
+                    target_inode_idx = entry->inode;
+                    file_found = true;
+                    break;
+                }
+            }
+            
+            offset += entry->rec_len;
+        }
+        
+        if (file_found) break;
+    }
+    
+    if (!file_found) {
+        return -3; // File not found
+    }
+    
+    // 3. Baca inode file yang akan dihapus
+    struct EXT2Inode file_inode;
+    read_inode(target_inode_idx, &file_inode);
+    
+    // 4. Dealokasi semua block yang digunakan oleh file (termasuk indirect blocks,
+    //    blok yang masih di-reflink file lain hanya dikurangi refcount-nya)
+    deallocate_node_blocks_extended(&file_inode);
+    
+    // 5. Dealokasi inode
+    clear_inode_used(target_inode_idx);
+    uint32_t group = inode_to_bgd(target_inode_idx);
+    bgd_table.table[group].bg_free_inodes_count++;
+    superblock.s_free_inodes_count++;
+    
+    // 6. Hapus entry dari parent directory (checksum tail ikut diperbarui)
+    char name[256];
+    memcpy(name, request->name, request->name_len);
+    name[request->name_len] = '\0';
+    remove_inode_from_dir(&parent_inode, name);
+    sync_superblock();
+    
+    return 0; // Success
+}
+
+int8_t delete_directory(struct EXT2DriverRequest *request) {
+    // Validasi input parameter
+    if (!request || request->name_len == 0) {
+        return -1; // Invalid parameter
+    }
+    
+    // 1. Validasi parent directory exists dan valid
+    struct EXT2Inode parent_inode;
+    read_inode(request->parent_inode, &parent_inode);
+    
+    // Pastikan parent adalah directory
+    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
+        return -2; // Parent is not a directory
+    }
+    
+    // 2. Cari directory yang akan dihapus dalam parent directory
+    uint8_t dir_block[BLOCK_SIZE];
+    uint32_t target_inode_idx = 0;
+    bool dir_found = false;
+    
+    // Periksa setiap block dari parent directory
+    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
+        if (parent_inode.i_block[block_idx] == 0) continue;
+        
+        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
+        
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE) {
+            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
+            
+            if (entry->inode == 0 || entry->rec_len == 0) break;
+            if (offset + entry->rec_len > BLOCK_SIZE) break;
+            
+            // Bandingkan nama
+            char *entry_name = (char *)(entry + 1);
+            if (entry->name_len == request->name_len) {
+                bool names_match = true;
+                for (uint8_t i = 0; i < entry->name_len; i++) {
+                    if (entry_name[i] != request->name[i]) {
+                        names_match = false;
+                        break;
+                    }
+                }
+                if (names_match) {
+                    // Pastikan ini adalah directory, bukan file
+                    if (entry->file_type != EXT2_FT_DIR) {
+                        return -6; // Target is a file, not a directory
+                    }
+                    
+                    target_inode_idx = entry->inode;
+                    dir_found = true;
+                    break;
+                }
+            }
+            
+            offset += entry->rec_len;
+        }
+        
+        if (dir_found) break;
+    }
+    
+    if (!dir_found) {
+        return -3; // Directory not found
+    }
+    
+    // 3. Baca inode directory yang akan dihapus
+    struct EXT2Inode target_dir_inode;
+    read_inode(target_inode_idx, &target_dir_inode);
+    
+    // 4. Pastikan directory kosong (hanya berisi "." dan "..")
+    uint8_t target_dir_block[BLOCK_SIZE];
+    bool is_empty = true;
+    
+    for (uint32_t block_idx = 0; block_idx < target_dir_inode.i_blocks && block_idx < 12; block_idx++) {
+        if (target_dir_inode.i_block[block_idx] == 0) continue;
+        
+        read_blocks(target_dir_block, target_dir_inode.i_block[block_idx], 1);
+        
+        uint32_t offset = 0;
+        while (offset < BLOCK_SIZE) {
+            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(target_dir_block + offset);
+            
+            if (entry->inode == 0 || entry->rec_len == 0) break;
+            if (offset + entry->rec_len > BLOCK_SIZE) break;
+            
+            // Skip "." dan ".." entries
+            char *entry_name = (char *)(entry + 1);
+            bool is_current_dir = (entry->name_len == 1 && entry_name[0] == '.');
+            bool is_parent_dir = (entry->name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.');
+            
+            if (!is_current_dir && !is_parent_dir) {
+                is_empty = false;
+                break;
+            }
+            
+            offset += entry->rec_len;
+        }
+        
+        if (!is_empty) break;
+    }
+    
+    if (!is_empty) {
+        return -7; // Directory is not empty
+    }
+    
+    // 5. Dealokasi semua block yang digunakan oleh directory
+    for (uint32_t i = 0; i < target_dir_inode.i_blocks && i < 12; i++) {
+        if (target_dir_inode.i_block[i] != 0) {
+            deallocate_block(target_dir_inode.i_block[i]);
+        }
+    }
+    
+    // 6. Dealokasi inode
+    clear_inode_used(target_inode_idx);
+    uint32_t group = inode_to_bgd(target_inode_idx);
+    bgd_table.table[group].bg_free_inodes_count++;
+    bgd_table.table[group].bg_used_dirs_count--;
+    superblock.s_free_inodes_count++;
+    
+    // 7. Hapus entry dari parent directory (sama seperti delete_file)
+    char name[256];
+    memcpy(name, request->name, request->name_len);
+    name[request->name_len] = '\0';
+    remove_inode_from_dir(&parent_inode, name);
+    sync_superblock();
+    
+    return 0; // Success
+}
+/**
+ * @brief Baca inode parent dari sebuah direktori lewat entri ".."
+ */
+static uint32_t get_parent_dir_inode(uint32_t dir_inode_num) {
+    struct EXT2Inode dir_inode;
+    read_inode(dir_inode_num, &dir_inode);
+
+    uint32_t parent = 0;
+    if (!find_inode_in_dir(&dir_inode, "..", &parent)) {
+        return 0;
+    }
+    return parent;
+}
+
+/**
+ * @brief Arahkan entri ".." sebuah direktori ke parent baru
+ */
+static void set_parent_dir_inode(struct EXT2Inode *dir_inode, uint32_t new_parent) {
+    uint8_t dir_block[BLOCK_SIZE];
+    read_dir_block(dir_block, dir_inode->i_block[0]);
+
+    uint32_t offset = 0;
+    while (offset < BLOCK_SIZE) {
+        struct EXT2DirectoryEntry *entry = get_directory_entry(dir_block, offset);
+        if (entry->rec_len == 0) break;
+
+        char *entry_name = get_entry_name(entry);
+        if (entry->inode != 0 && entry->name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.') {
+            entry->inode = new_parent;
+            write_dir_block(dir_block, dir_inode->i_block[0]);
+            return;
+        }
+        offset += entry->rec_len;
+    }
+}
+
+int8_t move_file(struct EXT2DriverRequest *src_request, struct EXT2DriverRequest *dst_request) {
+    // Validasi input
+    if (!src_request || !dst_request) {
+        return -1; // Invalid parameters
+    }
+    
+    // Validasi nama file
+    if (src_request->name_len == 0 || dst_request->name_len == 0) {
+        return -1; // Invalid parameters
+    }
+    
+    // 1. Baca parent source dan parent destination (boleh berbeda)
+    struct EXT2Inode src_parent_inode;
+    struct EXT2Inode dst_parent_inode;
+    read_inode(src_request->parent_inode, &src_parent_inode);
+    read_inode(dst_request->parent_inode, &dst_parent_inode);
+    
+    // Verifikasi keduanya adalah directory
+    if (!is_directory(&src_parent_inode) || !is_directory(&dst_parent_inode)) {
+        return -1; // Parent is not a directory
+    }
+    
+    // Buat salinan nama source yang aman
+    char src_name[256];
+    size_t src_name_len = src_request->name_len;
+    if (src_name_len >= sizeof(src_name)) {
+        src_name_len = sizeof(src_name) - 1;
+    }
+    memcpy(src_name, src_request->name, src_name_len);
+    src_name[src_name_len] = '\0';
+
+    if (strcmp(src_name, ".") == 0 || strcmp(src_name, "..") == 0) {
+        return -1; // Tidak boleh memindahkan . atau ..
+    }
+    
+    // Cari inode source
+    uint32_t src_inode_num = 0;
+    if (!find_inode_in_dir(&src_parent_inode, src_name, &src_inode_num)) {
+        return -2; // Source file not found
+    }
+    
+    // 2. Cek apakah destination sudah ada
+    char dst_name[256];
+    size_t dst_name_len = dst_request->name_len;
+    if (dst_name_len >= sizeof(dst_name)) {
+        dst_name_len = sizeof(dst_name) - 1;
+    }
+    memcpy(dst_name, dst_request->name, dst_name_len);
+    dst_name[dst_name_len] = '\0';
+    
+    uint32_t dst_inode_num = 0;
+    if (find_inode_in_dir(&dst_parent_inode, dst_name, &dst_inode_num)) {
+        return -3; // Destination already exists
+    }
+    
+    // 3. Baca source inode untuk validasi
+    struct EXT2Inode src_inode;
+    read_inode(src_inode_num, &src_inode);
+    bool moving_dir = is_directory(&src_inode);
+    bool same_parent = src_request->parent_inode == dst_request->parent_inode;
+    
+    // Directory tidak boleh dipindah ke dalam dirinya sendiri / subtree-nya:
+    // telusuri ".." dari parent tujuan sampai root
+    if (moving_dir && !same_parent) {
+        uint32_t walk = dst_request->parent_inode;
+        for (uint32_t depth = 0; depth < INODES_PER_GROUP * GROUPS_COUNT; depth++) {
+            if (walk == src_inode_num) {
+                return -4; // Destination inside source directory
+            }
+            uint32_t parent = get_parent_dir_inode(walk);
+            if (parent == 0 || parent == walk) break; // Root
+            walk = parent;
+        }
+    }
+    
+    // 4. RENAME/MOVE: hanya relink directory entry, data tidak disentuh.
+    // Entry baru ditambah dulu agar kegagalan tidak menghilangkan source
+    if (!add_inode_to_dir(&dst_parent_inode, src_inode_num, dst_name)) {
+        return -6; // Destination directory full
+    }
+    
+    remove_inode_from_dir(&src_parent_inode, src_name);
+    
+    // Directory pindah parent: perbaiki ".."
+    if (moving_dir && !same_parent) {
+        set_parent_dir_inode(&src_inode, dst_request->parent_inode);
+    }
+    
+    return 0; // Success
+}
@@ -0,0 +1,347 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <getopt.h>
+
+#include "header/filesystem/ext2.h"
+#include "header/driver/disk.h"
+#include "header/stdlib/string.h"
+
+/**
+ * bench-fs - micro-benchmark driver EXT2 di host, tanpa QEMU
+ *
+ * ext2.c dijalankan di atas block device RAM yang menghitung setiap pemanggilan
+ * read_blocks / write_blocks. Setiap kombinasi (jumlah file, ukuran file)
+ * diformat ulang lalu menjalankan workload berurutan:
+ *
+ *   create  write() file baru          lookup  find_inode_in_dir()
+ *   read    read() seluruh isi         append  write_at() di akhir file
+ *   readdir read_directory() per dir   copy    copy_file() (reflink)
+ *   move    move_file() ke dir lain    delete  delete() original & salinan
+ *
+ * Output CSV: ops/detik (waktu terbaik dari -r pengulangan) dan jumlah blok
+ * yang dibaca / ditulis per operasi. Angka I/O deterministik, sehingga regresi
+ * allocator atau kode directory terlihat langsung di kolom blok per op.
+ */
+
+#define BENCH_FILES_PER_DIR 12  // satu blok directory, sisakan ruang untuk salinan
+#define BENCH_DIRS_PER_GROUP 8  // pasangan dK/eK per directory grup gK di root
+#define BENCH_APPEND_SIZE   512
+#define BENCH_MAX_FILE_SIZE 16384
+
+struct RamDisk
+{
+    uint8_t *storage;
+    uint64_t read_calls;
+    uint64_t write_calls;
+    uint64_t blocks_read;
+    uint64_t blocks_written;
+};
+
+static struct RamDisk ram_disk;
+
+void read_blocks(void *ptr, uint32_t logical_block_address, uint8_t block_count)
+{
+    ram_disk.read_calls++;
+    ram_disk.blocks_read += block_count;
+    memcpy(ptr, ram_disk.storage + (size_t)BLOCK_SIZE * logical_block_address, (size_t)BLOCK_SIZE * block_count);
+}
+
+void write_blocks(const void *ptr, uint32_t logical_block_address, uint8_t block_count)
+{
+    ram_disk.write_calls++;
+    ram_disk.blocks_written += block_count;
+    memcpy(ram_disk.storage + (size_t)BLOCK_SIZE * logical_block_address, ptr, (size_t)BLOCK_SIZE * block_count);
+}
+
+enum Workload
+{
+    WL_CREATE,
+    WL_LOOKUP,
+    WL_READ,
+    WL_APPEND,
+    WL_READDIR,
+    WL_COPY,
+    WL_MOVE,
+    WL_DELETE,
+    WL_COUNT
+};
+
+static const char *workload_names[WL_COUNT] = {
+    "create", "lookup", "read", "append", "readdir", "copy", "move", "delete"};
+
+struct WorkloadResult
+{
+    uint32_t ops;
+    uint32_t failures;
+    uint64_t best_ns;
+    uint64_t blocks_read;
+    uint64_t blocks_written;
+};
+
+struct BenchConfig
+{
+    uint32_t files;
+    uint32_t file_size;
+};
+
+static uint8_t data_buf[BENCH_MAX_FILE_SIZE + BENCH_APPEND_SIZE];
+static uint8_t read_buf[BENCH_MAX_FILE_SIZE + BENCH_APPEND_SIZE];
+static uint32_t dir_inodes[2][1024]; // [0] = dK (asal), [1] = eK (tujuan move)
+static uint32_t dir_parents[1024];    // gK yang memuat dK dan eK
+static uint32_t dir_count;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void make_request(struct EXT2DriverRequest *request, uint32_t parent, const char *name)
+{
+    memset(request, 0, sizeof(*request));
+    request->name_len = (uint8_t)snprintf(request->name, sizeof(request->name), "%s", name);
+    request->parent_inode = parent;
+}
+
+static void file_name(char *out, size_t size, char prefix, uint32_t index)
+{
+    snprintf(out, size, "%c%04u", prefix, index);
+}
+
+static uint32_t lookup(uint32_t parent, const char *name)
+{
+    struct EXT2Inode dir;
+    uint32_t inode = 0;
+    read_inode(parent, &dir);
+    if (!find_inode_in_dir(&dir, name, &inode))
+        return 0;
+    return inode;
+}
+
+/**
+ * @brief Satu operasi workload untuk file ke-index
+ * @return true jika operasi berhasil
+ */
+static bool run_op(enum Workload workload, const struct BenchConfig *config, uint32_t index)
+{
+    struct EXT2DriverRequest request, other;
+    char name[16], copy_name[16];
+    uint32_t dir = dir_inodes[0][index / BENCH_FILES_PER_DIR];
+    uint32_t twin = dir_inodes[1][index / BENCH_FILES_PER_DIR];
+    file_name(name, sizeof(name), 'f', index);
+    file_name(copy_name, sizeof(copy_name), 'c', index);
+
+    switch (workload)
+    {
+    case WL_CREATE:
+        make_request(&request, dir, name);
+        request.buf = data_buf;
+        request.buffer_size = config->file_size;
+        return write(request) == 0;
+    case WL_LOOKUP:
+        return lookup(dir, name) != 0;
+    case WL_READ:
+        make_request(&request, dir, name);
+        request.buf = read_buf;
+        request.buffer_size = sizeof(read_buf);
+        return read(request) == 0;
+    case WL_APPEND:
+        make_request(&request, dir, name);
+        request.buf = data_buf;
+        request.buffer_size = BENCH_APPEND_SIZE;
+        return write_at(request, config->file_size) == 0;
+    case WL_READDIR:
+    {
+        // index di sini adalah nomor directory; read_directory membaca lewat parent gK
+        char dir_name[16];
+        file_name(dir_name, sizeof(dir_name), 'd', index);
+        make_request(&request, dir_parents[index], dir_name);
+        request.buf = read_buf;
+        request.buffer_size = sizeof(read_buf);
+        return read_directory(&request) == 0;
+    }
+    case WL_COPY:
+        make_request(&request, dir, name);
+        make_request(&other, dir, copy_name);
+        return copy_file(&request, &other) == 0;
+    case WL_MOVE:
+        make_request(&request, dir, copy_name);
+        make_request(&other, twin, copy_name);
+        return move_file(&request, &other) == 0;
+    case WL_DELETE:
+    {
+        make_request(&request, dir, name);
+        bool ok = delete(request) == 0;
+        make_request(&request, twin, copy_name);
+        return delete(request) == 0 && ok;
+    }
+    default:
+        return false;
+    }
+}
+
+static void setup_filesystem(const struct BenchConfig *config)
+{
+    memset(ram_disk.storage, 0, (size_t)BLOCKS_COUNT * BLOCK_SIZE);
+    initialize_filesystem_ext2();
+
+    dir_count = (config->files + BENCH_FILES_PER_DIR - 1) / BENCH_FILES_PER_DIR;
+    for (uint32_t i = 0; i < dir_count; i++)
+    {
+        struct EXT2DriverRequest request;
+        char name[16];
+        if (i % BENCH_DIRS_PER_GROUP == 0)
+        {
+            file_name(name, sizeof(name), 'g', i / BENCH_DIRS_PER_GROUP);
+            make_request(&request, 2, name);
+            request.is_directory = 1;
+            write(request);
+        }
+        file_name(name, sizeof(name), 'g', i / BENCH_DIRS_PER_GROUP);
+        dir_parents[i] = lookup(2, name);
+
+        for (uint32_t side = 0; side < 2; side++)
+        {
+            file_name(name, sizeof(name), side ? 'e' : 'd', i);
+            make_request(&request, dir_parents[i], name);
+            request.is_directory = 1;
+            write(request);
+            dir_inodes[side][i] = lookup(dir_parents[i], name);
+        }
+    }
+}
+
+static void run_config(const struct BenchConfig *config, uint32_t repeats, struct WorkloadResult *results)
+{
+    memset(results, 0, sizeof(struct WorkloadResult) * WL_COUNT);
+    for (uint32_t r = 0; r < repeats; r++)
+    {
+        setup_filesystem(config);
+        for (uint32_t w = 0; w < WL_COUNT; w++)
+        {
+            uint32_t ops = w == WL_READDIR ? dir_count : config->files;
+            uint32_t failures = 0;
+            uint64_t reads_before = ram_disk.blocks_read, writes_before = ram_disk.blocks_written;
+            uint64_t start = now_ns();
+            for (uint32_t i = 0; i < ops; i++)
+                failures += !run_op((enum Workload)w, config, i);
+            uint64_t elapsed = now_ns() - start;
+
+            struct WorkloadResult *result = &results[w];
+            result->ops = w == WL_DELETE ? 2 * ops : ops;
+            result->failures = failures;
+            result->blocks_read = ram_disk.blocks_read - reads_before;
+            result->blocks_written = ram_disk.blocks_written - writes_before;
+            if (r == 0 || elapsed < result->best_ns)
+                result->best_ns = elapsed;
+        }
+    }
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ./bench-fs [-r repeats] [-f files,...] [-s sizes,...]\n"
+            "  -r repeats  pengulangan per konfigurasi, waktu terbaik dilaporkan (default 3)\n"
+            "  -f files    daftar jumlah file, dipisah koma (default 48,192,576)\n"
+            "  -s sizes    daftar ukuran file dalam byte, maks %u (default 48,2048,16384)\n",
+            BENCH_MAX_FILE_SIZE);
+}
+
+static uint32_t parse_list(const char *arg, uint32_t *out, uint32_t max)
+{
+    uint32_t count = 0;
+    const char *p = arg;
+    while (*p && count < max)
+    {
+        char *end;
+        out[count++] = (uint32_t)strtoul(p, &end, 10);
+        if (end == p)
+            return 0;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t repeats = 3;
+    uint32_t file_counts[8] = {48, 192, 576}, file_count_n = 3;
+    uint32_t sizes[8] = {48, 2048, 16384}, size_n = 3;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:f:s:")) != -1)
+    {
+        if (opt == 'r')
+            repeats = (uint32_t)atoi(optarg);
+        else if (opt == 'f')
+            file_count_n = parse_list(optarg, file_counts, 8);
+        else if (opt == 's')
+            size_n = parse_list(optarg, sizes, 8);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (repeats == 0 || file_count_n == 0 || size_n == 0)
+    {
+        usage();
+        return 1;
+    }
+
+    // Minimal sebesar storage.bin: header snapshot di belakang filesystem ikut dibaca saat mount
+    size_t storage_size = (size_t)BLOCKS_COUNT * BLOCK_SIZE;
+    if (storage_size < DISK_SPACE)
+        storage_size = DISK_SPACE;
+    ram_disk.storage = malloc(storage_size);
+    if (ram_disk.storage == NULL)
+    {
+        perror("bench-fs: malloc");
+        return 1;
+    }
+    for (uint32_t i = 0; i < sizeof(data_buf); i++)
+        data_buf[i] = (uint8_t)("bench-fs data "[i % 14] ^ (i / 997));
+
+    uint32_t data_blocks = BLOCKS_COUNT - GROUPS_COUNT * EXT2_RESERVED_BLOCKS;
+    fprintf(stderr, "bench-fs: %u group x %u blok, %u inode/group, %u blok data\n",
+            (unsigned)GROUPS_COUNT, (unsigned)BLOCKS_PER_GROUP, (unsigned)INODES_PER_GROUP, data_blocks);
+    printf("workload,files,file_size,ops,failures,ns_per_op,ops_per_sec,block_reads_per_op,block_writes_per_op\n");
+
+    for (uint32_t f = 0; f < file_count_n; f++)
+    {
+        for (uint32_t s = 0; s < size_n; s++)
+        {
+            struct BenchConfig config = {file_counts[f], sizes[s]};
+            uint32_t dirs = (config.files + BENCH_FILES_PER_DIR - 1) / BENCH_FILES_PER_DIR;
+            // Original + salinan setelah append (salinan berbagi blok, blok terakhir di-unshare)
+            uint64_t blocks_needed = (uint64_t)config.files * ((config.file_size + BENCH_APPEND_SIZE) / BLOCK_SIZE + 4) + 2 * dirs;
+            if (config.file_size > BENCH_MAX_FILE_SIZE || dirs > 1024 ||
+                2 * config.files + 3 * dirs + 1 > INODES_PER_GROUP * GROUPS_COUNT || blocks_needed > data_blocks)
+            {
+                fprintf(stderr, "bench-fs: lewati %u file x %u bytes, tidak muat di geometri ini\n",
+                        config.files, config.file_size);
+                continue;
+            }
+
+            struct WorkloadResult results[WL_COUNT];
+            run_config(&config, repeats, results);
+            for (uint32_t w = 0; w < WL_COUNT; w++)
+            {
+                struct WorkloadResult *result = &results[w];
+                double ns_per_op = result->ops ? (double)result->best_ns / result->ops : 0;
+                printf("%s,%u,%u,%u,%u,%.0f,%.0f,%.2f,%.2f\n", workload_names[w], config.files, config.file_size,
+                       result->ops, result->failures, ns_per_op, ns_per_op > 0 ? 1e9 / ns_per_op : 0,
+                       result->ops ? (double)result->blocks_read / result->ops : 0,
+                       result->ops ? (double)result->blocks_written / result->ops : 0);
+            }
+        }
+    }
+
+    free(ram_disk.storage);
+    return 0;
+}
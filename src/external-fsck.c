@@ -0,0 +1,907 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysinfo.h>
+
+#include "header/filesystem/ext2.h"
+#include "header/driver/disk.h"
+#include "header/stdlib/crc32c.h"
+
+/**
+ * fsck - verifikasi (dan perbaikan opsional) image EXT2 dari host
+ *
+ * Geometri dibaca dari superblock, bukan dari konstanta build, sehingga image
+ * hasil mkimage dengan geometri besar juga bisa diperiksa. Pass per group
+ * (inode & directory, block map, bitmap) dijalankan paralel, satu group per
+ * job; hanya pass reachability yang sekuensial.
+ *
+ *   pass 1  inode bitmap, mode, checksum inode & directory block, entri directory
+ *   pass 2  reachability dari root, '.' / '..', jumlah link per inode
+ *   pass 3  block map setiap inode hidup: pointer invalid, i_blocks, owner per blok
+ *   pass 4  block bitmap vs owner, refcount table, double allocation, free count
+ *
+ * Exit code mengikuti e2fsck: 0 bersih, 1 error diperbaiki, 4 error tersisa, 8 gagal
+ */
+
+// unistd.h tidak di-include karena read()/write() bentrok dengan deklarasi di ext2.h
+int close(int fd);
+
+#define ROOT_INODE      2
+#define FSCK_EXIT_OK    0
+#define FSCK_EXIT_FIXED 1
+#define FSCK_EXIT_ERROR 4
+#define FSCK_EXIT_FAIL  8
+#define PTRS_PER_BLOCK  (BLOCK_SIZE / sizeof(uint32_t))
+
+enum EntryKind
+{
+    ENTRY_DOT,
+    ENTRY_DOTDOT,
+    ENTRY_NAME
+};
+
+struct DirEdge
+{
+    uint32_t dir;    // inode direktori pemilik entri
+    uint32_t child;  // inode yang ditunjuk
+    uint16_t offset; // offset entri di blok direktori (untuk perbaikan)
+    uint8_t kind;    // enum EntryKind
+};
+
+struct EdgeList
+{
+    struct DirEdge *items;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+struct InodeState
+{
+    bool used;       // bit inode bitmap
+    bool valid;      // used dan mode dikenali
+    bool is_dir;
+    bool dir_ok;     // blok direktori bisa di-parse
+    bool reachable;
+    bool live;       // dihitung di pass 3/4
+    uint16_t links;  // jumlah entri bernama yang menunjuk inode ini
+    uint32_t parent; // direktori yang memuat entri pertama
+    uint32_t dotdot; // isi entri '..' (direktori)
+};
+
+struct Geometry
+{
+    uint32_t groups;
+    uint32_t blocks;
+    uint32_t inodes;
+    uint32_t blocks_per_group;
+    uint32_t inodes_per_group;
+    uint32_t inode_table_blocks;
+    uint32_t reserved; // blok lokal [0, reserved) di setiap group dipakai metadata
+    bool csum;
+};
+
+// Global variable
+static uint8_t *image_storage;
+static size_t image_size;
+static struct Geometry geo;
+static struct EXT2BlockGroupDescriptor *bgd;
+static struct InodeState *inodes;
+static uint16_t *block_owners;
+static struct EdgeList *group_edges;
+static uint8_t *dirty_dir; // per inode: blok direktori perlu checksum ulang
+
+static bool repair = false;
+static bool verbose = false;
+static uint32_t error_count;
+static uint32_t fixed_count;
+static uint32_t printed;
+static pthread_mutex_t report_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define MAX_PRINTED 64
+
+static void report(bool fixed, const char *fmt, ...)
+{
+    pthread_mutex_lock(&report_lock);
+    error_count++;
+    if (fixed)
+        fixed_count++;
+    if (verbose || printed < MAX_PRINTED)
+    {
+        va_list args;
+        va_start(args, fmt);
+        vprintf(fmt, args);
+        va_end(args);
+        printf(fixed ? " [diperbaiki]\n" : "\n");
+        printed++;
+    }
+    else if (printed == MAX_PRINTED)
+    {
+        printf("... (gunakan -v untuk semua pesan)\n");
+        printed++;
+    }
+    pthread_mutex_unlock(&report_lock);
+}
+
+static uint8_t *block_ptr(uint32_t block)
+{
+    return image_storage + (size_t)block * BLOCK_SIZE;
+}
+
+static bool bit_get(const uint8_t *bitmap, uint32_t bit)
+{
+    return (bitmap[bit / 8] >> (bit % 8)) & 1;
+}
+
+static void bit_set(uint8_t *bitmap, uint32_t bit, bool value)
+{
+    if (value)
+        bitmap[bit / 8] |= (uint8_t)(1 << (bit % 8));
+    else
+        bitmap[bit / 8] &= (uint8_t)~(1 << (bit % 8));
+}
+
+// Inode table tidak selalu sejajar dengan batas struct, salin lewat memcpy
+static void load_inode(uint32_t inode, struct EXT2Inode *out)
+{
+    uint32_t local = (inode - 1) % geo.inodes_per_group;
+    uint32_t group = (inode - 1) / geo.inodes_per_group;
+    memcpy(out, block_ptr(bgd[group].bg_inode_table) + (size_t)local * INODE_SIZE, INODE_SIZE);
+}
+
+/* -- Checksum, harus identik dengan ext2.c -- */
+
+static uint32_t superblock_checksum(const struct EXT2Superblock *sb)
+{
+    return crc32c(~0u, sb, offsetof(struct EXT2Superblock, s_checksum));
+}
+
+static uint32_t group_desc_checksum(uint32_t group, const struct EXT2BlockGroupDescriptor *desc)
+{
+    uint32_t crc = crc32c(~0u, &group, sizeof(group));
+    crc = crc32c(crc, desc, offsetof(struct EXT2BlockGroupDescriptor, bg_checksum));
+    return crc32c(crc, (const uint8_t *)desc + offsetof(struct EXT2BlockGroupDescriptor, bg_reserved),
+                  sizeof(desc->bg_reserved));
+}
+
+static uint32_t inode_checksum(uint32_t inode, const struct EXT2Inode *node)
+{
+    uint32_t crc = crc32c(~0u, &inode, sizeof(inode));
+    return crc32c(crc, node, offsetof(struct EXT2Inode, i_checksum));
+}
+
+static uint32_t dir_block_checksum(uint32_t block, const uint8_t *buf)
+{
+    uint32_t crc = crc32c(~0u, &block, sizeof(block));
+    return crc32c(crc, buf, BLOCK_SIZE - sizeof(struct EXT2DirectoryTail));
+}
+
+static void store_inode(uint32_t inode, struct EXT2Inode *node)
+{
+    uint32_t local = (inode - 1) % geo.inodes_per_group;
+    uint32_t group = (inode - 1) / geo.inodes_per_group;
+    if (geo.csum)
+        node->i_checksum = inode_checksum(inode, node);
+    memcpy(block_ptr(bgd[group].bg_inode_table) + (size_t)local * INODE_SIZE, node, INODE_SIZE);
+}
+
+static void seal_dir_block(uint32_t block)
+{
+    if (!geo.csum)
+        return;
+    uint8_t *buf = block_ptr(block);
+    struct EXT2DirectoryTail *tail = (struct EXT2DirectoryTail *)(buf + BLOCK_SIZE - sizeof(struct EXT2DirectoryTail));
+    memset(tail, 0, sizeof(*tail));
+    tail->det_rec_len = sizeof(struct EXT2DirectoryTail);
+    tail->det_reserved_ft = EXT2_FT_DIR_CSUM;
+    tail->det_checksum = dir_block_checksum(block, buf);
+}
+
+static bool is_data_block(uint32_t block)
+{
+    return block < geo.blocks && block % geo.blocks_per_group >= geo.reserved;
+}
+
+/* -- Paralel: satu job per group, thread mengambil group berikutnya secara atomik -- */
+
+typedef void (*GroupPass)(uint32_t group);
+
+struct PassJob
+{
+    GroupPass pass;
+    uint32_t next;
+};
+
+static void *pass_worker(void *arg)
+{
+    struct PassJob *job = arg;
+    uint32_t group;
+    while ((group = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < geo.groups)
+        job->pass(group);
+    return NULL;
+}
+
+static uint32_t thread_count;
+
+static void run_parallel(GroupPass pass)
+{
+    struct PassJob job = {pass, 0};
+    uint32_t n = thread_count < geo.groups ? thread_count : geo.groups;
+    pthread_t threads[64];
+    for (uint32_t i = 1; i < n; i++)
+        pthread_create(&threads[i], NULL, pass_worker, &job);
+    pass_worker(&job);
+    for (uint32_t i = 1; i < n; i++)
+        pthread_join(threads[i], NULL);
+}
+
+/* -- Pass 1: inode & directory -- */
+
+static void edge_push(struct EdgeList *list, uint32_t dir, uint32_t child, uint16_t offset, uint8_t kind)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->items = realloc(list->items, list->capacity * sizeof(struct DirEdge));
+        if (list->items == NULL)
+        {
+            perror("fsck: realloc");
+            exit(FSCK_EXIT_FAIL);
+        }
+    }
+    list->items[list->count++] = (struct DirEdge){dir, child, offset, kind};
+}
+
+static bool scan_directory(uint32_t inode, const struct EXT2Inode *node, struct EdgeList *edges)
+{
+    uint32_t block = node->i_block[0];
+    if (!is_data_block(block))
+    {
+        report(false, "inode %u: blok direktori %u tidak valid", inode, block);
+        return false;
+    }
+
+    uint8_t *buf = block_ptr(block);
+    uint32_t data_size = BLOCK_SIZE;
+    if (geo.csum)
+    {
+        data_size -= sizeof(struct EXT2DirectoryTail);
+        struct EXT2DirectoryTail *tail = (struct EXT2DirectoryTail *)(buf + data_size);
+        if (tail->det_rec_len != sizeof(struct EXT2DirectoryTail) || tail->det_reserved_ft != EXT2_FT_DIR_CSUM ||
+            tail->det_checksum != dir_block_checksum(block, buf))
+        {
+            report(repair, "inode %u: checksum blok direktori %u tidak cocok", inode, block);
+            dirty_dir[inode] = 1;
+        }
+    }
+
+    uint32_t offset = 0;
+    while (offset < data_size)
+    {
+        struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(buf + offset);
+        uint16_t rec_len = entry->rec_len;
+        uint16_t name_len = entry->name_len;
+        if (rec_len < sizeof(struct EXT2DirectoryEntry) || offset + rec_len > data_size ||
+            (entry->inode != 0 && (name_len == 0 || sizeof(struct EXT2DirectoryEntry) + name_len > rec_len)))
+        {
+            report(false, "inode %u: entri direktori rusak di offset %u (rec_len %u, name_len %u)",
+                   inode, offset, rec_len, name_len);
+            return false;
+        }
+
+        if (entry->inode != 0)
+        {
+            const char *name = (const char *)(entry + 1);
+            uint8_t kind = ENTRY_NAME;
+            if (name_len == 1 && name[0] == '.')
+                kind = ENTRY_DOT;
+            else if (name_len == 2 && name[0] == '.' && name[1] == '.')
+                kind = ENTRY_DOTDOT;
+            edge_push(edges, inode, entry->inode, (uint16_t)offset, kind);
+        }
+        offset += rec_len;
+    }
+    return true;
+}
+
+static void pass1_group(uint32_t group)
+{
+    const uint8_t *inode_bitmap = block_ptr(bgd[group].bg_inode_bitmap);
+    uint32_t used = 0, dirs = 0;
+
+    for (uint32_t local = 0; local < geo.inodes_per_group; local++)
+    {
+        uint32_t inode = group * geo.inodes_per_group + local + 1;
+        struct InodeState *state = &inodes[inode];
+        state->used = bit_get(inode_bitmap, local);
+        if (!state->used)
+            continue;
+        used++;
+
+        struct EXT2Inode node;
+        load_inode(inode, &node);
+        if (node.i_mode != EXT2_S_IFDIR && node.i_mode != EXT2_S_IFREG)
+        {
+            report(repair, "inode %u: dipakai di bitmap tetapi mode 0x%x tidak valid", inode, node.i_mode);
+            continue;
+        }
+        state->valid = true;
+        state->is_dir = node.i_mode == EXT2_S_IFDIR;
+        if (state->is_dir)
+            dirs++;
+
+        if (geo.csum && node.i_checksum != inode_checksum(inode, &node))
+        {
+            report(repair, "inode %u: checksum tidak cocok", inode);
+            if (repair)
+                store_inode(inode, &node);
+        }
+
+        if ((node.i_flags & EXT2_INLINE_DATA_FL) && node.i_size > EXT2_INLINE_DATA_MAX)
+            report(false, "inode %u: inline data %u bytes melebihi %u", inode, node.i_size, (unsigned)EXT2_INLINE_DATA_MAX);
+
+        if (state->is_dir)
+            state->dir_ok = scan_directory(inode, &node, &group_edges[group]);
+    }
+
+    if (bgd[group].bg_used_dirs_count != dirs)
+    {
+        report(repair, "group %u: bg_used_dirs_count %u, seharusnya %u", group, bgd[group].bg_used_dirs_count, dirs);
+        if (repair)
+            bgd[group].bg_used_dirs_count = (uint16_t)dirs;
+    }
+    // Free inode count dihitung ulang setelah pass 2 (inode yatim bisa dibebaskan)
+    (void)used;
+}
+
+/* -- Pass 2: reachability & link count (sekuensial) -- */
+
+static void clear_entry(uint32_t dir, uint16_t offset)
+{
+    struct EXT2Inode node;
+    load_inode(dir, &node);
+    struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(block_ptr(node.i_block[0]) + offset);
+    entry->inode = 0;
+    dirty_dir[dir] = 1;
+}
+
+static void set_entry(uint32_t dir, uint16_t offset, uint32_t target)
+{
+    struct EXT2Inode node;
+    load_inode(dir, &node);
+    struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(block_ptr(node.i_block[0]) + offset);
+    entry->inode = target;
+    dirty_dir[dir] = 1;
+}
+
+static int compare_edge(const void *a, const void *b)
+{
+    const struct DirEdge *x = a, *y = b;
+    if (x->dir != y->dir)
+        return x->dir < y->dir ? -1 : 1;
+    return x->offset < y->offset ? -1 : (x->offset > y->offset);
+}
+
+static void pass2(void)
+{
+    // Gabungkan entri semua group, diurutkan per direktori
+    uint32_t total = 0;
+    for (uint32_t g = 0; g < geo.groups; g++)
+        total += group_edges[g].count;
+    struct DirEdge *edges = malloc((total ? total : 1) * sizeof(struct DirEdge));
+    uint32_t *first = calloc(geo.inodes + 2, sizeof(uint32_t)); // indeks entri pertama per direktori
+    uint32_t *queue = malloc((geo.inodes + 1) * sizeof(uint32_t));
+    if (edges == NULL || first == NULL || queue == NULL)
+    {
+        perror("fsck: malloc");
+        exit(FSCK_EXIT_FAIL);
+    }
+    total = 0;
+    for (uint32_t g = 0; g < geo.groups; g++)
+    {
+        if (group_edges[g].count != 0)
+            memcpy(edges + total, group_edges[g].items, group_edges[g].count * sizeof(struct DirEdge));
+        total += group_edges[g].count;
+    }
+    qsort(edges, total, sizeof(struct DirEdge), compare_edge);
+    for (uint32_t i = total; i-- > 0;)
+        first[edges[i].dir] = i + 1; // 0 = tidak ada entri
+
+    if (!inodes[ROOT_INODE].valid || !inodes[ROOT_INODE].is_dir)
+    {
+        report(false, "root inode %u bukan direktori yang valid", ROOT_INODE);
+        free(edges);
+        free(first);
+        free(queue);
+        return;
+    }
+
+    // BFS dari root lewat entri bernama
+    uint32_t head = 0, tail = 0;
+    inodes[ROOT_INODE].reachable = true;
+    inodes[ROOT_INODE].parent = ROOT_INODE;
+    queue[tail++] = ROOT_INODE;
+    while (head < tail)
+    {
+        uint32_t dir = queue[head++];
+        if (first[dir] == 0)
+            continue;
+        bool seen_dot = false, seen_dotdot = false;
+        for (uint32_t i = first[dir] - 1; i < total && edges[i].dir == dir; i++)
+        {
+            struct DirEdge *edge = &edges[i];
+            if (edge->child == 0 || edge->child > geo.inodes || !inodes[edge->child].valid)
+            {
+                report(repair, "direktori %u: entri di offset %u menunjuk inode %u yang tidak dipakai",
+                       dir, edge->offset, edge->child);
+                if (repair)
+                    clear_entry(dir, edge->offset);
+                continue;
+            }
+
+            if (edge->kind == ENTRY_DOT)
+            {
+                seen_dot = true;
+                if (edge->child != dir)
+                {
+                    report(repair, "direktori %u: '.' menunjuk %u", dir, edge->child);
+                    if (repair)
+                        set_entry(dir, edge->offset, dir);
+                }
+                continue;
+            }
+            if (edge->kind == ENTRY_DOTDOT)
+            {
+                seen_dotdot = true;
+                inodes[dir].dotdot = edge->child;
+                if (edge->child != inodes[dir].parent)
+                {
+                    report(repair, "direktori %u: '..' menunjuk %u, seharusnya %u", dir, edge->child, inodes[dir].parent);
+                    if (repair)
+                        set_entry(dir, edge->offset, inodes[dir].parent);
+                }
+                continue;
+            }
+
+            struct InodeState *child = &inodes[edge->child];
+            child->links++;
+            if (edge->child == ROOT_INODE || child->links > 1)
+            {
+                // Tidak ada hard link: inode yang dirujuk dua kali akan dibebaskan dua kali saat delete
+                report(repair, "direktori %u: inode %u dirujuk lebih dari satu kali", dir, edge->child);
+                if (repair)
+                {
+                    clear_entry(dir, edge->offset);
+                    child->links--;
+                }
+                continue;
+            }
+            child->parent = dir;
+            child->reachable = true;
+            if (child->is_dir && child->dir_ok)
+                queue[tail++] = edge->child;
+        }
+        if (!seen_dot || !seen_dotdot)
+            report(false, "direktori %u: entri '.' atau '..' hilang", dir);
+    }
+
+    // Inode terpakai yang tidak terjangkau dari root; tidak ada lost+found, repair membebaskannya
+    for (uint32_t inode = 1; inode <= geo.inodes; inode++)
+    {
+        struct InodeState *state = &inodes[inode];
+        if (state->used && !state->reachable)
+            report(repair, "inode %u: dipakai tetapi tidak terjangkau dari root", inode);
+        state->live = state->valid && (state->reachable || !repair);
+    }
+
+    free(edges);
+    free(first);
+    free(queue);
+}
+
+/* -- Pass 3: block map -- */
+
+static uint32_t walk_pointer(uint32_t inode, uint32_t *slot, uint32_t level, uint32_t *data_blocks, bool *modified)
+{
+    uint32_t block = *slot;
+    if (block == 0)
+        return 0;
+    if (!is_data_block(block))
+    {
+        report(repair, "inode %u: pointer blok %u di luar area data", inode, block);
+        if (repair)
+        {
+            *slot = 0;
+            *modified = true;
+        }
+        return 0;
+    }
+
+    __atomic_fetch_add(&block_owners[block], 1, __ATOMIC_RELAXED);
+    if (level == 0)
+    {
+        (*data_blocks)++;
+        return 1;
+    }
+
+    uint32_t *table = (uint32_t *)block_ptr(block);
+    uint32_t count = 1;
+    for (uint32_t i = 0; i < PTRS_PER_BLOCK; i++)
+        count += walk_pointer(inode, &table[i], level - 1, data_blocks, modified); // tabel indirect langsung di image
+    return count;
+}
+
+static void pass3_group(uint32_t group)
+{
+    for (uint32_t local = 0; local < geo.inodes_per_group; local++)
+    {
+        uint32_t inode = group * geo.inodes_per_group + local + 1;
+        if (!inodes[inode].live)
+            continue;
+
+        struct EXT2Inode node;
+        load_inode(inode, &node);
+        if (node.i_flags & EXT2_INLINE_DATA_FL)
+        {
+            if (node.i_blocks != 0)
+            {
+                report(repair, "inode %u: inline data dengan i_blocks %u", inode, node.i_blocks);
+                if (repair)
+                {
+                    node.i_blocks = 0;
+                    store_inode(inode, &node);
+                }
+            }
+            continue;
+        }
+
+        // i_block disalin keluar dari struct packed agar bisa dioper sebagai pointer
+        uint32_t block_map[15];
+        memcpy(block_map, node.i_block, sizeof(block_map));
+        bool modified = false;
+        uint32_t data_blocks = 0;
+        for (uint32_t i = 0; i < 12; i++)
+            walk_pointer(inode, &block_map[i], 0, &data_blocks, &modified);
+        walk_pointer(inode, &block_map[12], 1, &data_blocks, &modified);
+        walk_pointer(inode, &block_map[13], 2, &data_blocks, &modified);
+        if (block_map[14] != 0)
+        {
+            report(repair, "inode %u: triple indirect %u tidak didukung", inode, block_map[14]);
+            if (repair)
+            {
+                block_map[14] = 0;
+                modified = true;
+            }
+        }
+        memcpy(node.i_block, block_map, sizeof(block_map));
+
+        uint64_t max_blocks = ((uint64_t)node.i_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (data_blocks > max_blocks)
+            report(false, "inode %u: %u blok data melebihi ukuran %u bytes", inode, data_blocks, node.i_size);
+
+        if (node.i_blocks != data_blocks)
+        {
+            report(repair, "inode %u: i_blocks %u, seharusnya %u", inode, node.i_blocks, data_blocks);
+            if (repair)
+            {
+                node.i_blocks = data_blocks;
+                modified = true;
+            }
+        }
+        if (modified)
+            store_inode(inode, &node);
+    }
+}
+
+/* -- Pass 4: bitmap, refcount, free count -- */
+
+static uint8_t *refcount_table(void)
+{
+    struct EXT2Superblock *sb = (struct EXT2Superblock *)block_ptr(1);
+    if (sb->s_refcount_table == 0 || (uint64_t)sb->s_refcount_blocks * BLOCK_SIZE < geo.blocks)
+        return NULL;
+    return block_ptr(sb->s_refcount_table);
+}
+
+static uint32_t *group_free_blocks;
+static uint32_t *group_free_inodes;
+
+static void pass4_group(uint32_t group)
+{
+    uint8_t *block_bitmap = block_ptr(bgd[group].bg_block_bitmap);
+    uint8_t *inode_bitmap = block_ptr(bgd[group].bg_inode_bitmap);
+    uint8_t *refcount = refcount_table();
+    uint32_t free_blocks = 0, free_inodes = 0;
+
+    for (uint32_t local = 0; local < geo.blocks_per_group; local++)
+    {
+        uint32_t block = group * geo.blocks_per_group + local;
+        uint16_t owners = block_owners[block];
+        bool expected = local < geo.reserved || owners > 0;
+        bool marked = bit_get(block_bitmap, local);
+
+        if (marked != expected)
+        {
+            if (marked)
+                report(repair, "blok %u: ditandai terpakai tetapi tidak dirujuk", block);
+            else
+                report(repair, "blok %u: dipakai %u inode tetapi bebas di bitmap", block, owners);
+            if (repair)
+                bit_set(block_bitmap, local, expected);
+        }
+        if (!(repair ? expected : marked))
+            free_blocks++;
+
+        if (local < geo.reserved)
+            continue;
+
+        uint32_t extra = owners > 0 ? owners - 1u : 0u;
+        if (refcount == NULL)
+        {
+            if (owners > 1)
+                report(false, "blok %u: dialokasikan ganda (%u pemilik) tanpa refcount table", block, owners);
+        }
+        else if (refcount[block] != extra)
+        {
+            // Pemilik ganda diperbaiki menjadi blok bersama, copy-on-write memisahkannya saat ditulis
+            if (owners > (uint32_t)refcount[block] + 1)
+                report(repair && extra <= EXT2_REFCOUNT_MAX, "blok %u: dialokasikan ganda (%u pemilik, refcount %u)",
+                       block, owners, refcount[block]);
+            else
+                report(repair, "blok %u: refcount %u, seharusnya %u", block, refcount[block], extra);
+            if (repair && extra <= EXT2_REFCOUNT_MAX)
+                refcount[block] = (uint8_t)extra;
+        }
+    }
+
+    for (uint32_t local = 0; local < geo.inodes_per_group; local++)
+    {
+        uint32_t inode = group * geo.inodes_per_group + local + 1;
+        bool keep = inodes[inode].live;
+        if (repair && inodes[inode].used && !keep)
+            bit_set(inode_bitmap, local, false);
+        if (!(repair ? keep : inodes[inode].used))
+            free_inodes++;
+    }
+
+    if (bgd[group].bg_free_blocks_count != free_blocks)
+    {
+        report(repair, "group %u: bg_free_blocks_count %u, seharusnya %u", group, bgd[group].bg_free_blocks_count, free_blocks);
+        if (repair)
+            bgd[group].bg_free_blocks_count = (uint16_t)free_blocks;
+    }
+    if (bgd[group].bg_free_inodes_count != free_inodes)
+    {
+        report(repair, "group %u: bg_free_inodes_count %u, seharusnya %u", group, bgd[group].bg_free_inodes_count, free_inodes);
+        if (repair)
+            bgd[group].bg_free_inodes_count = (uint16_t)free_inodes;
+    }
+    if (repair)
+    {
+        // bg_used_dirs_count dari pass 1 belum memperhitungkan direktori yatim yang dibebaskan
+        uint32_t dirs = 0;
+        for (uint32_t local = 0; local < geo.inodes_per_group; local++)
+        {
+            uint32_t inode = group * geo.inodes_per_group + local + 1;
+            if (inodes[inode].live && inodes[inode].is_dir)
+                dirs++;
+        }
+        bgd[group].bg_used_dirs_count = (uint16_t)dirs;
+    }
+    group_free_blocks[group] = free_blocks;
+    group_free_inodes[group] = free_inodes;
+}
+
+/* -- Superblock & geometri -- */
+
+static bool load_geometry(void)
+{
+    struct EXT2Superblock *sb = (struct EXT2Superblock *)block_ptr(1);
+    if (sb->s_magic != EXT2_SUPER_MAGIC)
+    {
+        fprintf(stderr, "fsck: magic superblock 0x%x bukan EXT2\n", sb->s_magic);
+        return false;
+    }
+
+    geo.blocks_per_group = sb->s_blocks_per_group;
+    geo.inodes_per_group = sb->s_inodes_per_group;
+    if (geo.blocks_per_group == 0 || geo.blocks_per_group > BLOCK_SIZE * 8 ||
+        geo.inodes_per_group == 0 || geo.inodes_per_group > BLOCK_SIZE * 8 ||
+        sb->s_blocks_count % geo.blocks_per_group != 0)
+    {
+        fprintf(stderr, "fsck: geometri superblock tidak valid (%u blok/group, %u inode/group)\n",
+                geo.blocks_per_group, geo.inodes_per_group);
+        return false;
+    }
+    geo.groups = sb->s_blocks_count / geo.blocks_per_group;
+    geo.blocks = sb->s_blocks_count;
+    geo.inodes = geo.groups * geo.inodes_per_group;
+    geo.inode_table_blocks = (geo.inodes_per_group * INODE_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    geo.reserved = sb->s_refcount_table ? sb->s_refcount_table + sb->s_refcount_blocks
+                                        : 3 + geo.groups * (2 + geo.inode_table_blocks);
+    geo.csum = (sb->s_feature_ro_compat & EXT2_FEATURE_RO_COMPAT_METADATA_CSUM) != 0;
+
+    if (geo.groups * sizeof(struct EXT2BlockGroupDescriptor) > BLOCK_SIZE ||
+        (size_t)geo.blocks * BLOCK_SIZE > image_size || geo.reserved >= geo.blocks_per_group ||
+        sb->s_inodes_count != geo.inodes)
+    {
+        fprintf(stderr, "fsck: superblock tidak konsisten dengan ukuran image (%u blok, %zu bytes)\n",
+                geo.blocks, image_size);
+        return false;
+    }
+
+    bgd = (struct EXT2BlockGroupDescriptor *)block_ptr(2);
+    for (uint32_t g = 0; g < geo.groups; g++)
+    {
+        if (bgd[g].bg_block_bitmap >= geo.reserved || bgd[g].bg_inode_bitmap >= geo.reserved ||
+            bgd[g].bg_inode_table + geo.inode_table_blocks > geo.reserved)
+        {
+            fprintf(stderr, "fsck: group %u: metadata di luar area reserved\n", g);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_descriptors(void)
+{
+    struct EXT2Superblock *sb = (struct EXT2Superblock *)block_ptr(1);
+    if (geo.csum)
+    {
+        if (sb->s_checksum != superblock_checksum(sb))
+            report(repair, "superblock: checksum tidak cocok");
+        for (uint32_t g = 0; g < geo.groups; g++)
+            if (bgd[g].bg_checksum != group_desc_checksum(g, &bgd[g]))
+                report(repair, "group %u: checksum descriptor tidak cocok", g);
+    }
+}
+
+static void finish_superblock(void)
+{
+    struct EXT2Superblock *sb = (struct EXT2Superblock *)block_ptr(1);
+    uint32_t free_blocks = 0, free_inodes = 0;
+    for (uint32_t g = 0; g < geo.groups; g++)
+    {
+        free_blocks += group_free_blocks[g];
+        free_inodes += group_free_inodes[g];
+    }
+
+    if (sb->s_free_blocks_count != free_blocks)
+    {
+        report(repair, "superblock: s_free_blocks_count %u, seharusnya %u", sb->s_free_blocks_count, free_blocks);
+        if (repair)
+            sb->s_free_blocks_count = free_blocks;
+    }
+    if (sb->s_free_inodes_count != free_inodes)
+    {
+        report(repair, "superblock: s_free_inodes_count %u, seharusnya %u", sb->s_free_inodes_count, free_inodes);
+        if (repair)
+            sb->s_free_inodes_count = free_inodes;
+    }
+    if (sb->s_state != EXT2_VALID_FS && error_count == 0)
+        report(repair, "superblock: state %u (error tercatat oleh driver)", sb->s_state);
+
+    if (!repair)
+        return;
+
+    for (uint32_t inode = 1; inode <= geo.inodes; inode++)
+    {
+        if (dirty_dir[inode] && inodes[inode].live)
+        {
+            struct EXT2Inode node;
+            load_inode(inode, &node);
+            seal_dir_block(node.i_block[0]);
+        }
+    }
+
+    sb->s_state = error_count == fixed_count ? EXT2_VALID_FS : EXT2_ERROR_FS;
+    if (geo.csum)
+    {
+        for (uint32_t g = 0; g < geo.groups; g++)
+            bgd[g].bg_checksum = group_desc_checksum(g, &bgd[g]);
+        sb->s_checksum = superblock_checksum(sb);
+    }
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ./fsck [-y] [-v] [-j threads] <storage>\n"
+            "  -y          perbaiki error yang bisa diperbaiki\n"
+            "  -v          tampilkan semua pesan error\n"
+            "  -j threads  jumlah thread pass paralel (default: jumlah CPU)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    thread_count = (uint32_t)get_nprocs();
+    int opt;
+    while ((opt = getopt(argc, argv, "yvj:")) != -1)
+    {
+        if (opt == 'y')
+            repair = true;
+        else if (opt == 'v')
+            verbose = true;
+        else if (opt == 'j')
+            thread_count = (uint32_t)atoi(optarg);
+        else
+        {
+            usage();
+            return FSCK_EXIT_FAIL;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage();
+        return FSCK_EXIT_FAIL;
+    }
+    if (thread_count == 0)
+        thread_count = 1;
+    if (thread_count > 64)
+        thread_count = 64;
+
+    int fd = open(argv[optind], repair ? O_RDWR : O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0 || (size_t)st.st_size < 3 * BLOCK_SIZE)
+    {
+        fprintf(stderr, "fsck: tidak dapat membuka image '%s'\n", argv[optind]);
+        return FSCK_EXIT_FAIL;
+    }
+    image_size = (size_t)st.st_size;
+    // Tanpa -y image dipetakan privat sehingga tidak pernah ditulis
+    image_storage = mmap(NULL, image_size, PROT_READ | PROT_WRITE, repair ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image_storage == MAP_FAILED)
+    {
+        perror("fsck: mmap");
+        return FSCK_EXIT_FAIL;
+    }
+
+    crc32c_hw_enabled(); // inisialisasi tabel CRC sebelum thread berjalan
+    if (!load_geometry())
+        return FSCK_EXIT_FAIL;
+
+    inodes = calloc(geo.inodes + 1, sizeof(struct InodeState));
+    dirty_dir = calloc(geo.inodes + 1, 1);
+    block_owners = calloc(geo.blocks, sizeof(uint16_t));
+    group_edges = calloc(geo.groups, sizeof(struct EdgeList));
+    group_free_blocks = calloc(geo.groups, sizeof(uint32_t));
+    group_free_inodes = calloc(geo.groups, sizeof(uint32_t));
+    if (!inodes || !dirty_dir || !block_owners || !group_edges || !group_free_blocks || !group_free_inodes)
+    {
+        perror("fsck: calloc");
+        return FSCK_EXIT_FAIL;
+    }
+
+    printf("fsck: %u group, %u blok, %u inode, %u thread%s\n", geo.groups, geo.blocks, geo.inodes,
+           thread_count < geo.groups ? thread_count : geo.groups, geo.csum ? ", metadata_csum" : "");
+
+    check_descriptors();
+    run_parallel(pass1_group);
+    pass2();
+    run_parallel(pass3_group);
+    run_parallel(pass4_group);
+    finish_superblock();
+
+    uint32_t used_inodes = 0;
+    for (uint32_t inode = 1; inode <= geo.inodes; inode++)
+        used_inodes += inodes[inode].live;
+    printf("fsck: %u inode terpakai, %u/%u blok bebas, %u error (%u diperbaiki)\n", used_inodes,
+           ((struct EXT2Superblock *)block_ptr(1))->s_free_blocks_count, geo.blocks, error_count, fixed_count);
+
+    if (repair)
+        msync(image_storage, image_size, MS_SYNC);
+    munmap(image_storage, image_size);
+
+    if (error_count == 0)
+        return FSCK_EXIT_OK;
+    return error_count == fixed_count ? FSCK_EXIT_FIXED : FSCK_EXIT_ERROR;
+}
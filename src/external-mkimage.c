@@ -0,0 +1,475 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "header/filesystem/ext2.h"
+#include "header/driver/disk.h"
+#include "header/stdlib/string.h"
+
+/**
+ * mkimage - bangun / isi image EXT2 dalam satu kali jalan
+ *
+ * Berbeda dengan inserter (satu file per eksekusi, image disalin 3x ke heap),
+ * image di-mmap langsung sehingga read_blocks / write_blocks hanya memcpy ke
+ * halaman file dan tidak ada tahap tulis-ulang 4 MB di akhir. Allocator blok
+ * next-fit di ext2.c membuat file yang ditulis berurutan tersusun contiguous.
+ *
+ * Manifest, satu entri per baris ('#' komentar):
+ *   d /image/dir              buat direktori (beserta parent-nya)
+ *   f /image/path host_file   salin file host ke path di image
+ */
+
+// unistd.h tidak di-include karena read()/write() bentrok dengan driver EXT2
+int close(int fd);
+int ftruncate(int fd, off_t length);
+
+#define ROOT_INODE 2
+#define MAX_PATH   1024
+
+// Global variable
+uint8_t *image_storage;
+size_t image_size;
+
+struct MkimageStats
+{
+    uint32_t files;
+    uint32_t dirs;
+    uint64_t bytes;
+    uint32_t errors;
+};
+
+static struct MkimageStats stats;
+
+void read_blocks(void *ptr, uint32_t logical_block_address, uint8_t block_count)
+{
+    memcpy(ptr, image_storage + (size_t)BLOCK_SIZE * logical_block_address, (size_t)BLOCK_SIZE * block_count);
+}
+
+void write_blocks(const void *ptr, uint32_t logical_block_address, uint8_t block_count)
+{
+    memcpy(image_storage + (size_t)BLOCK_SIZE * logical_block_address, ptr, (size_t)BLOCK_SIZE * block_count);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ./mkimage [-F] [-R] [-S] [-m manifest] [-C hostdir] <storage> [host_file[:/image/path]]...\n"
+            "  -F            format ulang image (geometri: %u group x %u blok, %u inode/group)\n"
+            "  -R            rollback ke snapshot dulu (sebelum file ditambahkan)\n"
+            "  -S            buat snapshot setelah semua file ditambahkan\n"
+            "  -m manifest   baris 'd /dir' atau 'f /path host_file'\n"
+            "  -C hostdir    salin isi hostdir secara rekursif ke root image\n",
+            (unsigned)GROUPS_COUNT, (unsigned)BLOCKS_PER_GROUP, (unsigned)INODES_PER_GROUP);
+}
+
+static bool fill_request(struct EXT2DriverRequest *request, uint32_t parent, const char *name, size_t name_len)
+{
+    if (name_len == 0 || name_len > 255)
+    {
+        fprintf(stderr, "mkimage: nama tidak valid (panjang %zu)\n", name_len);
+        return false;
+    }
+    memset(request, 0, sizeof(*request));
+    memcpy(request->name, name, name_len);
+    request->name_len = (uint8_t)name_len;
+    request->parent_inode = parent;
+    return true;
+}
+
+static bool lookup_child(uint32_t parent, const char *name, uint32_t *out_inode)
+{
+    struct EXT2Inode dir_inode;
+    read_inode(parent, &dir_inode);
+    return find_inode_in_dir(&dir_inode, name, out_inode);
+}
+
+/**
+ * @brief Buat direktori name di parent jika belum ada
+ * @return inode direktori, 0 jika gagal atau nama dipakai oleh file
+ */
+static uint32_t make_dir(uint32_t parent, const char *name)
+{
+    uint32_t inode;
+    if (lookup_child(parent, name, &inode))
+    {
+        struct EXT2Inode node;
+        read_inode(inode, &node);
+        if (!is_directory(&node))
+        {
+            fprintf(stderr, "mkimage: '%s' sudah ada dan bukan direktori\n", name);
+            return 0;
+        }
+        return inode;
+    }
+
+    struct EXT2DriverRequest request;
+    if (!fill_request(&request, parent, name, strlen(name)))
+        return 0;
+    request.is_directory = 1;
+    int8_t ret = write(request);
+    if (ret != 0 || !lookup_child(parent, name, &inode))
+    {
+        fprintf(stderr, "mkimage: gagal membuat direktori '%s' (code %d)\n", name, ret);
+        return 0;
+    }
+    stats.dirs++;
+    return inode;
+}
+
+/**
+ * @brief Telusuri path absolut di image mulai dari root
+ * @param create_dirs     buat komponen direktori yang belum ada (mkdir -p)
+ * @param out_leaf        jika tidak NULL, komponen terakhir tidak ditelusuri dan disalin ke sini
+ * @return inode direktori hasil penelusuran, 0 jika gagal
+ */
+static uint32_t resolve_path(const char *path, bool create_dirs, char *out_leaf)
+{
+    char copy[MAX_PATH];
+    if (strlen(path) >= sizeof(copy))
+        return 0;
+    strcpy(copy, path);
+
+    uint32_t current = ROOT_INODE;
+    char *save = NULL;
+    char *component = strtok_r(copy, "/", &save);
+    while (component != NULL)
+    {
+        char *next = strtok_r(NULL, "/", &save);
+        if (next == NULL && out_leaf != NULL)
+        {
+            strcpy(out_leaf, component);
+            return current;
+        }
+
+        uint32_t child;
+        if (create_dirs)
+            child = make_dir(current, component);
+        else if (!lookup_child(current, component, &child))
+            child = 0;
+        if (child == 0)
+            return 0;
+        current = child;
+        component = next;
+    }
+
+    if (out_leaf != NULL)
+        out_leaf[0] = '\0';
+    return current;
+}
+
+static uint32_t free_blocks(void)
+{
+    return ((struct EXT2Superblock *)(image_storage + BLOCK_SIZE))->s_free_blocks_count;
+}
+
+/**
+ * @brief Salin satu file host ke image_path, file lama dengan nama sama diganti
+ */
+static bool add_file(const char *image_path, const char *host_path)
+{
+    char leaf[256];
+    if (strlen(image_path) >= MAX_PATH || strrchr(image_path, '/') == NULL ||
+        strlen(strrchr(image_path, '/') + 1) > 255)
+    {
+        fprintf(stderr, "mkimage: path image tidak valid '%s'\n", image_path);
+        return false;
+    }
+    uint32_t parent = resolve_path(image_path, true, leaf);
+    if (parent == 0 || leaf[0] == '\0')
+    {
+        fprintf(stderr, "mkimage: path image tidak valid '%s'\n", image_path);
+        return false;
+    }
+
+    int fd = open(host_path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0 || !S_ISREG(st.st_mode))
+    {
+        fprintf(stderr, "mkimage: tidak dapat membaca '%s'\n", host_path);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    // Estimasi kasar: blok data + blok indirect
+    uint64_t data_blocks = ((uint64_t)st.st_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint64_t needed = data_blocks + data_blocks / (BLOCK_SIZE / sizeof(uint32_t)) + 2;
+    if (st.st_size > UINT32_MAX || needed > free_blocks())
+    {
+        fprintf(stderr, "mkimage: '%s' (%lld bytes) tidak muat, sisa %u blok\n",
+                host_path, (long long)st.st_size, free_blocks());
+        close(fd);
+        return false;
+    }
+
+    void *data = NULL;
+    if (st.st_size > 0)
+    {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            perror("mkimage: mmap file");
+            close(fd);
+            return false;
+        }
+    }
+    close(fd);
+
+    struct EXT2DriverRequest request;
+    if (!fill_request(&request, parent, leaf, strlen(leaf)))
+    {
+        if (data != NULL)
+            munmap(data, (size_t)st.st_size);
+        return false;
+    }
+
+    uint32_t existing;
+    if (lookup_child(parent, leaf, &existing))
+    {
+        struct EXT2Inode node;
+        read_inode(existing, &node);
+        if (is_directory(&node) || delete(request) != 0)
+        {
+            fprintf(stderr, "mkimage: tidak dapat mengganti '%s'\n", image_path);
+            if (data != NULL)
+                munmap(data, (size_t)st.st_size);
+            return false;
+        }
+    }
+
+    request.buf = data;
+    request.buffer_size = (uint32_t)st.st_size;
+    int8_t ret = write(request);
+    if (data != NULL)
+        munmap(data, (size_t)st.st_size);
+    if (ret != 0)
+    {
+        fprintf(stderr, "mkimage: gagal menulis '%s' (code %d)\n", image_path, ret);
+        return false;
+    }
+
+    stats.files++;
+    stats.bytes += (uint64_t)st.st_size;
+    return true;
+}
+
+static void count_result(bool ok)
+{
+    if (!ok)
+        stats.errors++;
+}
+
+static void add_tree(const char *host_dir, const char *image_dir)
+{
+    DIR *dir = opendir(host_dir);
+    if (dir == NULL)
+    {
+        fprintf(stderr, "mkimage: tidak dapat membuka direktori '%s'\n", host_dir);
+        stats.errors++;
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        char host_path[MAX_PATH], image_path[MAX_PATH];
+        if ((size_t)snprintf(host_path, sizeof(host_path), "%s/%s", host_dir, entry->d_name) >= sizeof(host_path) ||
+            (size_t)snprintf(image_path, sizeof(image_path), "%s/%s", image_dir, entry->d_name) >= sizeof(image_path))
+        {
+            fprintf(stderr, "mkimage: path terlalu panjang '%s/%s'\n", host_dir, entry->d_name);
+            stats.errors++;
+            continue;
+        }
+
+        struct stat st;
+        if (stat(host_path, &st) < 0)
+        {
+            stats.errors++;
+            continue;
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            count_result(resolve_path(image_path, true, NULL) != 0);
+            add_tree(host_path, image_path);
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            count_result(add_file(image_path, host_path));
+        }
+    }
+    closedir(dir);
+}
+
+static void add_manifest(const char *manifest_path)
+{
+    FILE *manifest = fopen(manifest_path, "r");
+    if (manifest == NULL)
+    {
+        fprintf(stderr, "mkimage: tidak dapat membuka manifest '%s'\n", manifest_path);
+        stats.errors++;
+        return;
+    }
+
+    char line[2 * MAX_PATH + 16];
+    uint32_t line_no = 0;
+    while (fgets(line, sizeof(line), manifest) != NULL)
+    {
+        line_no++;
+        char kind[4], image_path[MAX_PATH], host_path[MAX_PATH];
+        int fields = sscanf(line, "%3s %1023s %1023s", kind, image_path, host_path);
+        if (fields <= 0 || kind[0] == '#')
+            continue;
+
+        if (strcmp(kind, "d") == 0 && fields >= 2)
+            count_result(resolve_path(image_path, true, NULL) != 0);
+        else if (strcmp(kind, "f") == 0 && fields == 3)
+            count_result(add_file(image_path, host_path));
+        else
+        {
+            fprintf(stderr, "mkimage: %s:%u: baris tidak valid\n", manifest_path, line_no);
+            stats.errors++;
+        }
+    }
+    fclose(manifest);
+}
+
+int main(int argc, char *argv[])
+{
+    bool format = false, rollback = false, take_snapshot = false;
+    const char *manifests[16];
+    const char *trees[16];
+    int manifest_count = 0, tree_count = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "FRSm:C:")) != -1)
+    {
+        if (opt == 'F')
+            format = true;
+        else if (opt == 'R')
+            rollback = true;
+        else if (opt == 'S')
+            take_snapshot = true;
+        else if (opt == 'm' && manifest_count < 16)
+            manifests[manifest_count++] = optarg;
+        else if (opt == 'C' && tree_count < 16)
+            trees[tree_count++] = optarg;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage();
+        return 1;
+    }
+
+    // Image minimal sebesar disk qemu (4 MB) atau sebesar geometri filesystem
+    image_size = (size_t)BLOCKS_COUNT * BLOCK_SIZE;
+    if (image_size < DISK_SPACE)
+        image_size = DISK_SPACE;
+
+    const char *storage = argv[optind];
+    int fd = open(storage, O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0)
+    {
+        perror("mkimage: tidak dapat membuka storage");
+        return 1;
+    }
+    if ((size_t)st.st_size < image_size && ftruncate(fd, (off_t)image_size) < 0)
+    {
+        perror("mkimage: ftruncate");
+        close(fd);
+        return 1;
+    }
+
+    image_storage = mmap(NULL, image_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image_storage == MAP_FAILED)
+    {
+        perror("mkimage: mmap storage");
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (format)
+        memset(image_storage + BLOCK_SIZE, 0, BLOCK_SIZE); // hapus magic, initialize akan format ulang
+    else if (!is_empty_storage() &&
+             ((struct EXT2Superblock *)(image_storage + BLOCK_SIZE))->s_blocks_count != BLOCKS_COUNT)
+    {
+        fprintf(stderr, "mkimage: geometri image berbeda dari build ini, gunakan -F untuk format ulang\n");
+        munmap(image_storage, image_size);
+        return 1;
+    }
+    initialize_filesystem_ext2();
+
+    // Kembali ke dataset yang dibekukan: hanya blok yang berubah sejak snapshot yang disalin
+    if (rollback)
+    {
+        uint32_t changed_blocks;
+        snapshot_status(&changed_blocks);
+        int8_t result = snapshot_rollback();
+        if (result != 0)
+        {
+            fprintf(stderr, "mkimage: rollback gagal (%s)\n", result > 0 ? "tidak ada snapshot" : "storage terlalu kecil");
+            munmap(image_storage, image_size);
+            return 1;
+        }
+        printf("mkimage: rollback %u blok\n", changed_blocks);
+    }
+
+    for (int i = 0; i < tree_count; i++)
+        add_tree(trees[i], "");
+    for (int i = 0; i < manifest_count; i++)
+        add_manifest(manifests[i]);
+
+    // Argumen posisi: host_file atau host_file:/image/path
+    for (int i = optind + 1; i < argc; i++)
+    {
+        char host_path[MAX_PATH], image_path[MAX_PATH];
+        const char *sep = strchr(argv[i], ':');
+        if (sep != NULL)
+        {
+            snprintf(host_path, sizeof(host_path), "%.*s", (int)(sep - argv[i]), argv[i]);
+            snprintf(image_path, sizeof(image_path), "%s", sep + 1);
+        }
+        else
+        {
+            const char *base = strrchr(argv[i], '/');
+            snprintf(host_path, sizeof(host_path), "%s", argv[i]);
+            snprintf(image_path, sizeof(image_path), "/%s", base ? base + 1 : argv[i]);
+        }
+        count_result(add_file(image_path, host_path));
+    }
+
+    if (take_snapshot && snapshot_create() != 0)
+    {
+        fprintf(stderr, "mkimage: storage terlalu kecil untuk snapshot\n");
+        stats.errors++;
+    }
+
+    msync(image_storage, image_size, MS_SYNC);
+    munmap(image_storage, image_size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double elapsed_ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    printf("mkimage: %u file, %u direktori, %llu bytes dalam %.2f ms%s\n",
+           stats.files, stats.dirs, (unsigned long long)stats.bytes, elapsed_ms,
+           stats.errors ? " (ada error)" : "");
+    return stats.errors ? 1 : 0;
+}
@@ -17,10 +17,58 @@
 // #define BLOCKS_PER_GROUP (DISK_SPACE / BLOCK_SIZE / GROUPS_COUNT)                // number of blocks per group
 // #define INODES_TABLE_BLOCK_COUNT 16u
 // #define INODES_PER_GROUP (INODES_PER_TABLE * INODES_TABLE_BLOCK_COUNT) // number of inodes per group
+// Geometri bisa di-override dengan -D (misal tool host seperti mkimage untuk disk uji besar),
+// kernel & image harus dikompilasi dengan geometri yang sama
+#ifndef GROUPS_COUNT
 #define GROUPS_COUNT 1
+#endif
+#ifndef INODES_PER_GROUP
 #define INODES_PER_GROUP 32
+#endif
+#ifndef BLOCKS_PER_GROUP
 #define BLOCKS_PER_GROUP 1024
-#define INODES_TABLE_BLOCK_COUNT 4
+#endif
+#if BLOCKS_PER_GROUP > BLOCK_SIZE * 8 || INODES_PER_GROUP > BLOCK_SIZE * 8
+#error "block & inode bitmap of a group must fit in a single block"
+#endif
+#define INODES_TABLE_BLOCK_COUNT ((INODES_PER_GROUP * INODE_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE) // whole blocks holding one group's inodes
+#define BLOCKS_COUNT (BLOCKS_PER_GROUP * GROUPS_COUNT)
+#define EXT2_INODES_COUNT (INODES_PER_GROUP * GROUPS_COUNT)
+
+/**
+ * data block reference count table (reflink / copy-on-write copies)
+ * - one byte per block, stored right after the last group's inode table
+ * - the value is the number of *extra* owners, so 0 means "owned by a single inode" (or free)
+ */
+#define EXT2_REFCOUNT_TABLE_BLOCKS ((BLOCKS_COUNT + BLOCK_SIZE - 1) / BLOCK_SIZE)
+#define EXT2_REFCOUNT_TABLE_LOCATION (3 + GROUPS_COUNT * (2 + INODES_TABLE_BLOCK_COUNT))
+#define EXT2_REFCOUNT_MAX 0xFF
+#define EXT2_RESERVED_BLOCKS (EXT2_REFCOUNT_TABLE_LOCATION + EXT2_REFCOUNT_TABLE_BLOCKS) // boot, super, bgd, per group bitmaps & inode table, refcount table
+
+/**
+ * filesystem snapshot, a copy-on-write store placed on the storage right after the last filesystem block
+ * - one header block (EXT2SnapshotHeader), a bitmap with one bit per filesystem block,
+ *   then one save slot per filesystem block
+ * - while a snapshot exists, the first write to a block after the snapshot saves the original
+ *   content into the block's slot and sets its bit, later writes to that block cost nothing extra
+ * - rollback copies only the saved blocks back, O(changed blocks)
+ * - only available when the store fits in DISK_SPACE (default geometry: 2050 of 8192 blocks)
+ */
+#define EXT2_SNAPSHOT_MAGIC 0x50414E53 // "SNAP"
+#define EXT2_SNAPSHOT_LOCATION BLOCKS_COUNT
+#define EXT2_SNAPSHOT_BITMAP_BLOCKS ((BLOCKS_COUNT + BLOCK_SIZE * 8 - 1) / (BLOCK_SIZE * 8))
+#define EXT2_SNAPSHOT_DATA_LOCATION (EXT2_SNAPSHOT_LOCATION + 1 + EXT2_SNAPSHOT_BITMAP_BLOCKS)
+#define EXT2_SNAPSHOT_END (EXT2_SNAPSHOT_DATA_LOCATION + BLOCKS_COUNT)
+#define EXT2_SNAPSHOT_SUPPORTED ((uint64_t)EXT2_SNAPSHOT_END * BLOCK_SIZE <= DISK_SPACE)
+
+/**
+ * superblock state & features
+ * - EXT2_FEATURE_RO_COMPAT_METADATA_CSUM: superblock, group descriptors, inodes and directory blocks
+ *   carry a crc32c checksum, directory blocks end with an EXT2DirectoryTail
+ */
+#define EXT2_VALID_FS 1 // s_state: unmounted cleanly
+#define EXT2_ERROR_FS 2 // s_state: errors detected (e.g. checksum mismatch)
+#define EXT2_FEATURE_RO_COMPAT_METADATA_CSUM 0x0400
 
 /**
  * inodes constant
@@ -29,6 +77,27 @@
 #define EXT2_S_IFREG 0x8000 // regular file
 #define EXT2_S_IFDIR 0x4000 // directory
 
+/**
+ * inode flags (i_flags)
+ * - EXT2_COMPR_FL: file data is stored in LZ4 compressed clusters, on a directory new files inherit it
+ * - EXT2_INLINE_DATA_FL: file content is stored directly in i_block (no data block), i_blocks == 0
+ */
+#define EXT2_COMPR_FL 0x00000004
+#define EXT2_INLINE_DATA_FL 0x10000000
+#define EXT2_INLINE_DATA_MAX (15 * sizeof(uint32_t)) // size of i_block, 60 bytes
+
+/**
+ * compressed clusters (EXT2_COMPR_FL)
+ * - file is split into clusters of EXT2_COMPR_CLUSTER_BLOCKS logical blocks
+ * - a compressed cluster starts with EXT2ComprClusterHeader + LZ4 data in its first blocks,
+ *   the remaining blocks of the cluster are holes (the block map doubles as cluster map)
+ * - a cluster is compressed only if that saves at least one block, otherwise every
+ *   block of the cluster is allocated and stored raw
+ */
+#define EXT2_COMPR_CLUSTER_BLOCKS 8
+#define EXT2_COMPR_CLUSTER_SIZE (EXT2_COMPR_CLUSTER_BLOCKS * BLOCK_SIZE)
+#define EXT2_COMPR_MAGIC 0x345A4C43 // "CLZ4"
+
 /* FILE TYPE CONSTANT*/
 /**
  * reference:
@@ -55,6 +124,29 @@ struct EXT2DriverRequest
   uint8_t is_directory;
 } __attribute__((packed));
 
+/**
+ * EXT2FindRequest
+ * request for find_by_name(), answered from the kernel name index
+ *
+ * @param name        name or prefix to search
+ * @param name_len    length of name
+ * @param prefix      0: exact name, 1: every name starting with name
+ * @param buf         output, absolute paths separated by '\0'
+ * @param buffer_size size of buf
+ * @param match_count number of matches (may be more than path_count)
+ * @param path_count  number of paths written to buf
+ */
+struct EXT2FindRequest
+{
+  char name[256];
+  uint8_t name_len;
+  uint8_t prefix;
+  char *buf;
+  uint32_t buffer_size;
+  uint32_t match_count;
+  uint32_t path_count;
+} __attribute__((packed));
+
 /**
  * EXT2Superblock:
  * - https://www.nongnu.org/ext2-doc/ext2.html#superblock
@@ -108,6 +200,12 @@ struct EXT2Superblock
   uint8_t s_prealloc_blocks;     // 8bit value indicating the number of blocks to preallocate for files.
   uint8_t s_prealloc_dir_blocks; // 8bit value indicating the number of blocks to preallocate for directories.
 
+  uint32_t s_refcount_table;  // 32bit block id of the first block of the data block reference count table, 0 if the filesystem has no shared block support
+  uint32_t s_refcount_blocks; // 32bit value indicating the number of blocks used by the reference count table
+
+  uint32_t s_feature_ro_compat; // 32bit mask of read-only compatible features (EXT2_FEATURE_RO_COMPAT_*)
+  uint32_t s_checksum;          // crc32c of every superblock field before this one, must stay the last field
+
 } __attribute__((packed));
 
 /**
@@ -150,9 +248,14 @@ struct EXT2BlockGroupDescriptor
   uint16_t bg_pad;
 
   /**
-   * 12 bytes of reserved space for future revisions.
+   * crc32c of the group number and this descriptor (bg_checksum excluded), see EXT2_FEATURE_RO_COMPAT_METADATA_CSUM
    */
-  uint32_t bg_reserved[3]; // 12 bytes of reserved space for future revisions.
+  uint32_t bg_checksum;
+
+  /**
+   * 8 bytes of reserved space for future revisions.
+   */
+  uint32_t bg_reserved[2]; // 8 bytes of reserved space for future revisions.
 } __attribute__((packed));
 
 /**
@@ -174,6 +277,7 @@ struct EXT2Inode
   uint16_t i_mode;   // 16bit value indicating the file type and the access rights.
   uint32_t i_size;   // 32bit value indicating the size of the file in bytes.
   uint32_t i_blocks; // 32bit value indicating the number of blocks used by the file.
+  uint32_t i_flags;  // 32bit value indicating how the implementation should behave when accessing the data for this inode (EXT2_*_FL).
 
   /**
    * 15 x 32bit block numbers pointing to the blocks containing the data for this inode
@@ -190,12 +294,37 @@ struct EXT2Inode
    */
   uint32_t i_block[15];
 
+  uint32_t i_checksum; // crc32c of the inode number and every field above, must stay the last field
+
 } __attribute__((packed));
 
 struct EXT2InodeTable
 {
   struct EXT2Inode table[INODES_PER_GROUP]; // can be change with fixed size array
-};
+  uint8_t padding[INODES_TABLE_BLOCK_COUNT * BLOCK_SIZE - INODES_PER_GROUP * INODE_SIZE]; // round up to whole blocks
+} __attribute__((packed));
+
+/**
+ * EXT2SnapshotHeader
+ * first block of the snapshot store, all zero when there is no snapshot
+ */
+struct EXT2SnapshotHeader
+{
+  uint32_t magic;        // EXT2_SNAPSHOT_MAGIC
+  uint32_t blocks_count; // BLOCKS_COUNT of the filesystem the snapshot belongs to
+} __attribute__((packed));
+
+/**
+ * EXT2ComprClusterHeader
+ * stored at the start of the first block of a compressed cluster, followed by the LZ4 block
+ */
+struct EXT2ComprClusterHeader
+{
+  uint32_t magic;           // EXT2_COMPR_MAGIC
+  uint32_t compressed_size; // size of the LZ4 data after this header
+  uint32_t original_size;   // size of the cluster data before compression
+  uint32_t reserved;
+} __attribute__((packed));
 
 /**
  * EXT2DirectoryEntry
@@ -227,6 +356,22 @@ struct EXT2DirectoryEntry
 
 } __attribute__((packed));
 
+/**
+ * EXT2DirectoryTail
+ * last entry of every directory block when EXT2_FEATURE_RO_COMPAT_METADATA_CSUM is set.
+ * Looks like an unused entry (inode 0, name_len 0) so directory walkers simply skip it
+ */
+#define EXT2_FT_DIR_CSUM 0xDE // file_type of the directory tail
+
+struct EXT2DirectoryTail
+{
+  uint32_t det_reserved_zero1; // always 0 (inode)
+  uint16_t det_rec_len;        // sizeof(struct EXT2DirectoryTail)
+  uint16_t det_reserved_zero2; // always 0 (name_len)
+  uint8_t det_reserved_ft;     // EXT2_FT_DIR_CSUM
+  uint32_t det_checksum;       // crc32c of the block number and the directory entries before the tail
+} __attribute__((packed));
+
 /**
  *  REGULAR function
  */
@@ -337,18 +482,55 @@ int8_t read(struct EXT2DriverRequest request);
 /**
  * @brief EXT2 write, write a file or a folder to file system
  *
- * @param All attribute will be used for write except is_dir, buffer_size == 0 then create a folder / directory. It is possible that exist file with name same as a folder
- * @return Error code: 0 success - 1 file/folder already exist - 2 invalid parent folder - -1 unknown
+ * @param All attribute will be used for write except is_dir, buffer_size == 0 then create a folder / directory. It is possible that exist file with name same as a folder.
+ * buf == NULL with buffer_size > 0 creates a sparse file, blocks that are all zero are not allocated
+ * @return Error code: 0 success - 1 file/folder already exist - 2 invalid parent folder - 3 parent folder full - -1 unknown
  */
 int8_t write(struct EXT2DriverRequest request);
 
+/**
+ * @brief EXT2 write at offset into an existing file, offset past EOF leaves a hole,
+ * only the blocks that are actually written get allocated
+ * @param request buf and buffer_size is the data, name and parent_inode select the file
+ * @param offset byte offset in the file
+ * @return Error code: 0 success - 1 not found - 2 target is a folder - 3 invalid parent folder - -1 too large / disk full
+ */
+int8_t write_at(struct EXT2DriverRequest request, uint32_t offset);
+
+/**
+ * @brief write_at for an inode that is already resolved (mmap writeback)
+ * @param inode_idx target file inode
+ * @param buf data to write
+ * @param size data size in bytes
+ * @param offset byte offset in the file
+ * @return Error code: 0 success - 2 target is a folder - -1 too large / disk full
+ */
+int8_t write_inode_at(uint32_t inode_idx, const void *buf, uint32_t size, uint32_t offset);
+
 /**
  * @brief EXT2 delete, delete a file or empty directory in file system
  *  @param request buf and buffer_size is unused, is_dir == true means delete folder (possible file with name same as folder)
- * @return Error code: 0 success - 1 not found - 2 folder is not empty - 3 parent folder invalid -1 unknown
+ * @return Error code: 0 success - 1 not found - 2 folder is not empty or invalid target ("." or "..") - 3 parent folder invalid -1 unknown
  */
 int8_t delete(struct EXT2DriverRequest request);
 
+/**
+ * @brief EXT2 recursive delete (rm -r), walks the subtree iteratively and
+ * frees every block and inode in one batch: bitmaps and superblock are written once
+ * @param request buf and buffer_size is unused, is_directory is ignored
+ * @return Error code: 0 success - 1 not found - 2 invalid target ("." or "..") - 3 parent folder invalid - -1 unknown
+ */
+int8_t delete_recursive(struct EXT2DriverRequest request);
+
+/**
+ * @brief EXT2 set_compression, toggle EXT2_COMPR_FL on a file or directory (chattr +c / -c).
+ * Existing file data is converted cluster by cluster, on a directory only new files are affected
+ * @param request buf and buffer_size is unused, is_directory is ignored
+ * @param enable true to store the data compressed, false to store it raw
+ * @return Error code: 0 success - 1 not found - 3 parent folder invalid - -1 disk full (file stays compressed)
+ */
+int8_t set_compression(struct EXT2DriverRequest request, bool enable);
+
 /* =============================== MEMORY ==========================================*/
 
 /**
@@ -434,10 +616,33 @@ void set_inode_used(uint32_t inode);
 void clear_inode_used(uint32_t inode);
 int32_t allocate_block(uint32_t preferred_bgd);
 void sync_superblock(void);
-void add_inode_to_dir(struct EXT2Inode *dir_inode, uint32_t inode, const char *name);
+/**
+ * @brief add a directory entry for inode into dir_inode, file type is taken from the inode mode
+ * @return false if the directory block has no room left
+ */
+bool add_inode_to_dir(struct EXT2Inode *dir_inode, uint32_t inode, const char *name);
 bool is_empty_directory(struct EXT2Inode *inode);
 void remove_inode_from_dir(struct EXT2Inode *dir_inode, const char *name);
 
+/**
+ * @brief bytes of a directory block usable by entries: the last entry's rec_len ends here
+ * (BLOCK_SIZE minus the checksum tail when metadata checksums are enabled)
+ */
+uint32_t get_dir_data_size(void);
+
+/**
+ * @brief read a directory block and verify its checksum tail,
+ * a mismatch marks the filesystem with EXT2_ERROR_FS but the data is still returned
+ * @return false if the checksum does not match
+ */
+bool read_dir_block(void *buf, uint32_t block);
+
+/**
+ * @brief write a directory block, (re)building its checksum tail first
+ * @param buf directory block, entries must end at get_dir_data_size()
+ */
+void write_dir_block(void *buf, uint32_t block);
+
 // ...existing code...
 
 /**
@@ -448,6 +653,13 @@ void remove_inode_from_dir(struct EXT2Inode *dir_inode, const char *name);
  */
 void read_inode_data_extended(struct EXT2Inode *inode, void *buf, uint32_t size);
 
+/**
+ * @brief Membaca range [offset, offset+size) dari file, dipotong di EOF.
+ *        Hole dibaca nol, file terkompresi hanya mendekompresi cluster yang tersentuh
+ * @return Jumlah byte yang dibaca
+ */
+uint32_t read_inode_range(struct EXT2Inode *inode, void *buf, uint32_t offset, uint32_t size);
+
 /**
  * @brief Mengalokasi blok untuk inode dengan dukungan indirect blocks
  * @param ptr Buffer data yang akan ditulis
@@ -479,6 +691,228 @@ uint32_t get_physical_block_from_logical(struct EXT2Inode *inode, uint32_t logic
  */
 uint32_t allocate_logical_block(struct EXT2Inode *inode, uint32_t logical_block_idx, uint32_t preferred_bgd);
 
+/* =============================== SHARED BLOCKS ===================================*/
+
+/**
+ * @brief check whether a data block is owned by more than one inode
+ * @param block physical block number
+ * @return true if the block is shared (reflinked)
+ */
+bool is_block_shared(uint32_t block);
+
+/**
+ * @brief add an owner to a data block
+ * @param block physical block number
+ * @return false if the filesystem has no refcount table or the block already has EXT2_REFCOUNT_MAX owners
+ */
+bool block_ref_get(uint32_t block);
+
+/**
+ * @brief drop an owner from a data block
+ * @param block physical block number
+ * @return true if the caller was the last owner and the block must be freed
+ */
+bool block_ref_put(uint32_t block);
+
+/**
+ * @brief make dst share all data blocks of src (reflink copy), only the block map is duplicated.
+ * Blocks are copied later by allocate_logical_block() when either inode writes into them
+ * @param src source inode, i_size and i_block are used
+ * @param dst destination inode, i_block will be filled, should be zeroed by the caller
+ * @param preferred_bgd BGD used to allocate the destination indirect blocks
+ * @return true on success, false if sharing is not possible (dst is left without any block)
+ */
+bool reflink_inode_blocks(struct EXT2Inode *src, struct EXT2Inode *dst, uint32_t preferred_bgd);
+
+/**
+ * @brief make sure a logical block is exclusively owned by the inode before writing into it,
+ * copying the block if it is shared (copy-on-write)
+ * @param inode inode that will be written, its block map may be updated
+ * @param logical_block_idx logical block index
+ * @param preferred_bgd BGD used if a new block must be allocated
+ * @return physical block number that can be written, or 0 if the logical block is not allocated
+ */
+uint32_t unshare_logical_block(struct EXT2Inode *inode, uint32_t logical_block_idx, uint32_t preferred_bgd);
+
+/* =============================== FREE SPACE ===================================*/
+
+/**
+ * free space report (df), answered from the in-memory free extent index without scanning bitmaps
+ *
+ * @param blocks_count        total blocks
+ * @param free_blocks         free blocks
+ * @param free_extents        number of maximal runs of free blocks
+ * @param largest_free_extent length of the longest run, the largest file that can be stored contiguously
+ * @param inodes_count        total inodes
+ * @param free_inodes         free inodes
+ */
+struct EXT2SpaceInfo
+{
+  uint32_t blocks_count;
+  uint32_t free_blocks;
+  uint32_t free_extents;
+  uint32_t largest_free_extent;
+  uint32_t inodes_count;
+  uint32_t free_inodes;
+};
+
+/**
+ * @brief fill a free space report
+ * @param info output
+ */
+void get_space_info(struct EXT2SpaceInfo *info);
+
+/**
+ * @brief best-fit: point the allocation goal at the smallest free run that holds block_count blocks
+ * (the largest run if none does), so the following allocate_block() calls are contiguous. O(log n)
+ * @param block_count number of blocks about to be allocated
+ * @param preferred_bgd group used when there is nothing to plan
+ * @return group to pass to allocate_block()
+ */
+uint32_t plan_contiguous_allocation(uint32_t block_count, uint32_t preferred_bgd);
+
+/* =============================== SNAPSHOT ===================================*/
+
+/**
+ * syscall 41 operations
+ */
+#define EXT2_SNAPSHOT_STATUS 0
+#define EXT2_SNAPSHOT_CREATE 1
+#define EXT2_SNAPSHOT_ROLLBACK 2
+#define EXT2_SNAPSHOT_DROP 3
+
+/**
+ * @brief freeze the current filesystem state, an existing snapshot is replaced
+ * @return 0 on success, -1 if the snapshot store does not fit on the storage
+ */
+int8_t snapshot_create(void);
+
+/**
+ * @brief restore the filesystem to the snapshot, the snapshot is kept so it can be rolled back to again.
+ * In-memory filesystem state is reloaded from disk
+ * @return 0 on success, 1 if there is no snapshot, -1 if snapshots are not supported
+ */
+int8_t snapshot_rollback(void);
+
+/**
+ * @brief forget the snapshot, the current state is kept
+ * @return 0 on success, 1 if there is no snapshot, -1 if snapshots are not supported
+ */
+int8_t snapshot_drop(void);
+
+/**
+ * @brief snapshot state
+ * @param changed_blocks number of blocks written since the snapshot (0 without snapshot)
+ * @return true if a snapshot exists
+ */
+bool snapshot_status(uint32_t *changed_blocks);
+
+/* =============================== DEDUPLICATION ===================================*/
+
+/**
+ * block-level dedup, built on the same refcount table as reflink
+ * - online: every full data block written by write(), write_at and cp is hashed (xxHash64);
+ *   if a block with identical content is already indexed the block map points to it and
+ *   its refcount is raised instead of allocating a new block
+ * - offline: dedup_filesystem() rescans every regular file and merges identical blocks
+ * - the hash index only lives in memory and starts empty on mount, a hash match is always
+ *   verified byte by byte before a block is shared
+ */
+// Online dedup di write / write_at / cp, bisa dimatikan dengan -DEXT2_DEDUP_ONLINE=0 (misal untuk bench-fs)
+#ifndef EXT2_DEDUP_ONLINE
+#define EXT2_DEDUP_ONLINE 1
+#endif
+
+/**
+ * @param blocks_scanned data blocks hashed
+ * @param blocks_merged  block map entries redirected to an identical block
+ * @param blocks_freed   blocks returned to the free pool
+ */
+struct EXT2DedupStats
+{
+  uint32_t blocks_scanned;
+  uint32_t blocks_merged;
+  uint32_t blocks_freed;
+};
+
+/**
+ * @brief offline dedup: rebuild the hash index from every regular file and share identical data blocks
+ * @param stats filled with the scan result
+ * @return 0 on success, -1 if the filesystem has no refcount table
+ */
+int8_t dedup_filesystem(struct EXT2DedupStats *stats);
+
+/**
+ * FILE OPERATIONS (SYSCALL)
+ * operasi shell (cp, mkdir, rm, rmdir, mv) yang dipanggil lewat syscall; berada di
+ * driver agar bisa dikompilasi untuk host (bench-fs, tool image) tanpa interrupt.c
+ */
+
+/**
+ * @brief copy a file in the same parent directory, data blocks are shared (reflink) until written
+ * @param src_request name & parent_inode of the source file
+ * @param dst_request name of the new file (parent_inode of src_request is used)
+ * @return 0 success - -1 invalid request / source not found - -2 destination exists - -3 source is a directory
+ * - -4 no free inode - -5 no free block - -8 parent directory full
+ */
+int8_t copy_file(struct EXT2DriverRequest *src_request, struct EXT2DriverRequest *dst_request);
+
+/**
+ * @brief create an empty directory
+ * @return 0 success - -1 invalid request - -2 parent is not a directory - -3 name exists
+ * - -4 no free inode - -5 no free block - -6 parent directory full
+ */
+int8_t create_directory(struct EXT2DriverRequest *request);
+
+/**
+ * @brief delete a regular file
+ * @return 0 success - -1 invalid request - -2 parent is not a directory - -3 not found - -6 target is a directory
+ */
+int8_t delete_file(struct EXT2DriverRequest *request);
+
+/**
+ * @brief delete an empty directory
+ * @return 0 success - -1 invalid request - -2 parent is not a directory - -3 not found
+ * - -6 target is a file - -7 directory not empty
+ */
+int8_t delete_directory(struct EXT2DriverRequest *request);
+
+/**
+ * @brief rename / move a file or directory, only directory entries are relinked
+ * @return 0 success - -1 invalid request - -2 source not found - -3 destination exists
+ * - -4 destination inside the source directory - -6 destination directory full
+ */
+int8_t move_file(struct EXT2DriverRequest *src_request, struct EXT2DriverRequest *dst_request);
+
+/**
+ * NAME INDEX
+ * index nama -> inode (+ parent) di memori, dibangun ulang saat mount (initialize_filesystem_ext2)
+ * dan diupdate incremental oleh add_inode_to_dir / remove_inode_from_dir / pembebasan inode.
+ * Nama disimpan terurut sehingga exact match dan prefix match sama-sama binary search
+ */
+
+/**
+ * @brief catat directory entry baru di name index (dipanggil add_inode_to_dir)
+ * @param parent inode directory yang memuat entri
+ * @param inode inode yang ditunjuk entri
+ * @param name nama entri, tidak harus diakhiri '\0'
+ * @param name_len panjang nama
+ */
+void name_index_add(uint32_t parent, uint32_t inode, const char *name, uint8_t name_len);
+
+/**
+ * @brief hapus inode dari name index
+ * @param inode inode yang entrinya dihapus / inode yang dibebaskan
+ */
+void name_index_remove(uint32_t inode);
+
+/**
+ * @brief cari semua file/folder dengan nama (atau prefix) tertentu, O(log n + match)
+ * @param request name, prefix, buf dan buffer_size diisi pemanggil
+ * @return 0 success - 1 buf too small (paths truncated, match_count still complete) - -1 invalid request
+ */
+int8_t find_by_name(struct EXT2FindRequest *request);
+
 // ...existing code...
 
 #endif
\ No newline at end of file
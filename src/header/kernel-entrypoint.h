@@ -20,6 +20,11 @@ extern uint32_t _linker_kernel_physical_addr_start;
 extern uint32_t _linker_kernel_physical_addr_end;
 extern uint32_t _linker_kernel_stack_top;
 
+// Register eax & ebx saat bootloader melompat ke loader, disimpan oleh kernel-entrypoint.s
+// _multiboot_info_physical_addr hanya valid jika _multiboot_magic == MULTIBOOT_BOOTLOADER_MAGIC
+extern uint32_t _multiboot_magic;
+extern uint32_t _multiboot_info_physical_addr;
+
 /**
  * Execute user program from kernel, one way jump. This function is defined in asm source code.
  *
@@ -0,0 +1,137 @@
+#ifndef _KMALLOC_H
+#define _KMALLOC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Kernel heap
+ *
+ * - Object cache (slab): setiap slab satu page 4 KiB dari buddy allocator, diakses lewat direct map.
+ *   Header slab di awal page, diikuti stack index object bebas lalu object-object-nya
+ * - Constructor dijalankan sekali saat slab dibuat, bukan setiap alloc. Object yang di-free harus
+ *   dikembalikan ke keadaan "constructed" oleh pemiliknya sehingga alloc berikutnya tidak perlu init ulang
+ * - kmalloc: size class 16 .. KMALLOC_SIZE_CLASS_MAX memakai cache "kmalloc-N", lebih besar langsung
+ *   blok buddy (selalu aligned 4 KiB, object slab tidak pernah aligned page sehingga kfree bisa membedakan)
+ * - Paling banyak satu slab kosong disimpan per cache, sisanya dikembalikan ke buddy
+ */
+#define KMEM_CACHE_COUNT_MAX 24
+#define KMEM_CACHE_NAME_LENGTH 16
+#define KMEM_SLAB_SIZE 0x1000
+#define KMEM_OBJECT_SIZE_MAX 2048
+#define KMALLOC_SIZE_CLASS_MIN 16
+#define KMALLOC_SIZE_CLASS_MAX KMEM_OBJECT_SIZE_MAX
+
+struct KmemSlab;
+
+/**
+ * Object cache untuk satu ukuran object
+ *
+ * @param used             Slot cache terpakai
+ * @param name             Nama cache untuk statistik
+ * @param object_size      Ukuran object, dibulatkan ke kelipatan 8
+ * @param objects_per_slab Jumlah object dalam satu slab
+ * @param first_offset     Offset object pertama dari awal slab
+ * @param constructor      Dipanggil sekali per object saat slab baru dibuat, boleh NULL
+ * @param partial          Slab yang masih punya object bebas
+ * @param full             Slab yang semua object-nya terpakai
+ * @param empty            Slab tanpa object terpakai (cadangan, paling banyak satu)
+ * @param slab_count       Jumlah slab yang dimiliki cache
+ * @param active_objects   Object yang sedang dipakai
+ * @param alloc_count      Total alloc sejak boot
+ * @param free_count       Total free sejak boot
+ */
+struct KmemCache
+{
+  bool used;
+  char name[KMEM_CACHE_NAME_LENGTH];
+  uint32_t object_size;
+  uint32_t objects_per_slab;
+  uint32_t first_offset;
+  void (*constructor)(void *object);
+  struct KmemSlab *partial;
+  struct KmemSlab *full;
+  struct KmemSlab *empty;
+  uint32_t slab_count;
+  uint32_t active_objects;
+  uint32_t alloc_count;
+  uint32_t free_count;
+};
+
+/**
+ * Statistik satu cache untuk syscall slabinfo
+ *
+ * @param total_objects slab_count * objects_per_slab
+ */
+struct KmemCacheInfo
+{
+  char name[KMEM_CACHE_NAME_LENGTH];
+  uint32_t object_size;
+  uint32_t objects_per_slab;
+  uint32_t slab_count;
+  uint32_t active_objects;
+  uint32_t total_objects;
+  uint32_t alloc_count;
+  uint32_t free_count;
+};
+
+// Object cache buffer satu blok filesystem (BLOCK_SIZE), pengganti buffer besar di stack kernel
+extern struct KmemCache *kmem_block_cache;
+
+/**
+ * Buat cache size class kmalloc dan kmem_block_cache, dipanggil sekali setelah paging_init()
+ */
+void kmem_init(void);
+
+/**
+ * Buat object cache baru
+ *
+ * @param name        Nama cache (dipotong ke KMEM_CACHE_NAME_LENGTH - 1)
+ * @param object_size Ukuran object, 1 .. KMEM_OBJECT_SIZE_MAX
+ * @param constructor Constructor object, NULL jika tidak ada
+ * @return            Cache baru, NULL jika ukuran tidak valid atau tabel cache penuh
+ */
+struct KmemCache *kmem_cache_create(const char *name, uint32_t object_size, void (*constructor)(void *object));
+
+/**
+ * Ambil satu object dari cache, slab baru dibuat jika tidak ada object bebas
+ *
+ * @param cache Object cache
+ * @return      Object dalam keadaan constructed, NULL jika memori habis atau cache NULL
+ */
+void *kmem_cache_alloc(struct KmemCache *cache);
+
+/**
+ * Kembalikan object ke cache
+ *
+ * @param cache  Object cache asal object
+ * @param object Object dari kmem_cache_alloc, NULL diabaikan
+ */
+void kmem_cache_free(struct KmemCache *cache, void *object);
+
+/**
+ * Alokasi memori kernel
+ *
+ * @param size Ukuran dalam byte
+ * @return     Pointer kernel (direct map), NULL jika size 0 atau memori habis
+ */
+void *kmalloc(uint32_t size);
+
+/**
+ * Lepas memori dari kmalloc, NULL diabaikan
+ *
+ * @param ptr Pointer dari kmalloc
+ */
+void kfree(void *ptr);
+
+/**
+ * Salin statistik semua cache
+ *
+ * @param info  Array tujuan
+ * @param count Kapasitas array
+ * @return      Jumlah cache yang disalin
+ */
+uint32_t kmem_get_cache_info(struct KmemCacheInfo *info, uint32_t count);
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef _MMAP_H
+#define _MMAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "paging.h"
+#include "../filesystem/ext2.h"
+
+/**
+ * Memory-mapped file
+ *
+ * - Mapping dibuat di region user [MMAP_REGION_START, MMAP_REGION_END), granularity 1 page frame (4 MiB)
+ * - Frame diisi lazily dari file saat page fault (0x0E) pertama pada alamat tersebut
+ * - Frame isi file disimpan di page cache kernel per (inode, offset), dibagi ke semua mapping
+ *   read-only dan MMAP_SHARED sehingga file yang sama tidak dibaca / disimpan dua kali
+ * - MMAP_PRIVATE + MMAP_PROT_WRITE: copy-on-write, frame cache disalin saat write fault pertama
+ * - MMAP_SHARED + MMAP_PROT_WRITE: page yang dirty (dirty bit PDE) ditulis balik ke file saat
+ *   msync / munmap / proses dihancurkan. Ukuran file tidak pernah diubah oleh writeback
+ */
+#define MMAP_REGION_START 0x10000000
+#define MMAP_REGION_END 0x40000000
+#define MMAP_PAGE_COUNT_MAX 32 // page per mapping, dibatasi lebar bitmap private_pages
+#define PROCESS_MMAP_COUNT_MAX 4
+
+#define MMAP_PROT_READ 0x1
+#define MMAP_PROT_WRITE 0x2
+
+#define MMAP_SHARED 0x1
+#define MMAP_PRIVATE 0x2
+// Tanpa file: file.buffer_size = panjang, page 4 KiB zero-fill milik proses (process_mmap_anonymous),
+// tidak memakai tabel mapping ini. munmap dengan alamat hasilnya melepas seluruh region
+#define MMAP_ANONYMOUS 0x4
+
+/**
+ * Satu mapping file di address space proses
+ *
+ * @param used          Slot terpakai
+ * @param virtual_addr  Alamat awal mapping, aligned PAGE_FRAME_SIZE
+ * @param page_count    Jumlah page frame yang dicakup mapping
+ * @param inode         Inode file yang dimap
+ * @param file_offset   Offset file untuk page pertama, aligned PAGE_FRAME_SIZE
+ * @param prot          MMAP_PROT_*
+ * @param flags         MMAP_SHARED atau MMAP_PRIVATE
+ * @param private_pages Bit k set: page k memakai frame milik proses (salinan COW), bukan frame cache
+ */
+struct MemoryMapping
+{
+  bool used;
+  uint32_t virtual_addr;
+  uint32_t page_count;
+  uint32_t inode;
+  uint32_t file_offset;
+  uint8_t prot;
+  uint8_t flags;
+  uint32_t private_pages;
+};
+
+/**
+ * Argumen syscall mmap
+ *
+ * @param file   parent_inode & name memilih file, buffer_size = panjang mapping (0: sampai EOF)
+ * @param offset Offset file, harus kelipatan PAGE_FRAME_SIZE
+ * @param prot   MMAP_PROT_*
+ * @param flags  MMAP_SHARED atau MMAP_PRIVATE, MMAP_ANONYMOUS mengabaikan file kecuali buffer_size
+ */
+struct MmapRequest
+{
+  struct EXT2DriverRequest file;
+  uint32_t offset;
+  uint8_t prot;
+  uint8_t flags;
+};
+
+/**
+ * Map file ke address space proses yang sedang berjalan. Tidak ada I/O sampai page diakses
+ *
+ * @param mappings Tabel mapping milik proses
+ * @param request  Argumen mmap
+ * @return         Alamat virtual mapping, NULL jika gagal
+ */
+void *mmap_create(struct MemoryMapping *mappings, struct MmapRequest *request);
+
+/**
+ * Tulis balik page dirty lalu hapus mapping yang dimulai di addr
+ *
+ * @param page_dir Page directory proses pemilik mapping, harus sedang aktif
+ * @param mappings Tabel mapping milik proses
+ * @param addr     Alamat yang dikembalikan mmap_create
+ * @return         0 sukses - 1 tidak ada mapping di addr - -1 writeback gagal (mapping tetap dihapus)
+ */
+int8_t mmap_remove(struct PageDirectory *page_dir, struct MemoryMapping *mappings, void *addr);
+
+/**
+ * Tulis balik page dirty dari mapping MMAP_SHARED yang memuat addr
+ *
+ * @param page_dir Page directory proses pemilik mapping, harus sedang aktif
+ * @param mappings Tabel mapping milik proses
+ * @param addr     Alamat di dalam mapping
+ * @return         0 sukses - 1 tidak ada mapping di addr - -1 writeback gagal
+ */
+int8_t mmap_sync(struct PageDirectory *page_dir, struct MemoryMapping *mappings, void *addr);
+
+/**
+ * Hapus semua mapping proses (dipanggil saat proses dihancurkan)
+ *
+ * @param page_dir Page directory proses, harus sedang aktif
+ * @param mappings Tabel mapping milik proses
+ */
+void mmap_remove_all(struct PageDirectory *page_dir, struct MemoryMapping *mappings);
+
+/**
+ * Page fault handler untuk region mmap
+ *
+ * @param page_dir   Page directory yang aktif saat fault
+ * @param mappings   Tabel mapping proses yang sedang berjalan
+ * @param fault_addr CR2
+ * @param error_code Error code page fault (bit 0 present, bit 1 write)
+ * @return           True jika fault sudah ditangani dan instruksi boleh diulang
+ */
+bool mmap_handle_page_fault(struct PageDirectory *page_dir, struct MemoryMapping *mappings, uint32_t fault_addr, uint32_t error_code);
+
+/**
+ * Buang frame cache milik file yang isinya diubah tanpa lewat mapping (write_at, chattr, delete).
+ * Mapping yang sudah ada tetap memakai frame lamanya, mapper berikutnya membaca ulang dari disk.
+ * Page exec image cache file itu ikut dibuang (process_image_cache_invalidate)
+ *
+ * @param request parent_inode & name memilih file
+ * @param detach  File akan dihapus: lepas semua mapping dari inode-nya supaya writeback
+ *                tidak menulis ke inode yang nanti dipakai ulang file lain
+ */
+void mmap_invalidate_file(struct EXT2DriverRequest *request, bool detach);
+
+/**
+ * Isi seluruh filesystem diganti (rollback snapshot): semua frame cache dibuang dan semua
+ * mapping dilepas dari inode-nya, seperti mmap_invalidate_file dengan detach untuk setiap file
+ */
+void mmap_invalidate_all(void);
+
+/**
+ * Banyak file dihapus sekaligus (rm -r): frame cache, page exec image cache dan mapping
+ * yang inode-nya sudah bebas di disk diperlakukan seperti mmap_invalidate_file dengan detach
+ */
+void mmap_invalidate_freed_inodes(void);
+
+#endif
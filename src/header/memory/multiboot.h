@@ -0,0 +1,57 @@
+#ifndef _MULTIBOOT_H
+#define _MULTIBOOT_H
+
+#include <stdint.h>
+
+/**
+ * Multiboot (spesifikasi 0.6.96), hanya bagian informasi memori yang dipakai kernel
+ *
+ * - Header di kernel-entrypoint.s meminta flag 1 (informasi memori), GRUB lalu mengisi mem_lower /
+ *   mem_upper dan biasanya juga memory map (MULTIBOOT_INFO_MEMORY_MAP)
+ * - Saat kernel masuk, eax = MULTIBOOT_BOOTLOADER_MAGIC dan ebx = alamat fisik struct MultibootInfo
+ */
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+#define MULTIBOOT_INFO_MEMORY 0x1
+#define MULTIBOOT_INFO_MEMORY_MAP 0x40
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+
+/**
+ * Informasi dari bootloader, field setelah mmap_addr tidak dipakai
+ *
+ * @param flags       MULTIBOOT_INFO_*, field hanya valid jika flag-nya set
+ * @param mem_lower   KiB memori di bawah 1 MiB
+ * @param mem_upper   KiB memori kontigu mulai 1 MiB
+ * @param mmap_length Ukuran buffer memory map dalam byte
+ * @param mmap_addr   Alamat fisik entry memory map pertama
+ */
+struct MultibootInfo
+{
+  uint32_t flags;
+  uint32_t mem_lower;
+  uint32_t mem_upper;
+  uint32_t boot_device;
+  uint32_t cmdline;
+  uint32_t mods_count;
+  uint32_t mods_addr;
+  uint32_t syms[4];
+  uint32_t mmap_length;
+  uint32_t mmap_addr;
+} __attribute__((packed));
+
+/**
+ * Satu range memori fisik dari memory map
+ *
+ * @param size   Ukuran entry tanpa field size ini, entry berikutnya ada di +size+4
+ * @param addr   Alamat fisik awal
+ * @param length Panjang range dalam byte
+ * @param type   MULTIBOOT_MEMORY_AVAILABLE = RAM bebas, selain itu reserved
+ */
+struct MultibootMemoryMapEntry
+{
+  uint32_t size;
+  uint64_t addr;
+  uint64_t length;
+  uint32_t type;
+} __attribute__((packed));
+
+#endif
@@ -6,14 +6,33 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "multiboot.h"
+
 // Note: MB often referring to MiB in context of memory management
-#define SYSTEM_MEMORY_MB 128
+// Ukuran memori jika bootloader tidak memberi informasi memori sama sekali
+#define PAGING_FALLBACK_MEMORY_MB 128
 
 #define PAGE_ENTRY_COUNT 1024
 // Page Frame (PF) Size: (1 << 22) B = 4*1024*1024 B = 4 MiB
 #define PAGE_FRAME_SIZE (1 << (2 + 10 + 10))
-// Maximum usable page frame. Default count: 128 / 4 = 32 page frame
-#define PAGE_FRAME_MAX_COUNT ((SYSTEM_MEMORY_MB << 20) / PAGE_FRAME_SIZE)
+// Batas page frame yang dikelola: 4 GiB tanpa PAE / PSE-36, jumlah sebenarnya dari memory map multiboot
+#define PAGE_FRAME_MAX_COUNT 1024
+// Small page (4 KiB) lewat page table 2 level, dipakai untuk memori proses
+#define PAGE_SMALL_SIZE (1 << 12)
+#define PAGE_SMALL_PER_FRAME (PAGE_FRAME_SIZE / PAGE_SMALL_SIZE)
+
+// Kernel direct map: frame fisik f terlihat di PAGING_DIRECT_MAP_BASE + f * PAGE_FRAME_SIZE (4 MiB page, kernel-only)
+// Dibatasi 255 frame karena PDE terakhir dipakai slot kmap, frame di atasnya (highmem) hanya lewat kmap
+#define PAGING_DIRECT_MAP_BASE 0xC0000000
+#define PAGING_DIRECT_MAP_FRAME_MAX 255
+
+// Ruang range memory map yang disimpan paging_init, sisanya diabaikan
+#define PAGING_MEMORY_RANGE_COUNT_MAX 32
+
+// Page fault error code (Intel Manual 3a - Figure 4-12)
+#define PAGE_FAULT_PRESENT 0x1
+#define PAGE_FAULT_WRITE 0x2
+#define PAGE_FAULT_USER 0x4
 
 // Operating system page directory, using page size PAGE_FRAME_SIZE (4 MiB)
 extern struct PageDirectory _paging_kernel_page_directory;
@@ -61,6 +80,39 @@ struct PageDirectoryEntry
   uint16_t lower_address : 10;
 } __attribute__((packed));
 
+/**
+ * Page Table Entry, for page size 4 KB.
+ * Check Intel Manual 3a - Ch 4 Paging - Figure 4-4 PTE: 4KB page
+ * PDE yang menunjuk page table (use_pagesize_4_mb = 0) menyimpan alamat fisik page table di bit 31:12
+ *
+ * @param frame_address Bits 31:12 of 4 KiB page physical address
+ */
+struct PageTableEntry
+{
+  uint32_t present_bit : 1;
+  uint32_t write_bit : 1;
+  uint32_t user_bit : 1;
+  uint32_t write_through_bit : 1;
+  uint32_t cache_disable_bit : 1;
+  uint32_t accessed_bit : 1;
+  uint32_t dirty_bit : 1;
+  uint32_t pat : 1;
+  uint32_t global_page : 1;
+  uint32_t available : 3;
+  uint32_t frame_address : 20;
+} __attribute__((packed));
+
+/**
+ * Page Table, second level of paging, covering 4 MiB with 4 KiB page.
+ * Same alignment rule as PageDirectory
+ *
+ * @param table Fixed-width array of PageTableEntry with size PAGE_ENTRY_COUNT
+ */
+struct PageTable
+{
+  volatile struct PageTableEntry table[PAGE_ENTRY_COUNT];
+} __attribute__((packed, aligned(0x1000)));
+
 /**
  * Page Directory, contain array of PageDirectoryEntry.
  * Note: This data structure is volatile (can be modified from outside this code, check "C volatile keyword").
@@ -76,18 +128,90 @@ struct PageDirectory
   volatile struct PageDirectoryEntry table[PAGE_ENTRY_COUNT];
 } __attribute__((packed, aligned(0x1000)));
 
+// Bit available PTE: page writable yang sementara dimap read-only karena dibagi dengan proses hasil fork
+#define PAGE_TABLE_ENTRY_COW 0x1
+
+// Buddy allocator: blok 2^order page 4 KiB, order maksimum = satu page frame 4 MiB
+#define PAGE_BUDDY_ORDER_MAX 10
+#define PAGE_BUDDY_NONE 0xFFFFFFFF
+// page_state: head blok bebas / terpakai menyimpan order di bit 3:0, page lain di dalam blok bernilai 0
+#define PAGE_BUDDY_FREE 0x80
+#define PAGE_BUDDY_ALLOCATED 0x40
+#define PAGE_BUDDY_USABLE 0x20 // Hanya selama paging_init: RAM yang belum masuk free list
+#define PAGE_BUDDY_ORDER_MASK 0x0F
+
+// Zone buddy, batasnya kelipatan frame sehingga blok tidak pernah melintasi zone.
+// NORMAL ada di direct map (page table, slab, page user 4 KiB), HIGH hanya dialokasikan
+// sebagai frame 4 MiB yang diakses kernel lewat kmap (page cache mmap, page user 4 MiB)
+#define PAGE_ZONE_NORMAL 0
+#define PAGE_ZONE_HIGH 1
+#define PAGE_ZONE_COUNT 2
+
 /**
- * Containing page manager states.
+ * Satu range memori fisik dari bootloader, dalam nomor page 4 KiB dan sudah dipotong ke 4 GiB
  *
- * @param page_frame_map Keeping track empty space. True when the page frame is currently used
- * ...
+ * @param start_page Page pertama
+ * @param end_page   Page akhir (eksklusif)
+ * @param usable     RAM bebas, false untuk range reserved
+ */
+struct PagingMemoryRange
+{
+  uint32_t start_page;
+  uint32_t end_page;
+  bool usable;
+};
+
+/**
+ * Containing page manager states, physical memory is managed by buddy allocator at 4 KiB granularity.
+ * Array per page ada di carve-out RAM pertama (di atas frame kernel) yang cukup besar, ukurannya
+ * mengikuti memori yang dilaporkan bootloader
+ *
+ * @param page_count             Page 4 KiB yang punya metadata, sampai akhir RAM tertinggi (kelipatan frame)
+ * @param frame_count            page_count / PAGE_SMALL_PER_FRAME
+ * @param direct_map_frame_count Frame yang terlihat di direct map, sisanya zone HIGH
+ * @param usable_page_count      Page RAM yang dikelola buddy (di luar kernel dan carve-out metadata)
+ * @param free_list_head         Per zone & order, index page head blok bebas pertama (PAGE_BUDDY_NONE jika kosong)
+ * @param free_block_count       Per zone & order, jumlah blok bebas di free list
+ * @param free_page_count        Total page 4 KiB bebas semua zone
+ * @param zone_free_page_count   Page 4 KiB bebas per zone
+ * @param page_next              Link free list (hanya berarti untuk head blok bebas)
+ * @param page_prev              Link free list (hanya berarti untuk head blok bebas)
+ * @param page_state             PAGE_BUDDY_FREE / PAGE_BUDDY_ALLOCATED | order untuk head blok
+ * @param page_share_count       Page table tambahan yang memetakan small page yang sama (fork copy-on-write),
+ *                               paging_free_small_page hanya mengurangi nilai ini selama belum 0
  */
 struct PageManagerState
 {
-  bool page_frame_map[PAGE_FRAME_MAX_COUNT];
-  uint32_t free_page_frame_count;
-  // TODO: Add if needed ...
-} __attribute__((packed));
+  uint32_t page_count;
+  uint32_t frame_count;
+  uint32_t direct_map_frame_count;
+  uint32_t usable_page_count;
+  uint32_t free_list_head[PAGE_ZONE_COUNT][PAGE_BUDDY_ORDER_MAX + 1];
+  uint32_t free_block_count[PAGE_ZONE_COUNT][PAGE_BUDDY_ORDER_MAX + 1];
+  uint32_t free_page_count;
+  uint32_t zone_free_page_count[PAGE_ZONE_COUNT];
+  uint32_t *page_next;
+  uint32_t *page_prev;
+  uint8_t *page_state;
+  uint8_t *page_share_count;
+};
+
+/**
+ * Counter TLB sejak boot. PDE direct map kernel global (CR4.PGE) sehingga reload CR3
+ * hanya membuang entry user
+ *
+ * @param cr3_load_count      Reload CR3 karena pindah page directory
+ * @param cr3_load_skip_count paging_use_page_directory ke page directory yang sudah aktif
+ * @param flush_all_count     flush_tlb_all (reload CR3 eksplisit)
+ * @param flush_single_count  flush_single_tlb (invlpg)
+ */
+struct PagingTLBStatistics
+{
+  uint32_t cr3_load_count;
+  uint32_t cr3_load_skip_count;
+  uint32_t flush_all_count;
+  uint32_t flush_single_count;
+};
 
 /**
  * Edit page directory with respective parameter
@@ -145,18 +269,205 @@ bool paging_free_user_page_frame(struct PageDirectory *page_dir, void *virtual_a
 void paging_activate(struct PageDirectory *page_dir);
 bool paging_map_user_page(struct PageDirectory *page_dir, void *virtual_addr, void *physical_addr);
 
+/* --- Frame-level helpers (mmap) --- */
+// Slot 4 MiB di ujung address space untuk akses kernel sementara ke frame fisik mana pun
+#define PAGING_KMAP_VIRTUAL_ADDR ((void *)0xFFC00000)
+
+/**
+ * Reserve one physical page frame without mapping it anywhere. Highmem frame (PAGE_ZONE_HIGH) is
+ * preferred so direct-mapped memory stays available for page table / slab, use paging_kmap_frame for access
+ *
+ * @return Frame index, -1 when there is no free frame
+ */
+int32_t paging_allocate_frame(void);
+
+/**
+ * Release physical page frame reserved by paging_allocate_frame()
+ *
+ * @param frame_index Frame to release
+ */
+void paging_free_frame(uint32_t frame_index);
+
+/**
+ * Map an existing frame as user page, the frame ownership is not changed
+ *
+ * @param page_dir     Page directory to update
+ * @param virtual_addr User virtual address
+ * @param frame_index  Physical frame index
+ * @param writable     Map with write_bit set
+ * @return             True on success
+ */
+bool paging_map_frame(struct PageDirectory *page_dir, void *virtual_addr, uint32_t frame_index, bool writable);
+
+/**
+ * Remove user page mapping without freeing its frame (shared / cached frame)
+ *
+ * @param page_dir     Page directory to update
+ * @param virtual_addr User virtual address
+ * @return             Frame index that was mapped, -1 when not mapped
+ */
+int32_t paging_unmap_user_page(struct PageDirectory *page_dir, void *virtual_addr);
+
+/**
+ * Map a frame into the kernel kmap slot of the active page directory
+ *
+ * @param frame_index Physical frame index
+ * @return            Kernel virtual address of the frame (PAGING_KMAP_VIRTUAL_ADDR)
+ */
+void *paging_kmap_frame(uint32_t frame_index);
+
+/**
+ * Clear the kmap slot of the active page directory
+ */
+void paging_kunmap_frame(void);
+
+/* --- 4 KiB page helpers --- */
+/**
+ * Read the bootloader memory map, fill kernel page directory with direct map of physical frame
+ * and build the buddy allocator from usable RAM, call once before any memory is allocated
+ *
+ * @param multiboot_info Multiboot information (kernel virtual address), NULL uses mem 0 .. PAGING_FALLBACK_MEMORY_MB
+ */
+void paging_init(struct MultibootInfo *multiboot_info);
+
+/**
+ * Kernel virtual address of physical address through the direct map
+ *
+ * @param physical_addr Physical address inside the direct map (zone PAGE_ZONE_NORMAL)
+ * @return              Kernel virtual address
+ */
+void *paging_physical_to_virtual(uint32_t physical_addr);
+
+/**
+ * Physical address of kernel virtual address inside the direct map
+ *
+ * @param virtual_addr Kernel virtual address from paging_physical_to_virtual
+ * @return             Physical address
+ */
+uint32_t paging_virtual_to_physical(void *virtual_addr);
+
+/**
+ * Reserve 2^order physically contiguous 4 KiB page, aligned to the block size. O(PAGE_BUDDY_ORDER_MAX).
+ * Always from PAGE_ZONE_NORMAL so the block is reachable through paging_physical_to_virtual
+ *
+ * @param order Block order, 0 (4 KiB) until PAGE_BUDDY_ORDER_MAX (4 MiB)
+ * @return      Physical address of the block, 0 when there is no free block large enough
+ */
+uint32_t paging_buddy_allocate(uint8_t order);
+
+/**
+ * Release block from paging_buddy_allocate(), coalesced with its free buddy up to PAGE_BUDDY_ORDER_MAX
+ *
+ * @param physical_addr Physical address returned by paging_buddy_allocate
+ */
+void paging_buddy_free(uint32_t physical_addr);
+
+/**
+ * Reserve one physical 4 KiB page (buddy block order 0)
+ *
+ * @return Physical address of the page, 0 when out of memory
+ */
+uint32_t paging_allocate_small_page(void);
+
+/**
+ * Release physical 4 KiB page reserved by paging_allocate_small_page()
+ *
+ * @param physical_addr Physical address of the page
+ */
+void paging_free_small_page(uint32_t physical_addr);
+
+/**
+ * Map physical 4 KiB page as user page, page table is allocated when the 4 MiB region has none yet
+ *
+ * @param page_dir      Page directory to update
+ * @param virtual_addr  User virtual address, 4 KiB aligned
+ * @param physical_addr Physical 4 KiB page
+ * @param writable      Map with write_bit set
+ * @return              False when the region is covered by a 4 MiB page or no memory for page table
+ */
+bool paging_map_small_page(struct PageDirectory *page_dir, void *virtual_addr, uint32_t physical_addr, bool writable);
+
+/**
+ * Remove 4 KiB user page mapping without freeing the page, the page table is kept
+ *
+ * @param page_dir     Page directory to update
+ * @param virtual_addr User virtual address
+ * @return             Physical address that was mapped, 0 when not mapped
+ */
+uint32_t paging_unmap_small_page(struct PageDirectory *page_dir, void *virtual_addr);
+
+/**
+ * Map 4 KiB page owned by someone else (exec image cache) read-only and take one share reference,
+ * released again by paging_free_small_page when the page directory is freed
+ *
+ * @param page_dir       Page directory to update
+ * @param virtual_addr   User virtual address, 4 KiB aligned
+ * @param physical_addr  Physical 4 KiB page
+ * @param copy_on_write  Tag with PAGE_TABLE_ENTRY_COW so the first write gets a private copy
+ * @return               False when out of memory for page table or share count is saturated
+ */
+bool paging_map_shared_small_page(struct PageDirectory *page_dir, void *virtual_addr, uint32_t physical_addr,
+                                  bool copy_on_write);
+
+/**
+ * Number of share references (page table other than the owner) of a 4 KiB page
+ *
+ * @param physical_addr Physical 4 KiB page
+ * @return              0 when only the owner uses the page
+ */
+uint8_t paging_get_small_page_share_count(uint32_t physical_addr);
+
+/**
+ * Physical address of 4 KiB user page mapped at virtual_addr
+ *
+ * @param page_dir     Page directory to inspect
+ * @param virtual_addr User virtual address
+ * @return             Physical address of the page, 0 when not mapped
+ */
+uint32_t paging_get_user_small_page(struct PageDirectory *page_dir, void *virtual_addr);
+
+/**
+ * Allocate zeroed 4 KiB page and map it writable at virtual_addr. Already mapped page is left as is
+ *
+ * @param page_dir     Page directory to update
+ * @param virtual_addr User virtual address
+ * @return             True on success
+ */
+bool paging_allocate_user_small_page(struct PageDirectory *page_dir, void *virtual_addr);
+
 /* --- Process-related Memory Management --- */
-#define PAGING_DIRECTORY_TABLE_MAX_COUNT 32
 
 /**
- * Create new page directory prefilled with 1 page directory entry for kernel higher half mapping
+ * Share every 4 KiB user page of src with dst for fork. Writable page become read-only + PAGE_TABLE_ENTRY_COW
+ * in both directory, page table is copied but page content is not. 4 MiB page (mmap) is not cloned
+ *
+ * @param dst Empty page directory from paging_create_new_page_directory()
+ * @param src Source page directory, TLB is flushed when src is the active directory
+ * @return    False when out of memory for page table, dst must be released by paging_free_page_directory
+ */
+bool paging_clone_user_pages(struct PageDirectory *dst, struct PageDirectory *src);
+
+/**
+ * Resolve write fault on PAGE_TABLE_ENTRY_COW page: copy the page when still shared,
+ * otherwise the last owner gets write access back without copy
+ *
+ * @param page_dir     Page directory of the faulting process
+ * @param virtual_addr Faulting user virtual address
+ * @return             False when the page is not copy-on-write or out of memory
+ */
+bool paging_handle_cow_fault(struct PageDirectory *page_dir, void *virtual_addr);
+
+/**
+ * Create new page directory (one 4 KiB page from the buddy allocator) prefilled with kernel
+ * higher half mapping (direct map)
  *
  * @return Pointer to page directory virtual address. Return NULL if allocation failed
  */
 struct PageDirectory *paging_create_new_page_directory(void);
 
 /**
- * Free page directory and delete all page directory entry
+ * Free page directory and delete all page directory entry. User 4 MiB page, 4 KiB page and
+ * page table referenced by the directory are released too
  *
  * @param page_dir Pointer to page directory virtual address
  * @return         True if free operation success
@@ -175,8 +486,16 @@ struct PageDirectory *paging_get_current_page_directory_addr(void);
  * Change active page directory (indirectly trigger TLB flush for all non-global entry)
  *
  * @note                        Assuming page directories lives in kernel memory
+ * @note                        CR3 tidak di-reload jika page directory sudah aktif
  * @param page_dir_virtual_addr Page directory virtual address to switch into
  */
 void paging_use_page_directory(struct PageDirectory *page_dir_virtual_addr);
 
+/**
+ * Salin counter TLB sejak boot
+ *
+ * @param statistics Tujuan salinan
+ */
+void paging_get_tlb_statistics(struct PagingTLBStatistics *statistics);
+
 #endif
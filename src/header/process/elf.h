@@ -0,0 +1,74 @@
+#ifndef _ELF_H
+#define _ELF_H
+
+#include <stdint.h>
+
+/**
+ * ELF32 executable, hanya field yang dipakai loader (System V ABI, i386 supplement)
+ *
+ * - Program header PT_LOAD dicadangkan sebagai region proses, tidak ada byte yang dibaca saat exec
+ * - Page di [p_vaddr, p_vaddr + p_filesz) diisi dari file saat page fault pertama, sisa sampai
+ *   p_vaddr + p_memsz (bss) di-zero-fill
+ */
+#define ELF_MAGIC 0x464C457F // "\x7FELF" dibaca little endian
+#define ELF_CLASS_32 1
+#define ELF_DATA_LSB 1
+#define ELF_TYPE_EXEC 2
+#define ELF_MACHINE_386 3
+#define ELF_PROGRAM_HEADER_COUNT_MAX 8
+
+#define ELF_PT_LOAD 1
+#define ELF_PF_X 0x1
+#define ELF_PF_W 0x2
+#define ELF_PF_R 0x4
+
+/**
+ * ELF32 file header
+ *
+ * @param e_ident     Magic, class, data encoding, version
+ * @param e_entry     Virtual address entrypoint
+ * @param e_phoff     Offset file tabel program header
+ * @param e_phentsize Ukuran satu program header
+ * @param e_phnum     Jumlah program header
+ */
+struct ELF32Header
+{
+  uint8_t e_ident[16];
+  uint16_t e_type;
+  uint16_t e_machine;
+  uint32_t e_version;
+  uint32_t e_entry;
+  uint32_t e_phoff;
+  uint32_t e_shoff;
+  uint32_t e_flags;
+  uint16_t e_ehsize;
+  uint16_t e_phentsize;
+  uint16_t e_phnum;
+  uint16_t e_shentsize;
+  uint16_t e_shnum;
+  uint16_t e_shstrndx;
+} __attribute__((packed));
+
+/**
+ * ELF32 program header
+ *
+ * @param p_type   ELF_PT_*, loader hanya memproses ELF_PT_LOAD
+ * @param p_offset Offset file awal segment
+ * @param p_vaddr  Virtual address awal segment
+ * @param p_filesz Byte segment yang ada di file
+ * @param p_memsz  Byte segment di memori, sisa setelah p_filesz adalah bss
+ * @param p_flags  ELF_PF_*
+ */
+struct ELF32ProgramHeader
+{
+  uint32_t p_type;
+  uint32_t p_offset;
+  uint32_t p_vaddr;
+  uint32_t p_paddr;
+  uint32_t p_filesz;
+  uint32_t p_memsz;
+  uint32_t p_flags;
+  uint32_t p_align;
+} __attribute__((packed));
+
+#endif
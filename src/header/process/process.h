@@ -8,11 +8,32 @@
 
 #include "../cpu/interrupt.h"
 #include "../memory/paging.h"
+#include "../memory/mmap.h"
 #include "../filesystem/ext2.h"
 
 #define PROCESS_NAME_LENGTH_MAX 32
-#define PROCESS_PAGE_FRAME_COUNT_MAX 8
-#define PROCESS_COUNT_MAX 16
+// Stack user dicadangkan tepat di bawah PROCESS_USER_STACK_TOP, page 4 KiB dialokasikan saat disentuh
+#define PROCESS_USER_STACK_TOP 0x400000
+#define PROCESS_USER_STACK_SIZE 0x40000
+// Region virtual yang dicadangkan per proses, page 4 KiB baru dialokasikan (zero-fill / isi file) saat page fault
+// pertama. Cukup untuk stack + semua PT_LOAD satu executable ELF + heap + beberapa mmap anonymous
+#define PROCESS_REGION_COUNT_MAX 16
+
+// Jenis region, hanya heap (brk) dan mmap anonymous yang boleh berubah / dilepas selama proses berjalan
+#define PROCESS_REGION_FIXED 0
+#define PROCESS_REGION_HEAP 1
+#define PROCESS_REGION_ANONYMOUS 2
+
+// Heap dimulai di page setelah image (paling rendah PROCESS_USER_STACK_TOP) dan tumbuh sampai MMAP_REGION_START.
+// mmap anonymous memakai page 4 KiB di range sendiri, terpisah dari PDE 4 MiB milik mmap file
+#define PROCESS_ANONYMOUS_MMAP_START 0x40000000
+#define PROCESS_ANONYMOUS_MMAP_END 0x80000000
+
+// Exec image cache: page file executable dibagi per (inode, alamat virtual page), hash table dengan bucket ini
+#define PROCESS_IMAGE_CACHE_BUCKET_COUNT 64
+
+// Slot PCB hanya berisi pointer, PCB sendiri dialokasikan dari object cache "pcb"
+#define PROCESS_COUNT_MAX 64
 
 #define KERNEL_RESERVED_PAGE_FRAME_COUNT 4
 #define KERNEL_VIRTUAL_ADDRESS_BASE 0xC0000000
@@ -55,6 +76,30 @@ typedef enum PROCESS_STATE
 
 // ================================================NEW=============================================
 
+/**
+ * Region virtual milik proses untuk demand paging, tidak ada page fisik sampai alamatnya diakses
+ *
+ * @param start       Alamat awal, aligned PAGE_SMALL_SIZE
+ * @param end         Alamat akhir (eksklusif), aligned PAGE_SMALL_SIZE, 0 = slot kosong
+ * @param writable    Page dimap writable, write ke region read-only menghentikan proses
+ * @param inode       File sumber isi region (segment PT_LOAD), 0 = anonymous zero-fill
+ * @param file_start  Alamat virtual byte pertama yang berasal dari file
+ * @param file_end    Alamat virtual akhir data file (eksklusif), [file_end, end) adalah bss
+ * @param file_offset Offset file untuk file_start
+ * @param type        PROCESS_REGION_*
+ */
+struct ProcessMemoryRegion
+{
+  uint32_t start;
+  uint32_t end;
+  bool writable;
+  uint8_t type;
+  uint32_t inode;
+  uint32_t file_start;
+  uint32_t file_end;
+  uint32_t file_offset;
+};
+
 /**
  * Contain information needed for task to be able to get interrupted and resumed later
  *
@@ -76,7 +121,7 @@ struct Context
  *
  * @param metadata Process metadata, contain various information about process
  * @param context  Process context used for context saving & switching
- * @param memory   Memory used for the process
+ * @param memory   Memory used for the process, mappings is the mmap table (see mmap.h)
  */
 struct ProcessControlBlock
 {
@@ -92,12 +137,15 @@ struct ProcessControlBlock
 
   struct
   {
-    void *virtual_addr_used[PROCESS_PAGE_FRAME_COUNT_MAX];
-    uint32_t page_frame_used_count;
+    uint32_t page_used_count;  // Page 4 KiB resident (sudah disentuh) di region proses
+    uint32_t page_fault_count; // Page fault demand paging yang berhasil ditangani
+    uint32_t heap_break;       // Program break, region heap berakhir di page setelahnya
+    struct ProcessMemoryRegion regions[PROCESS_REGION_COUNT_MAX];
+    struct MemoryMapping mappings[PROCESS_MMAP_COUNT_MAX];
   } memory;
 };
 
-extern struct ProcessControlBlock _process_list[PROCESS_COUNT_MAX];
+extern struct ProcessControlBlock *_process_list[PROCESS_COUNT_MAX];
 
 struct ProcessState
 {
@@ -115,6 +163,24 @@ extern struct ProcessState process_manager_state;
  */
 struct ProcessControlBlock *process_get_current_running_pcb_pointer(void);
 
+/**
+ * Find PCB that owns page directory, including process that is still being loaded
+ *
+ * @param page_dir Page directory (usually the active one)
+ * @return         NULL if no process uses page_dir
+ */
+struct ProcessControlBlock *process_get_pcb_by_page_directory(struct PageDirectory *page_dir);
+
+/**
+ * Demand paging: allocate zeroed 4 KiB page when fault_addr is inside a reserved region of the process
+ *
+ * @param pcb        Process owning the active page directory
+ * @param fault_addr Faulting address (CR2)
+ * @param error_code Page fault error code
+ * @return           False on illegal access (outside region, write to read-only, protection) or out of memory
+ */
+bool process_handle_page_fault(struct ProcessControlBlock *pcb, uint32_t fault_addr, uint32_t error_code);
+
 void getActivePCB(struct ProcessControlBlock *ptr, int *count);
 
 /**
@@ -127,6 +193,68 @@ void getActivePCB(struct ProcessControlBlock *ptr, int *count);
  */
 int32_t process_create_user_process(struct EXT2DriverRequest request);
 
+/**
+ * Duplicate the running process. Child page directory shares every 4 KiB user page read-only
+ * (copy-on-write), mmap mappings are not inherited
+ *
+ * @param context Register state of the parent at the fork syscall, child resumes from it
+ * @return        Child PID, -1 when process table or memory is exhausted
+ */
+int32_t process_fork(struct Context context);
+
+/**
+ * Drop exec image cache pages of a file whose content changed. Pages already mapped by running
+ * processes stay valid until those processes exit
+ *
+ * @param inode File inode, 0 drops the whole cache (filesystem rollback)
+ */
+void process_image_cache_invalidate(uint32_t inode);
+
+/**
+ * Drop exec image cache pages of every file whose inode is no longer used on disk, for deletes
+ * that free many inodes at once (rm -r). A new file on a reused inode number never gets them
+ */
+void process_image_cache_invalidate_freed(void);
+
+/**
+ * Fill every not-present file-backed page of the running process in [addr, addr + size) before the kernel
+ * writes there from inside ext2, so the page fault handler never re-enters the filesystem / disk driver
+ *
+ * @param addr User buffer
+ * @param size Buffer size in bytes
+ */
+void process_prefault_user_buffer(void *addr, uint32_t size);
+
+/**
+ * Move program break of the running process. Heap pages are allocated on first touch,
+ * pages above the new break are released when the heap shrinks
+ *
+ * @param pcb       Running process
+ * @param new_break New program break, 0 only queries the current one
+ * @return          Program break after the call, unchanged when new_break is outside the heap range
+ */
+uint32_t process_brk(struct ProcessControlBlock *pcb, uint32_t new_break);
+
+/**
+ * Reserve anonymous zero-filled region in [PROCESS_ANONYMOUS_MMAP_START, PROCESS_ANONYMOUS_MMAP_END),
+ * no page is allocated until touched
+ *
+ * @param pcb      Running process
+ * @param size     Length in bytes, rounded up to PAGE_SMALL_SIZE
+ * @param writable Map pages writable (MMAP_PROT_WRITE)
+ * @return         Region start address, NULL when size is 0, no free region slot or no address range
+ */
+void *process_mmap_anonymous(struct ProcessControlBlock *pcb, uint32_t size, bool writable);
+
+/**
+ * Release anonymous region and all its touched pages
+ *
+ * @param pcb  Running process, its page directory must be active
+ * @param addr Address returned by process_mmap_anonymous
+ * @return     0 success - 1 no anonymous region starts at addr
+ */
+int8_t process_munmap_anonymous(struct ProcessControlBlock *pcb, void *addr);
+
 /**
  * Destroy process then release page directory and process control block
  *
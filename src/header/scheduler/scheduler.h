@@ -13,6 +13,20 @@
  */
 __attribute__((noreturn)) extern void process_context_switch(struct Context ctx);
 
+/**
+ * Statistik context switch untuk syscall schedstat
+ *
+ * @param switch_count       scheduler_switch_to_next_process sejak boot
+ * @param same_process_count Switch yang kembali ke proses yang sama (CR3 tidak di-reload)
+ * @param tlb                Counter TLB dari paging_get_tlb_statistics
+ */
+struct SchedulerStatistics
+{
+  uint32_t switch_count;
+  uint32_t same_process_count;
+  struct PagingTLBStatistics tlb;
+};
+
 /* --- Scheduler --- */
 /**
  * Initialize scheduler before executing init process
@@ -31,4 +45,11 @@ void scheduler_save_context_to_current_running_pcb(struct Context ctx);
  */
 __attribute__((noreturn)) void scheduler_switch_to_next_process(void);
 
+/**
+ * Salin statistik context switch dan TLB
+ *
+ * @param statistics Tujuan salinan
+ */
+void scheduler_get_statistics(struct SchedulerStatistics *statistics);
+
 #endif
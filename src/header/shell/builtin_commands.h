@@ -7,6 +7,8 @@
 #include "header/stdlib/string.h"
 #include "header/filesystem/ext2.h"
 #include "header/process/process.h"
+#include "header/memory/kmalloc.h"
+#include "header/scheduler/scheduler.h"
 #include "header/driver/speaker.h"
 
 extern char current_working_directory[256]; // Assuming MAX_PATH_LENGTH from user-shell.c
@@ -18,8 +20,16 @@ void handle_mkdir(const char* name);
 void handle_cat(const char* filename);
 int8_t handle_cp(const char* source, const char* destination);
 void handle_rm(const char *path);
+void handle_rm_recursive(const char *path);
+void handle_chattr(const char* mode, const char* path);
 void handle_mv(const char* source, const char* destination);
 void handle_find(const char* name);
+void handle_df();
+void handle_dedup();
+void handle_snapshot(const char* action);
+void handle_slabinfo();
+void handle_fork();
+void handle_schedstat();
 void handle_help();
 void handle_clear();
 void handle_exec(const char* filename);
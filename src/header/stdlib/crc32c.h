@@ -0,0 +1,30 @@
+#ifndef _CRC32C_H
+#define _CRC32C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * CRC32C (Castagnoli, polynomial 0x1EDC6F41 / reflected 0x82F63B78),
+ * checksum yang sama dengan metadata_csum ext4 dan instruksi SSE4.2 crc32
+ */
+
+/**
+ * Lanjutkan perhitungan CRC32C. Nilai awal biasanya ~0 (0xFFFFFFFF) dan hasil
+ * akhir tidak di-invert, sama seperti ext4_chksum(). Memakai instruksi crc32
+ * jika CPUID melaporkan SSE4.2, selain itu tabel slicing-by-8
+ *
+ * @param crc  CRC sebelumnya (atau seed)
+ * @param buf  Data
+ * @param size Ukuran data dalam byte
+ *
+ * @return CRC baru
+ */
+uint32_t crc32c(uint32_t crc, const void *buf, uint32_t size);
+
+/**
+ * @return true jika crc32c() memakai instruksi SSE4.2
+ */
+bool crc32c_hw_enabled(void);
+
+#endif
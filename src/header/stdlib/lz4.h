@@ -0,0 +1,36 @@
+#ifndef _LZ4_H
+#define _LZ4_H
+
+#include <stdint.h>
+
+/**
+ * LZ4 block format (tanpa frame header), kompatibel dengan LZ4_compress_default()
+ * dan LZ4_decompress_safe() milik liblz4. Dipakai ext2 untuk cluster terkompresi.
+ */
+
+/**
+ * Kompresi src ke dst memakai greedy hash matching
+ *
+ * @param src          Data asli
+ * @param src_size     Ukuran data asli dalam byte (maksimum 64 KiB)
+ * @param dst          Buffer tujuan
+ * @param dst_capacity Ukuran buffer tujuan dalam byte
+ *
+ * @return Ukuran hasil kompresi, 0 jika hasil tidak muat di dst_capacity
+ */
+uint32_t lz4_compress(const void *src, uint32_t src_size, void *dst, uint32_t dst_capacity);
+
+/**
+ * Dekompresi satu LZ4 block, semua offset & panjang divalidasi sehingga
+ * data rusak tidak pernah menulis di luar dst
+ *
+ * @param src          Data terkompresi
+ * @param src_size     Ukuran data terkompresi dalam byte
+ * @param dst          Buffer tujuan
+ * @param dst_capacity Ukuran buffer tujuan dalam byte
+ *
+ * @return Ukuran hasil dekompresi, -1 jika data rusak atau tidak muat
+ */
+int32_t lz4_decompress(const void *src, uint32_t src_size, void *dst, uint32_t dst_capacity);
+
+#endif
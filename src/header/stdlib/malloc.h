@@ -0,0 +1,64 @@
+#ifndef _MALLOC_H
+#define _MALLOC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Heap user-space (runtime shell)
+ *
+ * - Size class 16 .. MALLOC_SMALL_SIZE_MAX: free list LIFO per class (gaya thread cache), object diambil
+ *   dan dikembalikan tanpa syscall. Free list yang kosong diisi sekaligus MALLOC_REFILL_BATCH object
+ *   dari span MALLOC_SPAN_SIZE hasil sbrk
+ * - Lebih besar: mmap anonymous sendiri, dikembalikan ke kernel saat free
+ * - Setiap blok diawali header 8 byte (class + kapasitas) sehingga free tidak perlu ukuran dan
+ *   pointer hasil malloc selalu aligned 8
+ */
+#define MALLOC_SIZE_CLASS_COUNT 14
+#define MALLOC_SMALL_SIZE_MAX 2048
+#define MALLOC_SPAN_SIZE 0x4000
+#define MALLOC_REFILL_BATCH 32
+#define MALLOC_CLASS_LARGE 0xFFFFFFFF
+
+/**
+ * Program break relatif (syscall 47)
+ *
+ * @param increment Byte yang ditambahkan ke break, boleh negatif
+ * @return          Break lama, NULL jika heap tidak bisa diubah
+ */
+void *sbrk(int32_t increment);
+
+/**
+ * C standard malloc
+ *
+ * @param size Ukuran dalam byte
+ * @return     Pointer aligned 8, NULL jika size 0 atau memori habis
+ */
+void *malloc(size_t size);
+
+/**
+ * C standard calloc, memori selalu di-zero
+ *
+ * @param count Jumlah elemen
+ * @param size  Ukuran satu elemen
+ * @return      Pointer aligned 8, NULL jika overflow atau memori habis
+ */
+void *calloc(size_t count, size_t size);
+
+/**
+ * C standard realloc, blok yang masih cukup dipakai ulang tanpa salinan
+ *
+ * @param ptr  Pointer dari malloc, NULL sama dengan malloc(size)
+ * @param size Ukuran baru, 0 sama dengan free(ptr)
+ * @return     Pointer baru, NULL jika memori habis (ptr tetap valid)
+ */
+void *realloc(void *ptr, size_t size);
+
+/**
+ * C standard free, NULL diabaikan
+ *
+ * @param ptr Pointer dari malloc / calloc / realloc
+ */
+void free(void *ptr);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef _XXHASH_H
+#define _XXHASH_H
+
+#include <stdint.h>
+
+/**
+ * xxHash64 (Yann Collet), hash non-kriptografis yang cepat untuk mengenali blok
+ * data yang isinya sama (dedup). Hasil sama dengan XXH64() referensi sehingga
+ * bisa dicek dengan xxhsum -H1
+ */
+
+/**
+ * Hitung xxHash64 dari buffer
+ *
+ * @param buf  Data
+ * @param size Ukuran data dalam byte
+ * @param seed Seed, 0 untuk hasil standar
+ *
+ * @return Hash 64-bit
+ */
+uint64_t xxh64(const void *buf, uint32_t size, uint64_t seed);
+
+#endif
@@ -7,6 +7,9 @@
 #include "header/text/framebuffer.h"
 #include "header/driver/cmos.h"
 #include "header/process/process.h"
+#include "header/memory/mmap.h"
+#include "header/memory/kmalloc.h"
+#include "header/scheduler/scheduler.h"
 
 struct TSSEntry _interrupt_tss_entry = {
     .ss0 = GDT_KERNEL_DATA_SEGMENT_SELECTOR,
@@ -81,6 +84,26 @@ void main_interrupt_handler(struct InterruptFrame frame)
   {
     uint32_t cr2;
     __asm__ volatile("mov %%cr2, %0" : "=r"(cr2));
+
+    // Cari pemilik page directory aktif, bisa juga proses yang sedang dimuat (kernel menulis image).
+    // Fault di region mmap diisi dari file / copy-on-write, fault di region proses di-zero-fill lalu instruksi diulang
+    struct PageDirectory *page_dir = paging_get_current_page_directory_addr();
+    struct ProcessControlBlock *pcb = process_get_pcb_by_page_directory(page_dir);
+    uint32_t error_code = frame.int_stack.error_code;
+    if (pcb != NULL && (mmap_handle_page_fault(page_dir, pcb->memory.mappings, cr2, error_code) ||
+                        process_handle_page_fault(pcb, cr2, error_code)))
+      break;
+
+    // Akses ilegal dari proses yang berjalan (user mode, atau syscall dengan pointer user yang salah):
+    // hanya proses itu yang dihentikan, lalu pindah ke proses berikutnya tanpa kembali ke instruksi yang fault
+    if (pcb != NULL && pcb == process_get_current_running_pcb_pointer() &&
+        ((error_code & PAGE_FAULT_USER) || cr2 < KERNEL_VIRTUAL_ADDRESS_BASE))
+    {
+      process_destroy(pcb->metadata.pid);
+      scheduler_switch_to_next_process();
+    }
+
+    // Fault di kernel sendiri: tidak bisa dipulihkan
     framebuffer_write(5, 0, 'F', 0xF, 0x0); // F for Fault
     framebuffer_write(6, 0, ((cr2 >> 24) & 0xF) + '0', 0xF, 0x0);
     framebuffer_write(7, 0, ((cr2 >> 20) & 0xF) + '0', 0xF, 0x0);
@@ -124,849 +147,14 @@ struct rtc_time
 };
 
 struct Time get_cmos_time();
-int8_t copy_file(struct EXT2DriverRequest *src_request, struct EXT2DriverRequest *dst_request) {
-    // Validasi input parameter
-    if (!src_request || !dst_request) {
-        return -1; // Invalid parameters
-    }
-    
-    if (src_request->name_len == 0 || dst_request->name_len == 0) {
-        return -1; // Invalid file names
-    }
-    
-    // 1. Cari source file dalam parent directory
-    struct EXT2Inode parent_inode;
-    read_inode(src_request->parent_inode, &parent_inode);
-    
-    // Pastikan parent adalah directory
-    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
-        return -1; // Parent is not a directory
-    }
-    
-    uint8_t dir_block[BLOCK_SIZE];
-    uint32_t source_inode_idx = 0;
-    bool source_found = false;
-    
-    // Cari source file
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            // Bandingkan nama dengan source
-            char *entry_name = (char *)(entry + 1);
-            if (entry->name_len == src_request->name_len) {
-                bool names_match = true;
-                for (uint8_t i = 0; i < entry->name_len; i++) {
-                    if (entry_name[i] != src_request->name[i]) {
-                        names_match = false;
-                        break;
-                    }
-                }
-                if (names_match) {
-                    source_inode_idx = entry->inode;
-                    source_found = true;
-                    
-                    // Pastikan source bukan directory
-                    if (entry->file_type == EXT2_FT_DIR) {
-                        return -3; // Cannot copy directory
-                    }
-                    break;
-                }
-            }
-            
-            offset += entry->rec_len;
-        }
-        
-        if (source_found) break;
-    }
-    
-    if (!source_found) {
-        return -1; // Source file not found
-    }
-    
-    // 2. Cek apakah destination file sudah ada
-    bool dest_exists = false;
-    
-    // Reset untuk pencarian destination
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            // Bandingkan nama dengan destination
-            char *entry_name = (char *)(entry + 1);
-            if (entry->name_len == dst_request->name_len) {
-                bool names_match = true;
-                for (uint8_t i = 0; i < entry->name_len; i++) {
-                    if (entry_name[i] != dst_request->name[i]) {
-                        names_match = false;
-                        break;
-                    }
-                }
-                if (names_match) {
-                    dest_exists = true;
-                    break;
-                }
-            }
-            
-            offset += entry->rec_len;
-        }
-        
-        if (dest_exists) break;
-    }
-    
-    if (dest_exists) {
-        return -2; // Destination already exists
-    }
-    
-    // 3. Baca source file inode dan data
-    struct EXT2Inode source_inode;
-    read_inode(source_inode_idx, &source_inode);
-    
-    // Pastikan source adalah file reguler
-    if (source_inode.i_mode & EXT2_S_IFDIR) {
-        return -3; // Source is a directory
-    }
-    
-    // 4. Alokasi inode baru untuk destination
-    uint32_t new_inode_idx = allocate_node();
-    if (new_inode_idx == 0) {
-        return -4; // Failed to allocate inode
-    }
-    
-    // 5. Copy source inode properties ke destination inode
-    struct EXT2Inode dest_inode;
-    // Copy semua properties dari source
-    for (int i = 0; i < (int)sizeof(struct EXT2Inode); i++) {
-        ((uint8_t*)&dest_inode)[i] = ((uint8_t*)&source_inode)[i];
-    }
-    
-    // Reset block pointers untuk destination
-    for (int i = 0; i < 15; i++) {
-        dest_inode.i_block[i] = 0;
-    }
-    
-    // 6. Copy data blocks dari source ke destination
-    uint32_t blocks_to_copy = (source_inode.i_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
-    if (blocks_to_copy > source_inode.i_blocks) {
-        blocks_to_copy = source_inode.i_blocks;
-    }
-    
-    uint8_t file_block[BLOCK_SIZE];
-    uint32_t bgd_idx = inode_to_bgd(new_inode_idx);
-    
-    for (uint32_t i = 0; i < blocks_to_copy && i < 12; i++) { // Direct blocks only
-        if (source_inode.i_block[i] == 0) continue;
-        
-        // Alokasi block baru untuk destination
-        int32_t new_block = allocate_block(bgd_idx);
-        if (new_block < 0) {
-            // Cleanup: dealokasi inode dan blocks yang sudah dialokasi
-            clear_inode_used(new_inode_idx);
-            for (uint32_t j = 0; j < i; j++) {
-                if (dest_inode.i_block[j] != 0) {
-                    set_block_free(dest_inode.i_block[j]);
-                }
-            }
-            return -5; // Failed to allocate blocks
-        }
-        
-        // Copy data dari source block ke destination block
-        read_blocks(file_block, source_inode.i_block[i], 1);
-        write_blocks(file_block, new_block, 1);
-        
-        dest_inode.i_block[i] = new_block;
-    }
-    
-    // 7. Sync destination inode ke disk
-    sync_node(&dest_inode, new_inode_idx);
-    
-    // 8. Tambahkan entry untuk destination file ke parent directory
-    bool entry_added = false;
-    
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        struct EXT2DirectoryEntry *last_entry = NULL;
-        
-        // Cari entry terakhir dalam block
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            last_entry = entry;
-            offset += entry->rec_len;
-        }
-        
-        if (last_entry) {
-            // Hitung space yang dibutuhkan untuk entry baru
-            uint16_t new_entry_size = get_entry_record_len(dst_request->name_len);
-            uint16_t actual_last_size = get_entry_record_len(last_entry->name_len);
-            uint16_t available_space = last_entry->rec_len - actual_last_size;
-            
-            if (available_space >= new_entry_size) {
-                // Ada cukup space, buat entry baru
-                uint32_t last_entry_offset = (uint8_t*)last_entry - dir_block;
-                
-                // Sesuaikan rec_len dari entry terakhir
-                last_entry->rec_len = actual_last_size;
-                
-                // Buat entry baru
-                uint32_t new_entry_offset = last_entry_offset + actual_last_size;
-                struct EXT2DirectoryEntry *new_entry = (struct EXT2DirectoryEntry *)(dir_block + new_entry_offset);
-                
-                new_entry->inode = new_inode_idx;
-                new_entry->name_len = dst_request->name_len;
-                new_entry->file_type = EXT2_FT_REG_FILE; // Regular file
-                new_entry->rec_len = BLOCK_SIZE - new_entry_offset; // Sisa space di block
-                
-                // Copy nama destination
-                char *new_name_ptr = (char *)(new_entry + 1);
-                for (uint8_t i = 0; i < dst_request->name_len; i++) {
-                    new_name_ptr[i] = dst_request->name[i];
-                }
-                
-                // Tulis block yang sudah dimodifikasi
-                write_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-                entry_added = true;
-                break;
-            }
-        }
-    }
-    
-    if (!entry_added) {
-        // Cleanup jika gagal menambahkan entry
-        clear_inode_used(new_inode_idx);
-        for (uint32_t i = 0; i < blocks_to_copy && i < 12; i++) {
-            if (dest_inode.i_block[i] != 0) {
-                set_block_free(dest_inode.i_block[i]);
-            }
-        }
-        return -8; // Parent directory full
-    }
-    
-    // 9. Sync parent directory dan superblock
-    sync_node(&parent_inode, src_request->parent_inode);
-    sync_superblock();
-    
-    return 0; // Success
-}
-int8_t create_directory(struct EXT2DriverRequest *request) {
-    // Validasi input parameter
-    if (!request || request->name_len == 0) {
-        return -1; // Invalid parameter
-    }
-    
-    // 1. Validasi parent directory exists dan valid
-    struct EXT2Inode parent_inode;
-    read_inode(request->parent_inode, &parent_inode);
-    
-    // Pastikan parent adalah directory
-    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
-        return -2; // Parent is not a directory
-    }
-    
-    // 2. Cek apakah file/directory dengan nama yang sama sudah ada
-    // Baca directory entries secara manual untuk pengecekan yang lebih akurat
-    uint8_t dir_block[BLOCK_SIZE];
-    bool name_exists = false;
-    
-    // Periksa setiap block dari parent directory
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            // Bandingkan nama
-            char *entry_name = (char *)(entry + 1);
-            if (entry->name_len == request->name_len) {
-                bool names_match = true;
-                for (uint8_t i = 0; i < entry->name_len; i++) {
-                    if (entry_name[i] != request->name[i]) {
-                        names_match = false;
-                        break;
-                    }
-                }
-                if (names_match) {
-                    name_exists = true;
-                    break;
-                }
-            }
-            
-            offset += entry->rec_len;
-        }
-        
-        if (name_exists) break;
-    }
-    
-    if (name_exists) {
-        return -3; // Directory/file already exists
-    }
-    
-    // 3. Alokasi inode baru untuk directory
-    uint32_t new_inode_idx = allocate_node();
-    if (new_inode_idx == 0) {
-        return -4; // Failed to allocate inode
-    }
-    
-    // 4. Initialize inode untuk directory
-    struct EXT2Inode new_dir_inode;
-    // Clear semua field terlebih dahulu
-    for (int i = 0; i < (int)sizeof(struct EXT2Inode); i++) {
-        ((uint8_t*)&new_dir_inode)[i] = 0;
-    }
-
-    // Set directory properties
-    new_dir_inode.i_mode = EXT2_S_IFDIR; // Set sebagai directory
-    new_dir_inode.i_size = BLOCK_SIZE; // Ukuran minimal directory (1 block)
-    new_dir_inode.i_blocks = 1; // Menggunakan 1 block
-    
-    // 5. Alokasi block untuk directory entries
-    uint32_t bgd_idx = inode_to_bgd(new_inode_idx);
-    int32_t new_block = allocate_block(bgd_idx);
-    if (new_block < 0) {
-        // Gagal alokasi block, dealokasi inode
-        clear_inode_used(new_inode_idx);
-        return -5; // Failed to allocate block
-    }
-    
-    new_dir_inode.i_block[0] = new_block;
-    
-    // 6. Buat directory table dengan entries "." dan ".."
-    //uint8_t dir_block[BLOCK_SIZE];
-    // Clear block terlebih dahulu
-    for (int i = 0; i < BLOCK_SIZE; i++) {
-        dir_block[i] = 0;
-    }
-    
-    uint32_t offset = 0;
-    
-    // Entry untuk "." (current directory)
-    struct EXT2DirectoryEntry *current_entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-    current_entry->inode = new_inode_idx;
-    current_entry->name_len = 1;
-    current_entry->file_type = EXT2_FT_DIR;
-    current_entry->rec_len = get_entry_record_len(1);
-    
-    // Tulis nama "."
-    char *name_ptr = (char *)(current_entry + 1);
-    name_ptr[0] = '.';
-    
-    offset += current_entry->rec_len;
-    
-    // Entry untuk ".." (parent directory)
-    struct EXT2DirectoryEntry *parent_entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-    parent_entry->inode = request->parent_inode;
-    parent_entry->name_len = 2;
-    parent_entry->file_type = EXT2_FT_DIR;
-    // Set rec_len ke sisa block untuk mengisi space yang tersisa
-    parent_entry->rec_len = BLOCK_SIZE - offset;
-    
-    // Tulis nama ".."
-    name_ptr = (char *)(parent_entry + 1);
-    name_ptr[0] = '.';
-    name_ptr[1] = '.';
-    
-    // 7. Tulis directory block ke disk
-    write_blocks(dir_block, new_block, 1);
-    
-    // 8. Sync inode baru ke disk
-    sync_node(&new_dir_inode, new_inode_idx);
-    
-    // 9. Tambahkan entry baru ke parent directory secara manual
-    // Cari block dengan space yang cukup atau alokasi block baru
-    bool entry_added = false;
-    
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        struct EXT2DirectoryEntry *last_entry = NULL;
-        
-        // Cari entry terakhir dalam block
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            last_entry = entry;
-            offset += entry->rec_len;
-        }
-        
-        if (last_entry) {
-            // Hitung space yang dibutuhkan untuk entry baru
-            uint16_t new_entry_size = get_entry_record_len(request->name_len);
-            uint16_t actual_last_size = get_entry_record_len(last_entry->name_len);
-            uint16_t available_space = last_entry->rec_len - actual_last_size;
-            
-            if (available_space >= new_entry_size) {
-                // Ada cukup space, buat entry baru
-                uint32_t last_entry_offset = (uint8_t*)last_entry - dir_block;
-                
-                // Sesuaikan rec_len dari entry terakhir
-                last_entry->rec_len = actual_last_size;
-                
-                // Buat entry baru
-                uint32_t new_entry_offset = last_entry_offset + actual_last_size;
-                struct EXT2DirectoryEntry *new_entry = (struct EXT2DirectoryEntry *)(dir_block + new_entry_offset);
-                
-                new_entry->inode = new_inode_idx;
-                new_entry->name_len = request->name_len;
-                new_entry->file_type = EXT2_FT_DIR; // Pastikan ini adalah directory!
-                new_entry->rec_len = BLOCK_SIZE - new_entry_offset; // Sisa space di block
-                
-                // Copy nama
-                char *new_name_ptr = (char *)(new_entry + 1);
-                for (uint8_t i = 0; i < request->name_len; i++) {
-                    new_name_ptr[i] = request->name[i];
-                }
-                
-                // Tulis block yang sudah dimodifikasi
-                write_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-                entry_added = true;
-                break;
-            }
-        }
-    }
-    
-    // Jika belum bisa menambahkan entry, mungkin perlu alokasi block baru untuk parent
-    if (!entry_added) {
-        // Untuk sederhananya, return error jika parent directory penuh
-        // Dalam implementasi lengkap, kita harus alokasi block baru untuk parent
-        clear_inode_used(new_inode_idx);
-        set_block_free(new_block);
-        return -6; // Parent directory full
-    }
-    
-    // 10. Sync parent directory inode ke disk (update i_size jika diperlukan)
-    sync_node(&parent_inode, request->parent_inode);
-    
-    // 11. Update superblock untuk mencerminkan penggunaan resource baru
-    sync_superblock();
-    
-    return 0; // Success
-}
-int8_t delete_file(struct EXT2DriverRequest *request) {
-    // Validasi input parameter
-    if (!request || request->name_len == 0) {
-        return -1; // Invalid parameter
-    }
-    
-    // 1. Validasi parent directory exists dan valid
-    struct EXT2Inode parent_inode;
-    read_inode(request->parent_inode, &parent_inode);
-    
-    // Pastikan parent adalah directory
-    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
-        return -2; // Parent is not a directory
-    }
-    
-    // 2. Cari file yang akan dihapus dalam parent directory
-    uint8_t dir_block[BLOCK_SIZE];
-    uint32_t target_inode_idx = 0;
-    uint32_t target_block_idx = 0;
-    uint32_t target_entry_offset = 0;
-    bool file_found = false;
-    
-    // Periksa setiap block dari parent directory
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            // Bandingkan nama
-            char *entry_name = (char *)(entry + 1);
-            if (entry->name_len == request->name_len) {
-                bool names_match = true;
-                for (uint8_t i = 0; i < entry->name_len; i++) {
-                    if (entry_name[i] != request->name[i]) {
-                        names_match = false;
-                        break;
-                    }
-                }
-                if (names_match) {
-                    // Pastikan ini adalah file, bukan directory
-                    if (entry->file_type == EXT2_FT_DIR) {
-                        return -6; // Target is a directory, not a file
-                    }
-                    
-                    target_inode_idx = entry->inode;
-                    target_block_idx = block_idx;
-                    target_entry_offset = offset;
-                    file_found = true;
-                    break;
-                }
-            }
-            
-            offset += entry->rec_len;
-        }
-        
-        if (file_found) break;
-    }
-    
-    if (!file_found) {
-        return -3; // File not found
-    }
-    
-    // 3. Baca inode file yang akan dihapus
-    struct EXT2Inode file_inode;
-    read_inode(target_inode_idx, &file_inode);
-    
-    // 4. Dealokasi semua block yang digunakan oleh file
-    for (uint32_t i = 0; i < file_inode.i_blocks && i < 12; i++) {
-        if (file_inode.i_block[i] != 0) {
-            deallocate_block(file_inode.i_block[i]);
-        }
-    }
-    
-    // 5. Dealokasi inode
-    clear_inode_used(target_inode_idx);
-    
-    // 6. Hapus entry dari parent directory
-    read_blocks(dir_block, parent_inode.i_block[target_block_idx], 1);
-    
-    struct EXT2DirectoryEntry *target_entry = (struct EXT2DirectoryEntry *)(dir_block + target_entry_offset);
-    uint16_t entry_rec_len = target_entry->rec_len;
-    
-    // Cari entry sebelumnya untuk menggabungkan rec_len
-    if (target_entry_offset > 0) {
-        // Ada entry sebelumnya, gabungkan rec_len
-        uint32_t prev_offset = 0;
-        struct EXT2DirectoryEntry *prev_entry = NULL;
-        
-        while (prev_offset < target_entry_offset) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + prev_offset);
-            if (prev_offset + entry->rec_len == target_entry_offset) {
-                prev_entry = entry;
-                break;
-            }
-            prev_offset += entry->rec_len;
-        }
-        
-        if (prev_entry) {
-            prev_entry->rec_len += entry_rec_len;
-        }
-    } else {
-        // Entry pertama, cari entry berikutnya
-        if (target_entry_offset + entry_rec_len < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *next_entry = (struct EXT2DirectoryEntry *)(dir_block + target_entry_offset + entry_rec_len);
-            if (next_entry->inode != 0) {
-                // Copy next entry ke posisi current entry
-                uint32_t copy_size = BLOCK_SIZE - (target_entry_offset + entry_rec_len);
-                for (uint32_t i = 0; i < copy_size; i++) {
-                    dir_block[target_entry_offset + i] = dir_block[target_entry_offset + entry_rec_len + i];
-                }
-                
-                // Update rec_len dari entry yang dipindah
-                struct EXT2DirectoryEntry *moved_entry = (struct EXT2DirectoryEntry *)(dir_block + target_entry_offset);
-                moved_entry->rec_len += entry_rec_len;
-            } else {
-                // Tidak ada entry berikutnya, clear entry
-                target_entry->inode = 0;
-                target_entry->rec_len = entry_rec_len;
-                target_entry->name_len = 0;
-                target_entry->file_type = 0;
-            }
-        }
-    }
-    
-    // 7. Tulis kembali directory block
-    write_blocks(dir_block, parent_inode.i_block[target_block_idx], 1);
-    
-    return 0; // Success
-}
-
-int8_t delete_directory(struct EXT2DriverRequest *request) {
-    // Validasi input parameter
-    if (!request || request->name_len == 0) {
-        return -1; // Invalid parameter
-    }
-    
-    // 1. Validasi parent directory exists dan valid
-    struct EXT2Inode parent_inode;
-    read_inode(request->parent_inode, &parent_inode);
-    
-    // Pastikan parent adalah directory
-    if (!(parent_inode.i_mode & EXT2_S_IFDIR)) {
-        return -2; // Parent is not a directory
-    }
-    
-    // 2. Cari directory yang akan dihapus dalam parent directory
-    uint8_t dir_block[BLOCK_SIZE];
-    uint32_t target_inode_idx = 0;
-    uint32_t target_block_idx = 0;
-    uint32_t target_entry_offset = 0;
-    bool dir_found = false;
-    
-    // Periksa setiap block dari parent directory
-    for (uint32_t block_idx = 0; block_idx < parent_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (parent_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(dir_block, parent_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            // Bandingkan nama
-            char *entry_name = (char *)(entry + 1);
-            if (entry->name_len == request->name_len) {
-                bool names_match = true;
-                for (uint8_t i = 0; i < entry->name_len; i++) {
-                    if (entry_name[i] != request->name[i]) {
-                        names_match = false;
-                        break;
-                    }
-                }
-                if (names_match) {
-                    // Pastikan ini adalah directory, bukan file
-                    if (entry->file_type != EXT2_FT_DIR) {
-                        return -6; // Target is a file, not a directory
-                    }
-                    
-                    target_inode_idx = entry->inode;
-                    target_block_idx = block_idx;
-                    target_entry_offset = offset;
-                    dir_found = true;
-                    break;
-                }
-            }
-            
-            offset += entry->rec_len;
-        }
-        
-        if (dir_found) break;
-    }
-    
-    if (!dir_found) {
-        return -3; // Directory not found
-    }
-    
-    // 3. Baca inode directory yang akan dihapus
-    struct EXT2Inode target_dir_inode;
-    read_inode(target_inode_idx, &target_dir_inode);
-    
-    // 4. Pastikan directory kosong (hanya berisi "." dan "..")
-    uint8_t target_dir_block[BLOCK_SIZE];
-    bool is_empty = true;
-    
-    for (uint32_t block_idx = 0; block_idx < target_dir_inode.i_blocks && block_idx < 12; block_idx++) {
-        if (target_dir_inode.i_block[block_idx] == 0) continue;
-        
-        read_blocks(target_dir_block, target_dir_inode.i_block[block_idx], 1);
-        
-        uint32_t offset = 0;
-        while (offset < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(target_dir_block + offset);
-            
-            if (entry->inode == 0 || entry->rec_len == 0) break;
-            if (offset + entry->rec_len > BLOCK_SIZE) break;
-            
-            // Skip "." dan ".." entries
-            char *entry_name = (char *)(entry + 1);
-            bool is_current_dir = (entry->name_len == 1 && entry_name[0] == '.');
-            bool is_parent_dir = (entry->name_len == 2 && entry_name[0] == '.' && entry_name[1] == '.');
-            
-            if (!is_current_dir && !is_parent_dir) {
-                is_empty = false;
-                break;
-            }
-            
-            offset += entry->rec_len;
-        }
-        
-        if (!is_empty) break;
-    }
-    
-    if (!is_empty) {
-        return -7; // Directory is not empty
-    }
-    
-    // 5. Dealokasi semua block yang digunakan oleh directory
-    for (uint32_t i = 0; i < target_dir_inode.i_blocks && i < 12; i++) {
-        if (target_dir_inode.i_block[i] != 0) {
-            deallocate_block(target_dir_inode.i_block[i]);
-        }
-    }
-    
-    // 6. Dealokasi inode
-    clear_inode_used(target_inode_idx);
-    
-    // 7. Hapus entry dari parent directory (sama seperti delete_file)
-    read_blocks(dir_block, parent_inode.i_block[target_block_idx], 1);
-    
-    struct EXT2DirectoryEntry *target_entry = (struct EXT2DirectoryEntry *)(dir_block + target_entry_offset);
-    uint16_t entry_rec_len = target_entry->rec_len;
-    
-    // Cari entry sebelumnya untuk menggabungkan rec_len
-    if (target_entry_offset > 0) {
-        // Ada entry sebelumnya, gabungkan rec_len
-        uint32_t prev_offset = 0;
-        struct EXT2DirectoryEntry *prev_entry = NULL;
-        
-        while (prev_offset < target_entry_offset) {
-            struct EXT2DirectoryEntry *entry = (struct EXT2DirectoryEntry *)(dir_block + prev_offset);
-            if (prev_offset + entry->rec_len == target_entry_offset) {
-                prev_entry = entry;
-                break;
-            }
-            prev_offset += entry->rec_len;
-        }
-        
-        if (prev_entry) {
-            prev_entry->rec_len += entry_rec_len;
-        }
-    } else {
-        // Entry pertama, cari entry berikutnya
-        if (target_entry_offset + entry_rec_len < BLOCK_SIZE) {
-            struct EXT2DirectoryEntry *next_entry = (struct EXT2DirectoryEntry *)(dir_block + target_entry_offset + entry_rec_len);
-            if (next_entry->inode != 0) {
-                // Copy next entry ke posisi current entry
-                uint32_t copy_size = BLOCK_SIZE - (target_entry_offset + entry_rec_len);
-                for (uint32_t i = 0; i < copy_size; i++) {
-                    dir_block[target_entry_offset + i] = dir_block[target_entry_offset + entry_rec_len + i];
-                }
-                
-                // Update rec_len dari entry yang dipindah
-                struct EXT2DirectoryEntry *moved_entry = (struct EXT2DirectoryEntry *)(dir_block + target_entry_offset);
-                moved_entry->rec_len += entry_rec_len;
-            } else {
-                // Tidak ada entry berikutnya, clear entry
-                target_entry->inode = 0;
-                target_entry->rec_len = entry_rec_len;
-                target_entry->name_len = 0;
-                target_entry->file_type = 0;
-            }
-        }
-    }
-    
-    // 8. Tulis kembali directory block
-    write_blocks(dir_block, parent_inode.i_block[target_block_idx], 1);
-    
-    return 0; // Success
-}
-int8_t move_file(struct EXT2DriverRequest *src_request, struct EXT2DriverRequest *dst_request) {
-    // Validasi input
-    if (!src_request || !dst_request) {
-        return -1; // Invalid parameters
-    }
-    
-    // Validasi nama file
-    if (src_request->name_len == 0 || dst_request->name_len == 0) {
-        return -1; // Invalid parameters
-    }
-    
-    // 1. Cari source file/directory di parent directory
-    struct EXT2Inode parent_inode;
-    read_inode(src_request->parent_inode, &parent_inode);
-    
-    // Verifikasi parent adalah directory
-    if (!is_directory(&parent_inode)) {
-        return -1; // Parent is not a directory
-    }
-    
-    // Buat salinan nama source yang aman
-    char src_name[256];
-    size_t src_name_len = src_request->name_len;
-    if (src_name_len >= sizeof(src_name)) {
-        src_name_len = sizeof(src_name) - 1;
-    }
-    memcpy(src_name, src_request->name, src_name_len);
-    src_name[src_name_len] = '\0';
-    
-    // Cari inode source
-    uint32_t src_inode_num = 0;
-    if (!find_inode_in_dir(&parent_inode, src_name, &src_inode_num)) {
-        return -2; // Source file not found
-    }
-    
-    // 2. Cek apakah destination sudah ada
-    char dst_name[256];
-    size_t dst_name_len = dst_request->name_len;
-    if (dst_name_len >= sizeof(dst_name)) {
-        dst_name_len = sizeof(dst_name) - 1;
-    }
-    memcpy(dst_name, dst_request->name, dst_name_len);
-    dst_name[dst_name_len] = '\0';
-    
-    uint32_t dst_inode_num = 0;
-    if (find_inode_in_dir(&parent_inode, dst_name, &dst_inode_num)) {
-        return -3; // Destination already exists
-    }
-    
-    // 3. Baca source inode untuk validasi
-    struct EXT2Inode src_inode;
-    read_inode(src_inode_num, &src_inode);
-    
-    // Jika source adalah directory, cek apakah kosong (untuk keamanan)
-    if (is_directory(&src_inode)) {
-        if (!is_empty_directory(&src_inode)) {
-            // Untuk implementasi sederhana, hanya izinkan move directory kosong
-            // Atau implementasi yang lebih kompleks bisa move seluruh isi directory
-            return -5; // Directory not empty
-        }
-    }
-    
-    // 4. RENAME/MOVE operation
-    // Karena kita dalam direktori yang sama, ini adalah operasi rename
-    // Hapus entry lama dan buat entry baru dengan nama baru
-    
-    // Hapus entry lama dari directory
-    remove_inode_from_dir(&parent_inode, src_name);
-    
-    // Tambah entry baru dengan nama baru
-    add_inode_to_dir(&parent_inode, src_inode_num, dst_name);
-    
-    // Update file type dalam directory entry jika diperlukan
-    // (add_inode_to_dir sudah mengurus ini)
-    
-    return 0; // Success
-}
 void syscall(struct InterruptFrame frame)
 {
   switch (frame.cpu.general.eax)
   {
   case 0: // SYS_READ - File system read
+    // Page buffer yang berasal dari file (segment ELF) diisi dulu, page fault di tengah ext2 tidak boleh baca disk lagi
+    process_prefault_user_buffer(((struct EXT2DriverRequest *)frame.cpu.general.ebx)->buf,
+                                 ((struct EXT2DriverRequest *)frame.cpu.general.ebx)->buffer_size);
     *((int8_t *)frame.cpu.general.ecx) = read(
         *(struct EXT2DriverRequest *)frame.cpu.general.ebx);
     break;
@@ -1077,6 +265,7 @@ void syscall(struct InterruptFrame frame)
     struct EXT2DriverRequest *request = (struct EXT2DriverRequest *)frame.cpu.general.ebx;
     int8_t *result = (int8_t *)frame.cpu.general.ecx;
     
+    process_prefault_user_buffer(request->buf, request->buffer_size);
     *result = read(*request);
     break;
 }
@@ -1237,6 +426,7 @@ break;
     uint8_t* buffer = (uint8_t*) frame.cpu.general.ebx;
     uint32_t block_num = frame.cpu.general.ecx;
     uint32_t count = frame.cpu.general.edx;
+    process_prefault_user_buffer(buffer, count * BLOCK_SIZE);
     read_blocks(buffer, block_num, count); // Pastikan fungsi ini ada
     break;
   }
@@ -1253,6 +443,7 @@ break;
       struct EXT2DriverRequest *request = (struct EXT2DriverRequest *)frame.cpu.general.ebx;
       int8_t *result = (int8_t *)frame.cpu.general.ecx;
       
+      mmap_invalidate_file(request, true);
       *result = delete_file(request);
   }
   break;
@@ -1311,6 +502,164 @@ break;
       *result = process_destroy(pid);
       break;
   }
+  case 33: // SYS_DELETE_RECURSIVE - rm -r
+  {
+      struct EXT2DriverRequest *request = (struct EXT2DriverRequest *)frame.cpu.general.ebx;
+      int8_t *result = (int8_t *)frame.cpu.general.ecx;
+      
+      *result = delete_recursive(*request);
+      // Juga saat gagal: sebagian subtree mungkin sudah terhapus
+      mmap_invalidate_freed_inodes();
+      break;
+  }
+  case 34: // SYS_WRITE_AT - Write into file at offset (sparse)
+  {
+      struct EXT2DriverRequest *request = (struct EXT2DriverRequest *)frame.cpu.general.ebx;
+      uint32_t offset = frame.cpu.general.ecx;
+      int8_t *result = (int8_t *)frame.cpu.general.edx;
+      
+      *result = write_at(*request, offset);
+      mmap_invalidate_file(request, false);
+      break;
+  }
+  case 35: // SYS_SET_COMPRESSION - chattr +c / -c
+  {
+      struct EXT2DriverRequest *request = (struct EXT2DriverRequest *)frame.cpu.general.ebx;
+      bool enable = frame.cpu.general.ecx != 0;
+      int8_t *result = (int8_t *)frame.cpu.general.edx;
+      
+      *result = set_compression(*request, enable);
+      mmap_invalidate_file(request, false);
+      break;
+  }
+  case 36: // SYS_MMAP - Map file ke address space proses
+  {
+      struct MmapRequest *request = (struct MmapRequest *)frame.cpu.general.ebx;
+      void **result = (void **)frame.cpu.general.ecx;
+      struct ProcessControlBlock *pcb = process_get_current_running_pcb_pointer();
+      
+      if (pcb == NULL)
+          *result = NULL;
+      else if (request->flags & MMAP_ANONYMOUS)
+          *result = process_mmap_anonymous(pcb, request->file.buffer_size, (request->prot & MMAP_PROT_WRITE) != 0);
+      else
+          *result = mmap_create(pcb->memory.mappings, request);
+      break;
+  }
+  case 37: // SYS_MUNMAP - Writeback page dirty lalu hapus mapping
+  {
+      void *addr = (void *)frame.cpu.general.ebx;
+      int8_t *result = (int8_t *)frame.cpu.general.ecx;
+      struct ProcessControlBlock *pcb = process_get_current_running_pcb_pointer();
+      
+      if (pcb == NULL)
+          *result = 1;
+      else if ((uint32_t)addr >= PROCESS_ANONYMOUS_MMAP_START && (uint32_t)addr < PROCESS_ANONYMOUS_MMAP_END)
+          *result = process_munmap_anonymous(pcb, addr);
+      else
+          *result = mmap_remove(paging_get_current_page_directory_addr(), pcb->memory.mappings, addr);
+      break;
+  }
+  case 38: // SYS_MSYNC - Writeback page dirty mapping MMAP_SHARED
+  {
+      void *addr = (void *)frame.cpu.general.ebx;
+      int8_t *result = (int8_t *)frame.cpu.general.ecx;
+      struct ProcessControlBlock *pcb = process_get_current_running_pcb_pointer();
+      
+      *result = pcb != NULL ? mmap_sync(paging_get_current_page_directory_addr(), pcb->memory.mappings, addr) : 1;
+      break;
+  }
+  case 39: // SYS_FIND - Cari path berdasarkan nama / prefix lewat name index
+  {
+      struct EXT2FindRequest *request = (struct EXT2FindRequest *)frame.cpu.general.ebx;
+      int8_t *result = (int8_t *)frame.cpu.general.ecx;
+      
+      *result = find_by_name(request);
+      break;
+  }
+  case 40: // SYS_DEDUP - Offline dedup: gabungkan blok data yang isinya sama
+  {
+      struct EXT2DedupStats *stats = (struct EXT2DedupStats *)frame.cpu.general.ebx;
+      int8_t *result = (int8_t *)frame.cpu.general.ecx;
+      
+      *result = dedup_filesystem(stats);
+      break;
+  }
+  case 41: // SYS_SNAPSHOT - Status / buat / rollback / hapus snapshot filesystem
+  {
+      uint32_t op = frame.cpu.general.ebx;
+      int8_t *result = (int8_t *)frame.cpu.general.ecx;
+      uint32_t *changed_blocks = (uint32_t *)frame.cpu.general.edx;
+      
+      if (op == EXT2_SNAPSHOT_CREATE)
+          *result = snapshot_create();
+      else if (op == EXT2_SNAPSHOT_ROLLBACK)
+      {
+          *result = snapshot_rollback();
+          if (*result == 0)
+              mmap_invalidate_all();
+      }
+      else if (op == EXT2_SNAPSHOT_DROP)
+          *result = snapshot_drop();
+      
+      bool active = snapshot_status(changed_blocks);
+      if (op == EXT2_SNAPSHOT_STATUS)
+          *result = active ? 0 : 1;
+      break;
+  }
+  case 42: // SYS_DF - Laporan ruang kosong dari free extent index
+  {
+      get_space_info((struct EXT2SpaceInfo *)frame.cpu.general.ebx);
+      break;
+  }
+  case 43: // SYS_SLABINFO - Statistik object cache kernel heap
+  {
+      struct KmemCacheInfo *info = (struct KmemCacheInfo *)frame.cpu.general.ebx;
+      uint32_t *count = (uint32_t *)frame.cpu.general.edx;
+
+      *count = kmem_get_cache_info(info, frame.cpu.general.ecx);
+      break;
+  }
+  case 44: // SYS_FORK - Salin proses berjalan dengan copy-on-write
+  {
+      int32_t *result = (int32_t *)frame.cpu.general.ebx;
+      // Ditulis sebelum fork: page milik anak tetap berisi 0, parent menerima PID lewat copy-on-write
+      *result = 0;
+      struct Context context = {
+          .cpu = frame.cpu,
+          .eip = frame.int_stack.eip,
+          .eflags = frame.int_stack.eflags,
+      };
+      *result = process_fork(context);
+      break;
+  }
+  case 45: // SYS_SCHEDSTAT - Statistik context switch dan TLB flush
+  {
+      scheduler_get_statistics((struct SchedulerStatistics *)frame.cpu.general.ebx);
+      break;
+  }
+  case 46: // SYS_BRK - Pindahkan program break (0 = hanya baca)
+  {
+      uint32_t *result = (uint32_t *)frame.cpu.general.ecx;
+      struct ProcessControlBlock *pcb = process_get_current_running_pcb_pointer();
+
+      *result = pcb != NULL ? process_brk(pcb, frame.cpu.general.ebx) : 0;
+      break;
+  }
+  case 47: // SYS_SBRK - Geser program break relatif, result = break lama (NULL jika gagal)
+  {
+      int32_t increment = (int32_t)frame.cpu.general.ebx;
+      void **result = (void **)frame.cpu.general.ecx;
+      struct ProcessControlBlock *pcb = process_get_current_running_pcb_pointer();
+      uint32_t old_break = pcb != NULL ? process_brk(pcb, 0) : 0;
+      uint32_t new_break = old_break + (uint32_t)increment;
+
+      if (old_break == 0 || (increment > 0 && new_break < old_break) || (increment < 0 && new_break > old_break))
+          *result = NULL;
+      else
+          *result = process_brk(pcb, new_break) == new_break ? (void *)old_break : NULL;
+      break;
+  }
 
   default:
     // Unknown system call
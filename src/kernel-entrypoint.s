@@ -1,14 +1,16 @@
 global loader                        ; the entry symbol for ELF
 global load_gdt                      ; load GDT table
 global set_tss_register              ; set tss register to GDT entry
+global _multiboot_magic              ; eax from bootloader
+global _multiboot_info_physical_addr ; ebx from bootloader
 extern kernel_setup                  ; kernel C entrypoint
 extern _paging_kernel_page_directory ; kernel page directory
 
 KERNEL_VIRTUAL_BASE equ 0xC0000000    ; kernel virtual memory
 KERNEL_STACK_SIZE   equ 2097152       ; size of stack in bytes
 MAGIC_NUMBER        equ 0x1BADB002    ; define the magic number constant
-FLAGS               equ 0x0           ; multiboot flags
-CHECKSUM            equ -MAGIC_NUMBER ; calculate the checksum (magic number + checksum + flags == 0)
+FLAGS               equ 0x2           ; multiboot flags, bit 1: request memory information (mem_* & mmap_*)
+CHECKSUM            equ -(MAGIC_NUMBER + FLAGS) ; calculate the checksum (magic number + checksum + flags == 0)
 
 
 section .bss
@@ -17,6 +19,14 @@ kernel_stack:              ; label points to beginning of memory
     resb KERNEL_STACK_SIZE ; reserve stack for the kernel
 
 
+section .data
+align 4
+_multiboot_magic:              ; MULTIBOOT_BOOTLOADER_MAGIC if loaded by multiboot bootloader
+    dd 0
+_multiboot_info_physical_addr: ; physical address of struct MultibootInfo
+    dd 0
+
+
 section .multiboot  ; GRUB multiboot header
 align 4             ; the code must be 4 byte aligned
     dd MAGIC_NUMBER ; write the magic number to the machine code,
@@ -28,6 +38,10 @@ align 4             ; the code must be 4 byte aligned
 section .setup.text 
 loader equ (loader_entrypoint - KERNEL_VIRTUAL_BASE)
 loader_entrypoint:         ; the loader label (defined as entry point in linker script)
+    ; Save multiboot magic & info pointer before eax / ebx is used, paging is still off (physical address)
+    mov [_multiboot_magic - KERNEL_VIRTUAL_BASE], eax
+    mov [_multiboot_info_physical_addr - KERNEL_VIRTUAL_BASE], ebx
+
     ; Set CR3 (CPU page register)
     mov eax, _paging_kernel_page_directory - KERNEL_VIRTUAL_BASE
     mov cr3, eax
@@ -11,6 +11,8 @@
 #include "header/filesystem/ext2.h"
 #include "header/filesystem/test_ext2.h" // Assuming this has the 'read' function definition for syscall 0
 #include "header/memory/paging.h"
+#include "header/memory/multiboot.h"
+#include "header/memory/kmalloc.h"
 #include "header/stdlib/string.h" // Diperlukan untuk strlen dalam kernel_print_string
 #include "header/process/process.h"
 #include "header/scheduler/scheduler.h"
@@ -25,6 +27,15 @@ void kernel_setup(void)
     framebuffer_clear();
     framebuffer_set_cursor(0, 0);
 
+    // 1. Direct map memori fisik di higher half + buddy allocator dari memory map bootloader, lalu kernel heap (slab)
+    //    Info multiboot hanya dibaca jika ada di frame 0, satu-satunya frame yang terpetakan sebelum paging_init
+    struct MultibootInfo *multiboot_info = NULL;
+    if (_multiboot_magic == MULTIBOOT_BOOTLOADER_MAGIC &&
+        _multiboot_info_physical_addr + sizeof(struct MultibootInfo) <= PAGE_FRAME_SIZE)
+        multiboot_info = (struct MultibootInfo *)(_multiboot_info_physical_addr + KERNEL_VIRTUAL_ADDRESS_BASE);
+    paging_init(multiboot_info);
+    kmem_init();
+
     // 2. Inisialisasi sistem file EXT2
     initialize_filesystem_ext2();
 
@@ -32,26 +43,20 @@ void kernel_setup(void)
     gdt_install_tss();
     set_tss_register();
   
-    // Allocate first 4 MiB virtual memory
-    paging_allocate_user_page_frame(&_paging_kernel_page_directory, (uint8_t *)0);
-
-    // 5. Muat program shell ke memori
+    // 4. Program shell (ELF32) dimuat lazily oleh process_create_user_process: hanya page yang dieksekusi
+    //    / disentuh yang dibaca dari disk. buf dan buffer_size hanya dipakai jika file berupa flat binary
     struct EXT2DriverRequest request = {
         .buf = (uint8_t *)0,
-        .name = "shell",
+        .name = "shell_elf",
         .parent_inode = 2,
         .buffer_size = 0x100000,
-        .name_len = 5,
+        .name_len = 9,
     };
-    // Panggil syscall read (EAX=0) untuk memuat shell.
-    // Catatan: Syscall read di interrupt.c Anda saat ini tidak mengembalikan status sukses/gagal.
-    // Jika ada masalah pemuatan, Anda mungkin tidak melihatnya secara langsung di sini.
-    read(request);
 
     // Set TSS $esp pointer and jump into shell
     set_tss_kernel_current_stack();
 
     process_create_user_process(request);
-    paging_use_page_directory(_process_list[0].context.page_directory_virtual_addr);
+    paging_use_page_directory(_process_list[0]->context.page_directory_virtual_addr);
     scheduler_switch_to_next_process();
 }
@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "header/memory/kmalloc.h"
+#include "header/memory/paging.h"
+#include "header/filesystem/ext2.h"
+#include "header/stdlib/string.h"
+
+/**
+ * Header slab di awal page, free_stack berisi index object bebas (top = free_count - 1)
+ */
+struct KmemSlab
+{
+  struct KmemCache *cache;
+  struct KmemSlab *next;
+  struct KmemSlab *prev;
+  uint16_t in_use;
+  uint16_t free_count;
+  uint16_t free_stack[];
+};
+
+static struct KmemCache kmem_cache_list[KMEM_CACHE_COUNT_MAX];
+static struct KmemCache *kmalloc_size_class[8]; // 16, 32, ..., 2048
+struct KmemCache *kmem_block_cache = NULL;
+
+static void slab_list_remove(struct KmemSlab **list, struct KmemSlab *slab)
+{
+  if (slab->prev)
+    slab->prev->next = slab->next;
+  else
+    *list = slab->next;
+  if (slab->next)
+    slab->next->prev = slab->prev;
+  slab->next = slab->prev = NULL;
+}
+
+static void slab_list_push(struct KmemSlab **list, struct KmemSlab *slab)
+{
+  slab->prev = NULL;
+  slab->next = *list;
+  if (*list)
+    (*list)->prev = slab;
+  *list = slab;
+}
+
+static struct KmemSlab *slab_create(struct KmemCache *cache)
+{
+  uint32_t physical_addr = paging_allocate_small_page();
+  if (physical_addr == 0)
+    return NULL;
+
+  struct KmemSlab *slab = paging_physical_to_virtual(physical_addr);
+  slab->cache = cache;
+  slab->next = slab->prev = NULL;
+  slab->in_use = 0;
+  slab->free_count = cache->objects_per_slab;
+  // Index kecil di puncak stack: object dipakai berurutan dari awal page
+  for (uint32_t i = 0; i < cache->objects_per_slab; i++)
+  {
+    slab->free_stack[i] = cache->objects_per_slab - 1 - i;
+    if (cache->constructor)
+      cache->constructor((uint8_t *)slab + cache->first_offset + i * cache->object_size);
+  }
+  cache->slab_count++;
+  return slab;
+}
+
+static void slab_destroy(struct KmemSlab *slab)
+{
+  slab->cache->slab_count--;
+  paging_free_small_page(paging_virtual_to_physical(slab));
+}
+
+struct KmemCache *kmem_cache_create(const char *name, uint32_t object_size, void (*constructor)(void *object))
+{
+  if (object_size == 0 || object_size > KMEM_OBJECT_SIZE_MAX)
+    return NULL;
+
+  struct KmemCache *cache = NULL;
+  for (uint32_t i = 0; i < KMEM_CACHE_COUNT_MAX && cache == NULL; i++)
+    if (!kmem_cache_list[i].used)
+      cache = &kmem_cache_list[i];
+  if (cache == NULL)
+    return NULL;
+
+  memset(cache, 0, sizeof(struct KmemCache));
+  cache->used = true;
+  uint32_t name_len = strlen(name);
+  if (name_len >= KMEM_CACHE_NAME_LENGTH)
+    name_len = KMEM_CACHE_NAME_LENGTH - 1;
+  memcpy(cache->name, name, name_len);
+  cache->object_size = (object_size + 7) & ~7u;
+  cache->constructor = constructor;
+
+  // Jumlah object terbesar yang muat bersama header + stack index, object aligned 8
+  uint32_t count = (KMEM_SLAB_SIZE - sizeof(struct KmemSlab)) / (cache->object_size + sizeof(uint16_t));
+  while (((sizeof(struct KmemSlab) + count * sizeof(uint16_t) + 7) & ~7u) + count * cache->object_size > KMEM_SLAB_SIZE)
+    count--;
+  cache->objects_per_slab = count;
+  cache->first_offset = (sizeof(struct KmemSlab) + count * sizeof(uint16_t) + 7) & ~7u;
+  return cache;
+}
+
+void *kmem_cache_alloc(struct KmemCache *cache)
+{
+  if (cache == NULL)
+    return NULL;
+  struct KmemSlab *slab = cache->partial;
+  if (slab == NULL)
+  {
+    slab = cache->empty;
+    if (slab != NULL)
+      slab_list_remove(&cache->empty, slab);
+    else if ((slab = slab_create(cache)) == NULL)
+      return NULL;
+    slab_list_push(&cache->partial, slab);
+  }
+
+  uint16_t index = slab->free_stack[--slab->free_count];
+  slab->in_use++;
+  if (slab->free_count == 0)
+  {
+    slab_list_remove(&cache->partial, slab);
+    slab_list_push(&cache->full, slab);
+  }
+  cache->active_objects++;
+  cache->alloc_count++;
+  return (uint8_t *)slab + cache->first_offset + index * cache->object_size;
+}
+
+void kmem_cache_free(struct KmemCache *cache, void *object)
+{
+  if (object == NULL)
+    return;
+  struct KmemSlab *slab = (struct KmemSlab *)((uintptr_t)object & ~(uintptr_t)(KMEM_SLAB_SIZE - 1));
+  if (slab->cache != cache || slab->in_use == 0)
+    return;
+
+  bool was_full = slab->free_count == 0;
+  slab->free_stack[slab->free_count++] = ((uint8_t *)object - (uint8_t *)slab - cache->first_offset) / cache->object_size;
+  slab->in_use--;
+  cache->active_objects--;
+  cache->free_count++;
+
+  if (was_full)
+  {
+    slab_list_remove(&cache->full, slab);
+    slab_list_push(&cache->partial, slab);
+  }
+  if (slab->in_use == 0)
+  {
+    slab_list_remove(&cache->partial, slab);
+    // Satu slab kosong disimpan supaya pola alloc/free di batas slab tidak bolak-balik ke buddy
+    if (cache->empty == NULL)
+      slab_list_push(&cache->empty, slab);
+    else
+      slab_destroy(slab);
+  }
+}
+
+void kmem_init(void)
+{
+  static const char *size_class_name[8] = {
+      "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128",
+      "kmalloc-256", "kmalloc-512", "kmalloc-1024", "kmalloc-2048"};
+  for (uint32_t i = 0; i < 8; i++)
+    kmalloc_size_class[i] = kmem_cache_create(size_class_name[i], KMALLOC_SIZE_CLASS_MIN << i, NULL);
+  kmem_block_cache = kmem_cache_create("block_buffer", BLOCK_SIZE, NULL);
+}
+
+void *kmalloc(uint32_t size)
+{
+  if (size == 0)
+    return NULL;
+  if (size <= KMALLOC_SIZE_CLASS_MAX)
+  {
+    uint32_t class = 0;
+    while ((uint32_t)(KMALLOC_SIZE_CLASS_MIN << class) < size)
+      class++;
+    return kmalloc_size_class[class] ? kmem_cache_alloc(kmalloc_size_class[class]) : NULL;
+  }
+
+  // Alokasi besar: blok buddy dengan order terkecil yang cukup
+  uint8_t order = 0;
+  while (order <= PAGE_BUDDY_ORDER_MAX && (uint32_t)(PAGE_SMALL_SIZE << order) < size)
+    order++;
+  uint32_t physical_addr = order <= PAGE_BUDDY_ORDER_MAX ? paging_buddy_allocate(order) : 0;
+  return physical_addr == 0 ? NULL : paging_physical_to_virtual(physical_addr);
+}
+
+void kfree(void *ptr)
+{
+  if (ptr == NULL)
+    return;
+  if (((uintptr_t)ptr & (KMEM_SLAB_SIZE - 1)) == 0)
+  {
+    paging_buddy_free(paging_virtual_to_physical(ptr));
+    return;
+  }
+  struct KmemSlab *slab = (struct KmemSlab *)((uintptr_t)ptr & ~(uintptr_t)(KMEM_SLAB_SIZE - 1));
+  kmem_cache_free(slab->cache, ptr);
+}
+
+uint32_t kmem_get_cache_info(struct KmemCacheInfo *info, uint32_t count)
+{
+  uint32_t copied = 0;
+  for (uint32_t i = 0; i < KMEM_CACHE_COUNT_MAX && copied < count; i++)
+  {
+    struct KmemCache *cache = &kmem_cache_list[i];
+    if (!cache->used)
+      continue;
+    memcpy(info[copied].name, cache->name, KMEM_CACHE_NAME_LENGTH);
+    info[copied].object_size = cache->object_size;
+    info[copied].objects_per_slab = cache->objects_per_slab;
+    info[copied].slab_count = cache->slab_count;
+    info[copied].active_objects = cache->active_objects;
+    info[copied].total_objects = cache->slab_count * cache->objects_per_slab;
+    info[copied].alloc_count = cache->alloc_count;
+    info[copied].free_count = cache->free_count;
+    copied++;
+  }
+  return copied;
+}
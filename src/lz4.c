@@ -0,0 +1,177 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "header/stdlib/string.h"
+#include "header/stdlib/lz4.h"
+
+#define LZ4_MIN_MATCH     4
+#define LZ4_LAST_LITERALS 5   // 5 byte terakhir selalu literal
+#define LZ4_MFLIMIT       12  // match terakhir harus dimulai >= 12 byte sebelum akhir
+#define LZ4_MAX_OFFSET    65535
+#define LZ4_HASH_BITS     12
+
+// Posisi terakhir setiap hash; isi lama tidak berbahaya karena match selalu diverifikasi
+static uint32_t lz4_hash_table[1 << LZ4_HASH_BITS];
+
+static uint32_t lz4_read32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t lz4_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+/**
+ * @brief Tulis sisa panjang (>= 15) sebagai deretan byte 255 + byte terakhir
+ * @return posisi output baru, NULL jika buffer penuh
+ */
+static uint8_t *lz4_write_length(uint8_t *op, const uint8_t *oend, uint32_t length)
+{
+    while (length >= 255) {
+        if (op >= oend) return NULL;
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= oend) return NULL;
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+/**
+ * @brief Tulis satu sequence: token, literal, lalu (jika match_length != 0) offset & panjang match
+ */
+static uint8_t *lz4_write_sequence(uint8_t *op, const uint8_t *oend, const uint8_t *literals,
+                                   uint32_t literal_length, uint32_t offset, uint32_t match_length)
+{
+    if (op >= oend) return NULL;
+    uint8_t *token = op++;
+    *token = (uint8_t)((literal_length >= 15 ? 15 : literal_length) << 4);
+    if (literal_length >= 15 && (op = lz4_write_length(op, oend, literal_length - 15)) == NULL)
+        return NULL;
+
+    if ((uint32_t)(oend - op) < literal_length) return NULL;
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (match_length == 0)
+        return op; // sequence terakhir hanya berisi literal
+
+    if (oend - op < 2) return NULL;
+    *op++ = (uint8_t)(offset & 0xFF);
+    *op++ = (uint8_t)(offset >> 8);
+
+    match_length -= LZ4_MIN_MATCH;
+    *token |= (uint8_t)(match_length >= 15 ? 15 : match_length);
+    if (match_length >= 15)
+        op = lz4_write_length(op, oend, match_length - 15);
+    return op;
+}
+
+uint32_t lz4_compress(const void *src, uint32_t src_size, void *dst, uint32_t dst_capacity)
+{
+    const uint8_t *base   = (const uint8_t *)src;
+    const uint8_t *ip     = base;
+    const uint8_t *anchor = base;
+    const uint8_t *iend   = base + src_size;
+    uint8_t *op           = (uint8_t *)dst;
+    const uint8_t *oend   = op + dst_capacity;
+
+    if (src_size > LZ4_MFLIMIT) {
+        const uint8_t *mflimit    = iend - LZ4_MFLIMIT;
+        const uint8_t *matchlimit = iend - LZ4_LAST_LITERALS;
+        memset(lz4_hash_table, 0, sizeof(lz4_hash_table));
+
+        while (ip < mflimit) {
+            uint32_t sequence = lz4_read32(ip);
+            uint32_t h = lz4_hash(sequence);
+            const uint8_t *ref = base + lz4_hash_table[h];
+            lz4_hash_table[h] = (uint32_t)(ip - base);
+
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || lz4_read32(ref) != sequence) {
+                ip++;
+                continue;
+            }
+
+            // Perpanjang match ke belakang selama masih di atas anchor
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            const uint8_t *match_end = ip + LZ4_MIN_MATCH;
+            const uint8_t *ref_end   = ref + LZ4_MIN_MATCH;
+            while (match_end < matchlimit && *match_end == *ref_end) {
+                match_end++;
+                ref_end++;
+            }
+
+            op = lz4_write_sequence(op, oend, anchor, (uint32_t)(ip - anchor),
+                                    (uint32_t)(ip - ref), (uint32_t)(match_end - ip));
+            if (op == NULL) return 0;
+
+            ip = anchor = match_end;
+        }
+    }
+
+    op = lz4_write_sequence(op, oend, anchor, (uint32_t)(iend - anchor), 0, 0);
+    if (op == NULL) return 0;
+    return (uint32_t)(op - (uint8_t *)dst);
+}
+
+int32_t lz4_decompress(const void *src, uint32_t src_size, void *dst, uint32_t dst_capacity)
+{
+    const uint8_t *ip   = (const uint8_t *)src;
+    const uint8_t *iend = ip + src_size;
+    uint8_t *op         = (uint8_t *)dst;
+    uint8_t *oend       = op + dst_capacity;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        uint32_t literal_length = token >> 4;
+        if (literal_length == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                literal_length += b;
+            } while (b == 255);
+        }
+        if ((uint32_t)(iend - ip) < literal_length || (uint32_t)(oend - op) < literal_length)
+            return -1;
+        memcpy(op, ip, literal_length);
+        op += literal_length;
+        ip += literal_length;
+
+        // Sequence terakhir tidak memiliki bagian match
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2) return -1;
+        uint32_t offset = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (uint32_t)(op - (uint8_t *)dst))
+            return -1;
+
+        uint32_t match_length = token & 0x0F;
+        if (match_length == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return -1;
+                b = *ip++;
+                match_length += b;
+            } while (b == 255);
+        }
+        match_length += LZ4_MIN_MATCH;
+        if ((uint32_t)(oend - op) < match_length)
+            return -1;
+
+        // Salin per byte: match boleh overlap dengan output (offset < panjang)
+        const uint8_t *match = op - offset;
+        while (match_length--)
+            *op++ = *match++;
+    }
+
+    return (int32_t)(op - (uint8_t *)dst);
+}
@@ -0,0 +1,346 @@
+#include "header/memory/mmap.h"
+#include "header/process/process.h"
+#include "header/memory/kmalloc.h"
+#include "header/stdlib/string.h"
+
+/**
+ * Page cache: satu frame berisi potongan file [file_offset, file_offset + PAGE_FRAME_SIZE).
+ * Entry dialokasikan dari object cache "page_cache", jumlahnya hanya dibatasi frame yang tersedia
+ *
+ * @param next      Entry berikutnya di list page cache
+ * @param stale     Isi file sudah berubah di disk, entry tidak dibagikan lagi ke mapper baru
+ * @param ref_count Jumlah PDE yang memetakan frame ini, frame dan entry dilepas saat 0
+ */
+struct PageCacheEntry
+{
+  struct PageCacheEntry *next;
+  bool stale;
+  uint32_t inode;
+  uint32_t file_offset;
+  uint32_t frame_index;
+  uint32_t ref_count;
+};
+
+static struct PageCacheEntry *page_cache = NULL;
+static struct KmemCache *page_cache_entry_cache = NULL;
+
+static int32_t page_cache_get(uint32_t inode, uint32_t file_offset)
+{
+  for (struct PageCacheEntry *entry = page_cache; entry != NULL; entry = entry->next)
+  {
+    if (!entry->stale && entry->inode == inode && entry->file_offset == file_offset)
+    {
+      entry->ref_count++;
+      return entry->frame_index;
+    }
+  }
+
+  if (page_cache_entry_cache == NULL)
+    page_cache_entry_cache = kmem_cache_create("page_cache", sizeof(struct PageCacheEntry), NULL);
+  struct PageCacheEntry *new_entry = page_cache_entry_cache ? kmem_cache_alloc(page_cache_entry_cache) : NULL;
+  if (new_entry == NULL)
+    return -1;
+  int32_t frame_index = paging_allocate_frame();
+  if (frame_index < 0)
+  {
+    kmem_cache_free(page_cache_entry_cache, new_entry);
+    return -1;
+  }
+
+  // Isi frame lewat slot kmap: bagian setelah EOF diisi nol
+  struct EXT2Inode node;
+  read_inode(inode, &node);
+  uint8_t *frame = paging_kmap_frame(frame_index);
+  uint32_t size = read_inode_range(&node, frame, file_offset, PAGE_FRAME_SIZE);
+  memset(frame + size, 0, PAGE_FRAME_SIZE - size);
+  paging_kunmap_frame();
+
+  new_entry->stale = false;
+  new_entry->inode = inode;
+  new_entry->file_offset = file_offset;
+  new_entry->frame_index = frame_index;
+  new_entry->ref_count = 1;
+  new_entry->next = page_cache;
+  page_cache = new_entry;
+  return frame_index;
+}
+
+static void page_cache_put(uint32_t frame_index)
+{
+  for (struct PageCacheEntry **link = &page_cache; *link != NULL; link = &(*link)->next)
+  {
+    struct PageCacheEntry *entry = *link;
+    if (entry->frame_index == frame_index)
+    {
+      if (--entry->ref_count == 0)
+      {
+        paging_free_frame(frame_index);
+        *link = entry->next;
+        kmem_cache_free(page_cache_entry_cache, entry);
+      }
+      return;
+    }
+  }
+}
+
+static struct MemoryMapping *find_mapping(struct MemoryMapping *mappings, uint32_t addr)
+{
+  for (uint32_t i = 0; i < PROCESS_MMAP_COUNT_MAX; i++)
+  {
+    struct MemoryMapping *mapping = &mappings[i];
+    if (mapping->used && addr >= mapping->virtual_addr &&
+        addr - mapping->virtual_addr < mapping->page_count * PAGE_FRAME_SIZE)
+      return mapping;
+  }
+  return NULL;
+}
+
+static bool resolve_file(struct EXT2DriverRequest *request, uint32_t *out_inode, struct EXT2Inode *out_node)
+{
+  uint32_t parent_inode_idx;
+  if (!find_dir(request->parent_inode, &parent_inode_idx))
+    return false;
+
+  struct EXT2Inode parent_inode;
+  read_inode(parent_inode_idx, &parent_inode);
+
+  char name[256];
+  memcpy(name, request->name, request->name_len);
+  name[request->name_len] = '\0';
+  if (!find_inode_in_dir(&parent_inode, name, out_inode))
+    return false;
+
+  read_inode(*out_inode, out_node);
+  return !is_directory(out_node);
+}
+
+void *mmap_create(struct MemoryMapping *mappings, struct MmapRequest *request)
+{
+  if (!(request->prot & MMAP_PROT_READ) || (request->flags != MMAP_SHARED && request->flags != MMAP_PRIVATE))
+    return NULL;
+  if (request->offset % PAGE_FRAME_SIZE != 0)
+    return NULL;
+
+  uint32_t inode;
+  struct EXT2Inode node;
+  if (!resolve_file(&request->file, &inode, &node) || request->offset >= node.i_size)
+    return NULL;
+
+  uint32_t length = request->file.buffer_size;
+  if (length == 0)
+    length = node.i_size - request->offset;
+  uint32_t page_count = ceil_div(length, PAGE_FRAME_SIZE);
+  if (page_count > MMAP_PAGE_COUNT_MAX)
+    return NULL;
+
+  struct MemoryMapping *slot = NULL;
+  for (uint32_t i = 0; i < PROCESS_MMAP_COUNT_MAX && slot == NULL; i++)
+    if (!mappings[i].used)
+      slot = &mappings[i];
+  if (slot == NULL)
+    return NULL;
+
+  // First-fit di region mmap, mapping tidak boleh tumpang tindih
+  for (uint32_t addr = MMAP_REGION_START; addr + page_count * PAGE_FRAME_SIZE <= MMAP_REGION_END; addr += PAGE_FRAME_SIZE)
+  {
+    bool overlap = false;
+    for (uint32_t page = 0; page < page_count && !overlap; page++)
+      overlap = find_mapping(mappings, addr + page * PAGE_FRAME_SIZE) != NULL;
+    if (overlap)
+      continue;
+
+    slot->used = true;
+    slot->virtual_addr = addr;
+    slot->page_count = page_count;
+    slot->inode = inode;
+    slot->file_offset = request->offset;
+    slot->prot = request->prot;
+    slot->flags = request->flags;
+    slot->private_pages = 0;
+    return (void *)addr;
+  }
+  return NULL;
+}
+
+bool mmap_handle_page_fault(struct PageDirectory *page_dir, struct MemoryMapping *mappings, uint32_t fault_addr, uint32_t error_code)
+{
+  struct MemoryMapping *mapping = find_mapping(mappings, fault_addr);
+  if (mapping == NULL || mapping->inode == 0)
+    return false;
+
+  bool write = (error_code & PAGE_FAULT_WRITE) != 0;
+  if (write && !(mapping->prot & MMAP_PROT_WRITE))
+    return false;
+
+  uint32_t page = (fault_addr - mapping->virtual_addr) / PAGE_FRAME_SIZE;
+  void *page_addr = (void *)(mapping->virtual_addr + page * PAGE_FRAME_SIZE);
+  bool shared_writable = (mapping->flags & MMAP_SHARED) && (mapping->prot & MMAP_PROT_WRITE);
+
+  if (!(error_code & PAGE_FAULT_PRESENT))
+  {
+    int32_t frame_index = page_cache_get(mapping->inode, mapping->file_offset + page * PAGE_FRAME_SIZE);
+    if (frame_index < 0)
+      return false;
+    // MMAP_PRIVATE selalu dimap read-only dulu, write pertama yang menyalin frame
+    paging_map_frame(page_dir, page_addr, frame_index, shared_writable);
+    if (!write || shared_writable)
+      return true;
+  }
+
+  // Write ke page read-only: copy-on-write untuk MMAP_PRIVATE yang belum disalin
+  if (!(mapping->flags & MMAP_PRIVATE) || (mapping->private_pages & (1u << page)))
+    return false;
+
+  int32_t copy_frame = paging_allocate_frame();
+  if (copy_frame < 0)
+    return false;
+  memcpy(paging_kmap_frame(copy_frame), page_addr, PAGE_FRAME_SIZE);
+  paging_kunmap_frame();
+
+  page_cache_put(paging_unmap_user_page(page_dir, page_addr));
+  paging_map_frame(page_dir, page_addr, copy_frame, true);
+  mapping->private_pages |= 1u << page;
+  return true;
+}
+
+static int8_t writeback_page(struct PageDirectory *page_dir, struct MemoryMapping *mapping, uint32_t page)
+{
+  uint32_t page_addr = mapping->virtual_addr + page * PAGE_FRAME_SIZE;
+  volatile struct PageDirectoryEntry *entry = &page_dir->table[page_addr >> 22];
+  if (!entry->flag.present_bit || !entry->flag.dirty_bit)
+    return 0;
+
+  int8_t result = 0;
+  struct EXT2Inode node;
+  read_inode(mapping->inode, &node);
+
+  // Writeback tidak pernah memperbesar file, data setelah EOF dibuang
+  uint32_t file_pos = mapping->file_offset + page * PAGE_FRAME_SIZE;
+  uint32_t length = 0;
+  if (file_pos < node.i_size)
+    length = node.i_size - file_pos < PAGE_FRAME_SIZE ? node.i_size - file_pos : PAGE_FRAME_SIZE;
+
+  // Dirty bit per 4 MiB, jadi bandingkan per blok: hanya blok yang benar-benar berubah
+  // yang ditulis, blok reflink yang sama tidak ikut di-unshare
+  const uint8_t *data = (const uint8_t *)page_addr;
+  uint8_t *disk_buf = kmem_cache_alloc(kmem_block_cache);
+  if (disk_buf == NULL)
+    return -1;
+  for (uint32_t offset = 0; offset < length; offset += BLOCK_SIZE)
+  {
+    uint32_t chunk = length - offset < BLOCK_SIZE ? length - offset : BLOCK_SIZE;
+    read_inode_range(&node, disk_buf, file_pos + offset, chunk);
+    if (memcmp(disk_buf, data + offset, chunk) == 0)
+      continue;
+    if (write_inode_at(mapping->inode, data + offset, chunk, file_pos + offset) != 0)
+      result = -1;
+    read_inode(mapping->inode, &node); // i_block bisa berubah (alokasi / unshare)
+  }
+  kmem_cache_free(kmem_block_cache, disk_buf);
+
+  entry->flag.dirty_bit = 0;
+  flush_single_tlb((void *)page_addr);
+  return result;
+}
+
+int8_t mmap_sync(struct PageDirectory *page_dir, struct MemoryMapping *mappings, void *addr)
+{
+  struct MemoryMapping *mapping = find_mapping(mappings, (uint32_t)addr);
+  if (mapping == NULL)
+    return 1;
+  if (!(mapping->flags & MMAP_SHARED) || !(mapping->prot & MMAP_PROT_WRITE) || mapping->inode == 0)
+    return 0;
+
+  int8_t result = 0;
+  for (uint32_t page = 0; page < mapping->page_count; page++)
+    if (writeback_page(page_dir, mapping, page) != 0)
+      result = -1;
+  return result;
+}
+
+int8_t mmap_remove(struct PageDirectory *page_dir, struct MemoryMapping *mappings, void *addr)
+{
+  struct MemoryMapping *mapping = find_mapping(mappings, (uint32_t)addr);
+  if (mapping == NULL || mapping->virtual_addr != (uint32_t)addr)
+    return 1;
+
+  int8_t result = mmap_sync(page_dir, mappings, addr);
+  for (uint32_t page = 0; page < mapping->page_count; page++)
+  {
+    int32_t frame_index = paging_unmap_user_page(page_dir, (void *)(mapping->virtual_addr + page * PAGE_FRAME_SIZE));
+    if (frame_index < 0)
+      continue;
+    if (mapping->private_pages & (1u << page))
+      paging_free_frame(frame_index);
+    else
+      page_cache_put(frame_index);
+  }
+  memset(mapping, 0, sizeof(*mapping));
+  return result;
+}
+
+void mmap_remove_all(struct PageDirectory *page_dir, struct MemoryMapping *mappings)
+{
+  for (uint32_t i = 0; i < PROCESS_MMAP_COUNT_MAX; i++)
+    if (mappings[i].used)
+      mmap_remove(page_dir, mappings, (void *)mappings[i].virtual_addr);
+}
+
+void mmap_invalidate_file(struct EXT2DriverRequest *request, bool detach)
+{
+  uint32_t inode;
+  struct EXT2Inode node;
+  if (!resolve_file(request, &inode, &node))
+    return;
+
+  for (struct PageCacheEntry *entry = page_cache; entry != NULL; entry = entry->next)
+    if (entry->inode == inode)
+      entry->stale = true;
+  process_image_cache_invalidate(inode);
+
+  if (!detach)
+    return;
+  for (uint32_t p = 0; p < PROCESS_COUNT_MAX; p++)
+  {
+    if (_process_list[p] == NULL)
+      continue;
+    for (uint32_t i = 0; i < PROCESS_MMAP_COUNT_MAX; i++)
+      if (_process_list[p]->memory.mappings[i].inode == inode)
+        _process_list[p]->memory.mappings[i].inode = 0;
+  }
+}
+
+void mmap_invalidate_freed_inodes(void)
+{
+  for (struct PageCacheEntry *entry = page_cache; entry != NULL; entry = entry->next)
+    if (!entry->stale && entry->inode != 0 && !is_inode_used(entry->inode))
+      entry->stale = true;
+  process_image_cache_invalidate_freed();
+
+  for (uint32_t p = 0; p < PROCESS_COUNT_MAX; p++)
+  {
+    if (_process_list[p] == NULL)
+      continue;
+    for (uint32_t i = 0; i < PROCESS_MMAP_COUNT_MAX; i++)
+    {
+      struct MemoryMapping *mapping = &_process_list[p]->memory.mappings[i];
+      if (mapping->used && mapping->inode != 0 && !is_inode_used(mapping->inode))
+        mapping->inode = 0;
+    }
+  }
+}
+
+void mmap_invalidate_all(void)
+{
+  for (struct PageCacheEntry *entry = page_cache; entry != NULL; entry = entry->next)
+    entry->stale = true;
+  process_image_cache_invalidate(0);
+
+  for (uint32_t p = 0; p < PROCESS_COUNT_MAX; p++)
+  {
+    if (_process_list[p] == NULL)
+      continue;
+    for (uint32_t i = 0; i < PROCESS_MMAP_COUNT_MAX; i++)
+      _process_list[p]->memory.mappings[i].inode = 0;
+  }
+}
@@ -23,11 +23,15 @@ __attribute__((aligned(0x1000))) struct PageDirectory _paging_kernel_page_direct
         },
     }};
 
-static struct PageManagerState page_manager_state = {
-    .page_frame_map = {
-        [0] = true,
-        [1 ... PAGE_FRAME_MAX_COUNT - 1] = false},
-    .free_page_frame_count = PAGE_FRAME_MAX_COUNT - 1};
+// Dibangun oleh paging_init(), frame 0 (kernel) tidak pernah masuk free list
+static struct PageManagerState page_manager_state;
+
+// Salinan memory map bootloader, dibaca sekali oleh paging_init()
+static struct PagingMemoryRange memory_ranges[PAGING_MEMORY_RANGE_COUNT_MAX];
+static uint32_t memory_range_count;
+
+// Dihitung sejak boot, dibaca lewat paging_get_tlb_statistics()
+static struct PagingTLBStatistics tlb_statistics;
 
 void update_page_directory_entry(
     struct PageDirectory *page_dir,
@@ -56,12 +60,14 @@ void update_page_directory_entry(
 
 void flush_single_tlb(void *virtual_addr)
 {
+  tlb_statistics.flush_single_count++;
   asm volatile("invlpg (%0)" : /* <Empty> */ : "b"(virtual_addr) : "memory");
 }
 
 void flush_tlb_all(void)
 {
-  // Flush entire TLB by reloading CR3
+  // Flush entire TLB by reloading CR3, entry global (direct map kernel) tetap tinggal
+  tlb_statistics.flush_all_count++;
   uint32_t cr3;
   asm volatile("mov %%cr3, %0" : "=r"(cr3));
   asm volatile("mov %0, %%cr3" : : "r"(cr3) : "memory");
@@ -70,8 +76,10 @@ void flush_tlb_all(void)
 /* --- Memory Management --- */
 bool paging_allocate_check(uint32_t amount)
 {
-  uint32_t required_frames = (amount + PAGE_FRAME_SIZE - 1) / PAGE_FRAME_SIZE;
-  return page_manager_state.free_page_frame_count >= required_frames;
+  // Dihitung dalam small page: frame bebas bisa dipecah, sisa frame yang sudah dipecah juga terpakai.
+  // Hanya zone NORMAL, page 4 KiB tidak pernah diambil dari highmem
+  uint32_t required_pages = (amount + PAGE_SMALL_SIZE - 1) / PAGE_SMALL_SIZE;
+  return page_manager_state.zone_free_page_count[PAGE_ZONE_NORMAL] >= required_pages;
 }
 
 bool paging_allocate_user_page_frame(struct PageDirectory *page_dir, void *virtual_addr)
@@ -96,24 +104,12 @@ bool paging_allocate_user_page_frame(struct PageDirectory *page_dir, void *virtu
   }
 
   // Find free physical frame
-  uint32_t frame_index;
-  for (frame_index = 1; frame_index < PAGE_FRAME_MAX_COUNT; frame_index++)
-  {
-    if (!page_manager_state.page_frame_map[frame_index])
-    {
-      break;
-    }
-  }
-
-  if (frame_index >= PAGE_FRAME_MAX_COUNT)
+  int32_t frame_index = paging_allocate_frame();
+  if (frame_index < 0)
   {
     return false; // No free frames
   }
 
-  // Mark frame as used
-  page_manager_state.page_frame_map[frame_index] = true;
-  page_manager_state.free_page_frame_count--;
-
   // Set user flags
   struct PageDirectoryEntryFlag flag = {
       .present_bit = 1,
@@ -153,8 +149,8 @@ bool paging_free_user_page_frame(struct PageDirectory *page_dir, void *virtual_a
     return false; // Tolak kernel space
   }
 
-  // Check if the page is allocated
-  if (!page_dir->table[page_index].flag.present_bit)
+  // Check if the page is allocated, PDE page table dilepas lewat paging_free_page_directory
+  if (!page_dir->table[page_index].flag.present_bit || !page_dir->table[page_index].flag.use_pagesize_4_mb)
   {
     return false; // Not allocated
   }
@@ -164,14 +160,13 @@ bool paging_free_user_page_frame(struct PageDirectory *page_dir, void *virtual_a
                          (page_dir->table[page_index].higher_address << 10);
 
   // Validate frame index
-  if (frame_index >= PAGE_FRAME_MAX_COUNT || frame_index == 0)
+  if (frame_index >= page_manager_state.frame_count || frame_index == 0)
   {
     return false; // Invalid frame or reserved frame
   }
 
   // Mark frame as free
-  page_manager_state.page_frame_map[frame_index] = false;
-  page_manager_state.free_page_frame_count++;
+  paging_free_frame(frame_index);
 
   // Clear page directory entry
   page_dir->table[page_index].flag.present_bit = 0;
@@ -228,6 +223,7 @@ void paging_activate(struct PageDirectory *page_dir)
   uint32_t cr0;
   asm volatile("mov %%cr0, %0" : "=r"(cr0));
   cr0 |= 0x80000000; // PG flag (bit 31)
+  cr0 |= 0x00010000; // WP flag (bit 16), kernel juga fault saat menulis page read-only (COW mmap)
   asm volatile("mov %0, %%cr0" : : "r"(cr0) : "memory");
 
   // Full TLB flush after enabling paging
@@ -237,7 +233,8 @@ void paging_activate(struct PageDirectory *page_dir)
 // Additional utility functions
 uint32_t paging_get_free_frame_count(void)
 {
-  return page_manager_state.free_page_frame_count;
+  return page_manager_state.free_block_count[PAGE_ZONE_NORMAL][PAGE_BUDDY_ORDER_MAX] +
+         page_manager_state.free_block_count[PAGE_ZONE_HIGH][PAGE_BUDDY_ORDER_MAX];
 }
 
 bool paging_is_page_allocated(struct PageDirectory *page_dir, void *virtual_addr)
@@ -275,112 +272,645 @@ bool paging_map_user_page(struct PageDirectory *page_dir, void *virtual_addr, vo
   return true;
 }
 
-__attribute__((aligned(0x1000))) static struct PageDirectory page_directory_list[PAGING_DIRECTORY_TABLE_MAX_COUNT] = {0};
+/* --- Frame-level helpers (mmap) --- */
+static uint32_t buddy_allocate_zone(uint8_t zone, uint8_t order);
 
-static struct
+int32_t paging_allocate_frame(void)
 {
-  bool page_directory_used[PAGING_DIRECTORY_TABLE_MAX_COUNT];
-} page_directory_manager = {
-    .page_directory_used = {false},
-};
+  uint32_t physical_addr = buddy_allocate_zone(PAGE_ZONE_HIGH, PAGE_BUDDY_ORDER_MAX);
+  if (physical_addr == 0)
+    physical_addr = buddy_allocate_zone(PAGE_ZONE_NORMAL, PAGE_BUDDY_ORDER_MAX);
+  return physical_addr == 0 ? -1 : (int32_t)(physical_addr / PAGE_FRAME_SIZE);
+}
 
-struct PageDirectory *paging_create_new_page_directory(void)
+void paging_free_frame(uint32_t frame_index)
+{
+  if (frame_index == 0 || frame_index >= page_manager_state.frame_count ||
+      page_manager_state.page_state[frame_index * PAGE_SMALL_PER_FRAME] != (PAGE_BUDDY_ALLOCATED | PAGE_BUDDY_ORDER_MAX))
+    return;
+  paging_buddy_free(frame_index * PAGE_FRAME_SIZE);
+}
+
+bool paging_map_frame(struct PageDirectory *page_dir, void *virtual_addr, uint32_t frame_index, bool writable)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768 || frame_index == 0 || frame_index >= page_manager_state.frame_count)
+    return false;
+  // Jangan timpa PDE yang menunjuk page table, small page di dalamnya akan bocor
+  if (page_dir->table[page_index].flag.present_bit && !page_dir->table[page_index].flag.use_pagesize_4_mb)
+    return false;
+
+  struct PageDirectoryEntryFlag flag = {
+      .present_bit = 1,
+      .write_bit = writable,
+      .user_bit = 1,
+      .use_pagesize_4_mb = 1};
+  update_page_directory_entry(page_dir, (void *)(frame_index * PAGE_FRAME_SIZE), virtual_addr, flag);
+  return true;
+}
+
+int32_t paging_unmap_user_page(struct PageDirectory *page_dir, void *virtual_addr)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768 || !page_dir->table[page_index].flag.present_bit ||
+      !page_dir->table[page_index].flag.use_pagesize_4_mb)
+    return -1;
+
+  int32_t frame_index = page_dir->table[page_index].lower_address;
+  page_dir->table[page_index] = (struct PageDirectoryEntry){0};
+  flush_single_tlb(virtual_addr);
+  return frame_index;
+}
+
+// Slot kmap hanya dipakai untuk frame di luar direct map
+static bool kmap_slot_used = false;
+
+void *paging_kmap_frame(uint32_t frame_index)
+{
+  if (frame_index < page_manager_state.direct_map_frame_count)
+    return paging_physical_to_virtual(frame_index * PAGE_FRAME_SIZE);
+
+  // Slot kernel tunggal di page directory aktif, user_bit 0 sehingga tidak terlihat dari ring 3
+  struct PageDirectoryEntryFlag flag = {
+      .present_bit = 1,
+      .write_bit = 1,
+      .use_pagesize_4_mb = 1};
+  update_page_directory_entry(paging_get_current_page_directory_addr(), (void *)(frame_index * PAGE_FRAME_SIZE),
+                              PAGING_KMAP_VIRTUAL_ADDR, flag);
+  kmap_slot_used = true;
+  return PAGING_KMAP_VIRTUAL_ADDR;
+}
+
+void paging_kunmap_frame(void)
+{
+  if (!kmap_slot_used)
+    return;
+  uint32_t page_index = ((uint32_t)PAGING_KMAP_VIRTUAL_ADDR >> 22) & 0x3FF;
+  paging_get_current_page_directory_addr()->table[page_index] = (struct PageDirectoryEntry){0};
+  flush_single_tlb(PAGING_KMAP_VIRTUAL_ADDR);
+  kmap_slot_used = false;
+}
+
+/* --- Buddy allocator --- */
+static uint8_t page_zone(uint32_t page)
+{
+  return page < page_manager_state.direct_map_frame_count * PAGE_SMALL_PER_FRAME ? PAGE_ZONE_NORMAL : PAGE_ZONE_HIGH;
+}
+
+static void buddy_list_push(uint32_t page, uint8_t order)
+{
+  uint8_t zone = page_zone(page);
+  uint32_t head = page_manager_state.free_list_head[zone][order];
+  page_manager_state.page_next[page] = head;
+  page_manager_state.page_prev[page] = PAGE_BUDDY_NONE;
+  if (head != PAGE_BUDDY_NONE)
+    page_manager_state.page_prev[head] = page;
+  page_manager_state.free_list_head[zone][order] = page;
+  page_manager_state.free_block_count[zone][order]++;
+  page_manager_state.page_state[page] = PAGE_BUDDY_FREE | order;
+}
+
+static void buddy_list_remove(uint32_t page, uint8_t order)
+{
+  uint8_t zone = page_zone(page);
+  uint32_t next = page_manager_state.page_next[page];
+  uint32_t prev = page_manager_state.page_prev[page];
+  if (prev != PAGE_BUDDY_NONE)
+    page_manager_state.page_next[prev] = next;
+  else
+    page_manager_state.free_list_head[zone][order] = next;
+  if (next != PAGE_BUDDY_NONE)
+    page_manager_state.page_prev[next] = prev;
+  page_manager_state.free_block_count[zone][order]--;
+  page_manager_state.page_state[page] = 0;
+}
+
+static void memory_range_add(uint64_t addr, uint64_t length, bool usable)
+{
+  const uint64_t limit = (uint64_t)PAGE_FRAME_MAX_COUNT * PAGE_FRAME_SIZE;
+  if (memory_range_count >= PAGING_MEMORY_RANGE_COUNT_MAX || length == 0 || addr >= limit)
+    return;
+  uint64_t end = addr + length > limit ? limit : addr + length;
+  // RAM dibulatkan ke dalam, range reserved ke luar: page yang hanya sebagian RAM tidak pernah dipakai
+  uint32_t start_page = usable ? (uint32_t)((addr + PAGE_SMALL_SIZE - 1) >> 12) : (uint32_t)(addr >> 12);
+  uint32_t end_page = usable ? (uint32_t)(end >> 12) : (uint32_t)((end + PAGE_SMALL_SIZE - 1) >> 12);
+  if (start_page >= end_page)
+    return;
+  memory_ranges[memory_range_count].start_page = start_page;
+  memory_ranges[memory_range_count].end_page = end_page;
+  memory_ranges[memory_range_count].usable = usable;
+  memory_range_count++;
+}
+
+/**
+ * Salin memory map multiboot ke memory_ranges. Tanpa memory map dipakai mem_upper (RAM kontigu mulai 1 MiB),
+ * tanpa keduanya 0 .. PAGING_FALLBACK_MEMORY_MB. Buffer memory map harus ada di frame 0 (terlihat di direct map awal)
+ */
+static void memory_map_parse(struct MultibootInfo *multiboot_info)
 {
-  // Iterate through page_directory_list to find an unused page directory
-  for (int i = 0; i < PAGING_DIRECTORY_TABLE_MAX_COUNT; i++)
+  memory_range_count = 0;
+  if (multiboot_info && (multiboot_info->flags & MULTIBOOT_INFO_MEMORY_MAP) &&
+      multiboot_info->mmap_addr + multiboot_info->mmap_length <= PAGE_FRAME_SIZE)
   {
-    if (!page_directory_manager.page_directory_used[i])
+    uint32_t offset = 0;
+    while (offset + sizeof(struct MultibootMemoryMapEntry) <= multiboot_info->mmap_length)
     {
-      // Mark this page directory as used
-      page_directory_manager.page_directory_used[i] = true;
+      struct MultibootMemoryMapEntry *entry = paging_physical_to_virtual(multiboot_info->mmap_addr + offset);
+      memory_range_add(entry->addr, entry->length, entry->type == MULTIBOOT_MEMORY_AVAILABLE);
+      offset += entry->size + sizeof(entry->size);
+    }
+  }
+  else if (multiboot_info && (multiboot_info->flags & MULTIBOOT_INFO_MEMORY))
+  {
+    memory_range_add(0x100000, (uint64_t)multiboot_info->mem_upper << 10, true);
+  }
 
-      // Get pointer to the page directory
-      struct PageDirectory *page_dir = &page_directory_list[i];
+  bool any_usable = false;
+  for (uint32_t i = 0; i < memory_range_count; i++)
+    any_usable |= memory_ranges[i].usable;
+  if (!any_usable)
+    memory_range_add(0, (uint64_t)PAGING_FALLBACK_MEMORY_MB << 20, true);
+}
 
-      // Clear the entire page directory first
-      for (int j = 0; j < 1024; j++)
-      {
-        page_dir->table[j] = (struct PageDirectoryEntry){0};
-      }
+/**
+ * Carve-out metadata buddy: range RAM pertama di direct map (di atas frame kernel) yang muat
+ *
+ * @return Page pertama carve-out, 0 jika tidak ada range yang cukup besar
+ */
+static uint32_t buddy_find_metadata_pages(uint32_t page_count_needed)
+{
+  uint32_t direct_map_end = page_manager_state.direct_map_frame_count * PAGE_SMALL_PER_FRAME;
+  for (uint32_t i = 0; i < memory_range_count; i++)
+  {
+    if (!memory_ranges[i].usable)
+      continue;
+    uint32_t start = memory_ranges[i].start_page > PAGE_SMALL_PER_FRAME ? memory_ranges[i].start_page : PAGE_SMALL_PER_FRAME;
+    uint32_t end = memory_ranges[i].end_page < direct_map_end ? memory_ranges[i].end_page : direct_map_end;
+    if (end > start && end - start >= page_count_needed)
+      return start;
+  }
+  return 0;
+}
+
+static void buddy_init(void)
+{
+  // Metadata 10 byte per page. Jika tidak ada range yang muat, memori yang dikelola diperkecil
+  uint32_t metadata_page = 0, metadata_page_count = 0;
+  while (page_manager_state.frame_count > 1)
+  {
+    page_manager_state.page_count = page_manager_state.frame_count * PAGE_SMALL_PER_FRAME;
+    metadata_page_count = (page_manager_state.page_count * (2 * sizeof(uint32_t) + 2 * sizeof(uint8_t)) +
+                           PAGE_SMALL_SIZE - 1) / PAGE_SMALL_SIZE;
+    metadata_page = buddy_find_metadata_pages(metadata_page_count);
+    if (metadata_page != 0)
+      break;
+    page_manager_state.frame_count /= 2;
+    if (page_manager_state.direct_map_frame_count > page_manager_state.frame_count)
+      page_manager_state.direct_map_frame_count = page_manager_state.frame_count;
+  }
+  if (metadata_page == 0)
+  {
+    page_manager_state.frame_count = page_manager_state.page_count = 0;
+    return;
+  }
+
+  uint32_t page_count = page_manager_state.page_count;
+  page_manager_state.page_next = paging_physical_to_virtual(metadata_page * PAGE_SMALL_SIZE);
+  page_manager_state.page_prev = page_manager_state.page_next + page_count;
+  page_manager_state.page_state = (uint8_t *)(page_manager_state.page_prev + page_count);
+  page_manager_state.page_share_count = page_manager_state.page_state + page_count;
+  memset(page_manager_state.page_state, 0, page_count);
+  memset(page_manager_state.page_share_count, 0, page_count);
+  for (uint8_t zone = 0; zone < PAGE_ZONE_COUNT; zone++)
+  {
+    for (uint8_t order = 0; order <= PAGE_BUDDY_ORDER_MAX; order++)
+    {
+      page_manager_state.free_list_head[zone][order] = PAGE_BUDDY_NONE;
+      page_manager_state.free_block_count[zone][order] = 0;
+    }
+    page_manager_state.zone_free_page_count[zone] = 0;
+  }
+  page_manager_state.free_page_count = 0;
+  page_manager_state.usable_page_count = 0;
+
+  // RAM ditandai dulu lalu range reserved dihapus, sehingga range yang tumpang tindih tetap aman
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    for (uint32_t i = 0; i < memory_range_count; i++)
+    {
+      if (memory_ranges[i].usable != (pass == 0))
+        continue;
+      uint32_t end = memory_ranges[i].end_page < page_count ? memory_ranges[i].end_page : page_count;
+      for (uint32_t page = memory_ranges[i].start_page; page < end; page++)
+        page_manager_state.page_state[page] = pass == 0 ? PAGE_BUDDY_USABLE : 0;
+    }
+  }
+  // Frame 0 berisi kernel
+  memset(page_manager_state.page_state, 0, PAGE_SMALL_PER_FRAME);
+  memset(page_manager_state.page_state + metadata_page, 0, metadata_page_count);
 
-      // Create kernel higher half page directory entry
-      struct PageDirectoryEntryFlag kernel_flag = {
-          .present_bit = 1,
-          .write_bit = 1,
-          .user_bit = 0, // Kernel space
-          .write_through_bit = 0,
-          .cache_disable_bit = 0,
-          .accessed_bit = 0,
-          .dirty_bit = 0,
-          .use_pagesize_4_mb = 1};
-
-      // Set page_directory.table[0x300] with kernel page directory entry
-      // 0x300 = 768, which maps to 0xC0000000 (3GB) - kernel space
-      page_dir->table[0x300].flag = kernel_flag;
-      page_dir->table[0x300].lower_address = 0; // Physical address 0
-      page_dir->table[0x300].higher_address = 0;
-      page_dir->table[0x300].global_page = 0;
-      page_dir->table[0x300].pat = 0;
-      page_dir->table[0x300].reserved_1 = 0;
-      page_dir->table[0x300].reserved_2 = 0;
-
-      return page_dir;
+  // Setiap run page RAM dipecah menjadi blok aligned terbesar, blok order maksimum = satu frame utuh
+  uint32_t page = 0;
+  while (page < page_count)
+  {
+    if (page_manager_state.page_state[page] != PAGE_BUDDY_USABLE)
+    {
+      page++;
+      continue;
+    }
+    uint32_t end = page;
+    while (end < page_count && page_manager_state.page_state[end] == PAGE_BUDDY_USABLE)
+      page_manager_state.page_state[end++] = 0;
+    while (page < end)
+    {
+      uint8_t order = PAGE_BUDDY_ORDER_MAX;
+      while (order > 0 && ((page & ((1u << order) - 1)) != 0 || page + (1u << order) > end))
+        order--;
+      buddy_list_push(page, order);
+      page_manager_state.zone_free_page_count[page_zone(page)] += 1u << order;
+      page_manager_state.free_page_count += 1u << order;
+      page += 1u << order;
     }
   }
+  page_manager_state.usable_page_count = page_manager_state.free_page_count;
+}
 
-  // No available page directories
-  return NULL;
+static uint32_t buddy_allocate_zone(uint8_t zone, uint8_t order)
+{
+  if (order > PAGE_BUDDY_ORDER_MAX)
+    return 0;
+
+  // Order terkecil yang punya blok bebas, lalu pecah: separuh atas kembali ke free list order di bawahnya
+  uint8_t found = order;
+  while (found <= PAGE_BUDDY_ORDER_MAX && page_manager_state.free_list_head[zone][found] == PAGE_BUDDY_NONE)
+    found++;
+  if (found > PAGE_BUDDY_ORDER_MAX)
+    return 0;
+
+  uint32_t page = page_manager_state.free_list_head[zone][found];
+  buddy_list_remove(page, found);
+  while (found > order)
+  {
+    found--;
+    buddy_list_push(page + (1u << found), found);
+  }
+  page_manager_state.page_state[page] = PAGE_BUDDY_ALLOCATED | order;
+  page_manager_state.free_page_count -= 1u << order;
+  page_manager_state.zone_free_page_count[zone] -= 1u << order;
+  return page * PAGE_SMALL_SIZE;
 }
 
-bool paging_free_page_directory(struct PageDirectory *page_dir)
+uint32_t paging_buddy_allocate(uint8_t order)
 {
-  if (!page_dir)
+  return buddy_allocate_zone(PAGE_ZONE_NORMAL, order);
+}
+
+void paging_buddy_free(uint32_t physical_addr)
+{
+  uint32_t page = physical_addr / PAGE_SMALL_SIZE;
+  if (page >= page_manager_state.page_count || (physical_addr & (PAGE_SMALL_SIZE - 1)) != 0 ||
+      !(page_manager_state.page_state[page] & PAGE_BUDDY_ALLOCATED))
+    return;
+
+  uint8_t order = page_manager_state.page_state[page] & PAGE_BUDDY_ORDER_MASK;
+  page_manager_state.page_state[page] = 0;
+  page_manager_state.free_page_count += 1u << order;
+  page_manager_state.zone_free_page_count[page_zone(page)] += 1u << order;
+
+  // Gabung dengan buddy selama buddy juga blok bebas dengan order yang sama
+  while (order < PAGE_BUDDY_ORDER_MAX)
+  {
+    uint32_t buddy = page ^ (1u << order);
+    if (buddy >= page_manager_state.page_count || page_manager_state.page_state[buddy] != (PAGE_BUDDY_FREE | order))
+      break;
+    buddy_list_remove(buddy, order);
+    page = page < buddy ? page : buddy;
+    order++;
+  }
+  buddy_list_push(page, order);
+}
+
+/* --- 4 KiB page helpers --- */
+static void set_direct_map(struct PageDirectory *page_dir)
+{
+  struct PageDirectoryEntryFlag kernel_flag = {
+      .present_bit = 1,
+      .write_bit = 1,
+      .user_bit = 0, // Kernel space
+      .use_pagesize_4_mb = 1};
+  for (uint32_t frame_index = 0; frame_index < page_manager_state.direct_map_frame_count; frame_index++)
+  {
+    uint32_t page_index = (PAGING_DIRECT_MAP_BASE >> 22) + frame_index;
+    page_dir->table[page_index] = (struct PageDirectoryEntry){0};
+    page_dir->table[page_index].flag = kernel_flag;
+    page_dir->table[page_index].lower_address = frame_index & 0x3FF;
+    // Sama di semua page directory: global, tidak di-flush saat CR3 diganti
+    page_dir->table[page_index].global_page = 1;
+  }
+}
+
+void paging_init(struct MultibootInfo *multiboot_info)
+{
+  // Frame sampai akhir RAM tertinggi, direct map dipasang dulu supaya carve-out metadata bisa ditulis
+  memory_map_parse(multiboot_info);
+  uint32_t last_page = 0;
+  for (uint32_t i = 0; i < memory_range_count; i++)
+    if (memory_ranges[i].usable && memory_ranges[i].end_page > last_page)
+      last_page = memory_ranges[i].end_page;
+  page_manager_state.frame_count = (last_page + PAGE_SMALL_PER_FRAME - 1) / PAGE_SMALL_PER_FRAME;
+  page_manager_state.direct_map_frame_count = page_manager_state.frame_count < PAGING_DIRECT_MAP_FRAME_MAX
+                                                  ? page_manager_state.frame_count
+                                                  : PAGING_DIRECT_MAP_FRAME_MAX;
+  set_direct_map(&_paging_kernel_page_directory);
+  buddy_init();
+  // CR0.WP: tulisan kernel ke page user read-only (copy-on-write) juga menghasilkan page fault
+  __asm__ volatile("mov %%cr0, %%eax; or $0x10000, %%eax; mov %%eax, %%cr0" : : : "eax", "memory");
+  // CR4.PGE (bit 7) jika CPUID.01h:EDX.PGE (bit 13) ada, mengubah PGE sekaligus flush semua entry termasuk global
+  uint32_t cpuid_eax = 1, cpuid_ebx, cpuid_ecx = 0, cpuid_edx;
+  __asm__ volatile("cpuid" : "+a"(cpuid_eax), "=b"(cpuid_ebx), "+c"(cpuid_ecx), "=d"(cpuid_edx));
+  (void)cpuid_ebx;
+  if (cpuid_edx & (1u << 13))
+    __asm__ volatile("mov %%cr4, %%eax; or $0x80, %%eax; mov %%eax, %%cr4" : : : "eax", "memory");
+  flush_tlb_all();
+}
+
+void *paging_physical_to_virtual(uint32_t physical_addr)
+{
+  return (void *)(physical_addr + PAGING_DIRECT_MAP_BASE);
+}
+
+uint32_t paging_virtual_to_physical(void *virtual_addr)
+{
+  return (uint32_t)virtual_addr - PAGING_DIRECT_MAP_BASE;
+}
+
+uint32_t paging_allocate_small_page(void)
+{
+  return paging_buddy_allocate(0);
+}
+
+void paging_free_small_page(uint32_t physical_addr)
+{
+  uint32_t page = physical_addr / PAGE_SMALL_SIZE;
+  if (page < PAGE_SMALL_PER_FRAME || page >= page_manager_state.page_count ||
+      page_manager_state.page_state[page] != PAGE_BUDDY_ALLOCATED)
+    return;
+  // Page yang masih dibagi proses lain (fork) hanya dilepas oleh pemilik terakhir
+  if (page_manager_state.page_share_count[page] > 0)
+  {
+    page_manager_state.page_share_count[page]--;
+    return;
+  }
+  paging_buddy_free(physical_addr);
+}
+
+// PDE yang menunjuk page table: bit 31:12 alamat fisik page table, layout field 4 MiB tidak berlaku
+static uint32_t page_table_physical_addr(struct PageDirectory *page_dir, uint32_t page_index)
+{
+  return *(volatile uint32_t *)&page_dir->table[page_index] & ~0xFFFu;
+}
+
+static struct PageTable *get_page_table(struct PageDirectory *page_dir, uint32_t page_index, bool create)
+{
+  volatile struct PageDirectoryEntry *entry = &page_dir->table[page_index];
+  if (entry->flag.present_bit)
+  {
+    if (entry->flag.use_pagesize_4_mb)
+      return NULL;
+    return paging_physical_to_virtual(page_table_physical_addr(page_dir, page_index));
+  }
+  if (!create)
+    return NULL;
+
+  // Page table allocator: satu small page per page table, dikosongkan sebelum dipasang
+  uint32_t table_addr = paging_allocate_small_page();
+  if (table_addr == 0)
+    return NULL;
+  struct PageTable *page_table = paging_physical_to_virtual(table_addr);
+  memset(page_table, 0, sizeof(struct PageTable));
+  // present | write | user: hak akses akhir ditentukan PTE
+  *(volatile uint32_t *)entry = table_addr | 0x7;
+  return page_table;
+}
+
+bool paging_map_small_page(struct PageDirectory *page_dir, void *virtual_addr, uint32_t physical_addr, bool writable)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768 || (physical_addr & 0xFFF) != 0)
+    return false;
+  struct PageTable *page_table = get_page_table(page_dir, page_index, true);
+  if (!page_table)
+    return false;
+
+  uint32_t table_index = ((uint32_t)virtual_addr >> 12) & 0x3FF;
+  page_table->table[table_index] = (struct PageTableEntry){
+      .present_bit = 1,
+      .write_bit = writable,
+      .user_bit = 1,
+      .frame_address = physical_addr >> 12};
+  flush_single_tlb(virtual_addr);
+  return true;
+}
+
+uint32_t paging_unmap_small_page(struct PageDirectory *page_dir, void *virtual_addr)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768)
+    return 0;
+  struct PageTable *page_table = get_page_table(page_dir, page_index, false);
+  uint32_t table_index = ((uint32_t)virtual_addr >> 12) & 0x3FF;
+  if (!page_table || !page_table->table[table_index].present_bit)
+    return 0;
+
+  uint32_t physical_addr = page_table->table[table_index].frame_address << 12;
+  page_table->table[table_index] = (struct PageTableEntry){0};
+  flush_single_tlb(virtual_addr);
+  return physical_addr;
+}
+
+bool paging_map_shared_small_page(struct PageDirectory *page_dir, void *virtual_addr, uint32_t physical_addr,
+                                  bool copy_on_write)
+{
+  uint32_t page = physical_addr / PAGE_SMALL_SIZE;
+  if (page >= page_manager_state.page_count || page_manager_state.page_share_count[page] == 0xFF ||
+      !paging_map_small_page(page_dir, virtual_addr, physical_addr, false))
+    return false;
+  if (copy_on_write)
+  {
+    struct PageTable *page_table = get_page_table(page_dir, ((uint32_t)virtual_addr >> 22) & 0x3FF, false);
+    page_table->table[((uint32_t)virtual_addr >> 12) & 0x3FF].available |= PAGE_TABLE_ENTRY_COW;
+  }
+  page_manager_state.page_share_count[page]++;
+  return true;
+}
+
+uint8_t paging_get_small_page_share_count(uint32_t physical_addr)
+{
+  uint32_t page = physical_addr / PAGE_SMALL_SIZE;
+  return page < page_manager_state.page_count ? page_manager_state.page_share_count[page] : 0;
+}
+
+uint32_t paging_get_user_small_page(struct PageDirectory *page_dir, void *virtual_addr)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768)
+    return 0;
+  struct PageTable *page_table = get_page_table(page_dir, page_index, false);
+  if (!page_table || !page_table->table[((uint32_t)virtual_addr >> 12) & 0x3FF].present_bit)
+    return 0;
+  return page_table->table[((uint32_t)virtual_addr >> 12) & 0x3FF].frame_address << 12;
+}
+
+bool paging_allocate_user_small_page(struct PageDirectory *page_dir, void *virtual_addr)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768)
+    return false;
+  struct PageTable *page_table = get_page_table(page_dir, page_index, false);
+  if (page_table && page_table->table[((uint32_t)virtual_addr >> 12) & 0x3FF].present_bit)
+    return true;
+
+  uint32_t physical_addr = paging_allocate_small_page();
+  if (physical_addr == 0)
+    return false;
+  memset(paging_physical_to_virtual(physical_addr), 0, PAGE_SMALL_SIZE);
+  if (!paging_map_small_page(page_dir, (void *)((uint32_t)virtual_addr & ~0xFFFu), physical_addr, true))
   {
+    paging_free_small_page(physical_addr);
     return false;
   }
+  return true;
+}
 
-  // Iterate through page_directory_list to find the matching page directory
-  for (int i = 0; i < PAGING_DIRECTORY_TABLE_MAX_COUNT; i++)
+bool paging_clone_user_pages(struct PageDirectory *dst, struct PageDirectory *src)
+{
+  for (uint32_t page_index = 0; page_index < 768; page_index++)
   {
-    if (&page_directory_list[i] == page_dir)
+    // PDE 4 MiB milik mmap tidak disalin, page table juga hanya dibuat untuk region yang dipakai src
+    struct PageTable *src_table = get_page_table(src, page_index, false);
+    if (!src_table)
+      continue;
+    struct PageTable *dst_table = get_page_table(dst, page_index, true);
+    if (!dst_table)
+      return false;
+
+    for (uint32_t table_index = 0; table_index < PAGE_ENTRY_COUNT; table_index++)
     {
-      // Check if this page directory is actually in use
-      if (!page_directory_manager.page_directory_used[i])
+      volatile struct PageTableEntry *entry = &src_table->table[table_index];
+      if (!entry->present_bit)
+        continue;
+      uint32_t page = entry->frame_address;
+      if (page_manager_state.page_share_count[page] == 0xFF)
+        return false;
+      if (entry->write_bit)
       {
-        return false; // Already free
+        entry->write_bit = 0;
+        entry->available |= PAGE_TABLE_ENTRY_COW;
       }
+      dst_table->table[table_index] = *entry;
+      page_manager_state.page_share_count[page]++;
+    }
+  }
+  // Write bit src baru saja dicabut, TLB lama tidak boleh dipakai lagi
+  if (src == paging_get_current_page_directory_addr())
+    flush_tlb_all();
+  return true;
+}
+
+bool paging_handle_cow_fault(struct PageDirectory *page_dir, void *virtual_addr)
+{
+  uint32_t page_index = ((uint32_t)virtual_addr >> 22) & 0x3FF;
+  if (!page_dir || page_index >= 768)
+    return false;
+  struct PageTable *page_table = get_page_table(page_dir, page_index, false);
+  if (!page_table)
+    return false;
+  volatile struct PageTableEntry *entry = &page_table->table[((uint32_t)virtual_addr >> 12) & 0x3FF];
+  if (!entry->present_bit || !(entry->available & PAGE_TABLE_ENTRY_COW))
+    return false;
+
+  uint32_t page = entry->frame_address;
+  if (page_manager_state.page_share_count[page] > 0)
+  {
+    // Masih dibagi: salin isi ke page baru, referensi ke page lama dilepas
+    uint32_t copy_addr = paging_allocate_small_page();
+    if (copy_addr == 0)
+      return false;
+    memcpy(paging_physical_to_virtual(copy_addr), paging_physical_to_virtual(page * PAGE_SMALL_SIZE), PAGE_SMALL_SIZE);
+    page_manager_state.page_share_count[page]--;
+    entry->frame_address = copy_addr >> 12;
+  }
+  entry->available &= ~PAGE_TABLE_ENTRY_COW;
+  entry->write_bit = 1;
+  flush_single_tlb(virtual_addr);
+  return true;
+}
+
+struct PageDirectory *paging_create_new_page_directory(void)
+{
+  // Page directory = satu page 4 KiB dari buddy, jumlahnya hanya dibatasi memori
+  uint32_t physical_addr = paging_allocate_small_page();
+  if (physical_addr == 0)
+  {
+    // No available page directories
+    return NULL;
+  }
+  struct PageDirectory *page_dir = paging_physical_to_virtual(physical_addr);
+
+  // Clear the entire page directory first
+  for (int j = 0; j < 1024; j++)
+  {
+    page_dir->table[j] = (struct PageDirectoryEntry){0};
+  }
+
+  // Kernel higher half: direct map seluruh memori fisik, 0x300 = 768 maps to 0xC0000000 (3GB)
+  set_direct_map(page_dir);
+  return page_dir;
+}
 
-      // Mark the page directory as unused
-      page_directory_manager.page_directory_used[i] = false;
+bool paging_free_page_directory(struct PageDirectory *page_dir)
+{
+  if (!page_dir || page_dir == &_paging_kernel_page_directory ||
+      (uint32_t)page_dir < PAGING_DIRECT_MAP_BASE + PAGE_FRAME_SIZE)
+  {
+    return false;
+  }
+
+  // Hanya bagian user yang dikosongkan: kernel half tetap valid selama CR3 belum dipindah
+  for (int j = 0; j < 768; j++)
+  {
+    // Before clearing, free any allocated user page frames
+    if (page_dir->table[j].flag.present_bit && page_dir->table[j].flag.use_pagesize_4_mb)
+    {
+      // This is a user page that's allocated
+      uint32_t frame_index = page_dir->table[j].lower_address |
+                             (page_dir->table[j].higher_address << 10);
 
-      // Clear all page directory entries
-      for (int j = 0; j < 1024; j++)
+      // Free the frame if it's valid and not the reserved frame 0
+      if (frame_index > 0 && frame_index < page_manager_state.frame_count)
       {
-        // Before clearing, free any allocated user page frames
-        if (j < 768 && page_dir->table[j].flag.present_bit)
-        {
-          // This is a user page that's allocated
-          uint32_t frame_index = page_dir->table[j].lower_address |
-                                 (page_dir->table[j].higher_address << 10);
-
-          // Free the frame if it's valid and not the reserved frame 0
-          if (frame_index > 0 && frame_index < PAGE_FRAME_MAX_COUNT)
-          {
-            page_manager_state.page_frame_map[frame_index] = false;
-            page_manager_state.free_page_frame_count++;
-          }
-        }
-
-        // Clear the page directory entry
-        page_dir->table[j] = (struct PageDirectoryEntry){0};
+        paging_free_frame(frame_index);
       }
-
-      return true;
     }
+    else if (page_dir->table[j].flag.present_bit)
+    {
+      // Page table: lepas semua small page lalu page table itu sendiri
+      uint32_t table_addr = page_table_physical_addr(page_dir, j);
+      struct PageTable *page_table = paging_physical_to_virtual(table_addr);
+      for (int k = 0; k < PAGE_ENTRY_COUNT; k++)
+      {
+        if (page_table->table[k].present_bit)
+          paging_free_small_page(page_table->table[k].frame_address << 12);
+      }
+      paging_free_small_page(table_addr);
+    }
+
+    // Clear the page directory entry
+    page_dir->table[j] = (struct PageDirectoryEntry){0};
   }
 
-  // Page directory not found in our managed list
-  return false;
+  paging_free_small_page(paging_virtual_to_physical(page_dir));
+  return true;
 }
 
 struct PageDirectory *paging_get_current_page_directory_addr(void)
@@ -397,5 +927,20 @@ void paging_use_page_directory(struct PageDirectory *page_dir_virtual_addr)
   // Additional layer of check & mistake safety net
   if ((uint32_t)page_dir_virtual_addr > KERNEL_VIRTUAL_ADDRESS_BASE)
     physical_addr_page_dir -= KERNEL_VIRTUAL_ADDRESS_BASE;
+
+  // Address space yang sama (proses sama / switch balik): CR3 tidak di-reload, TLB user tetap valid
+  uint32_t current_physical_addr = 0;
+  __asm__ volatile("mov %%cr3, %0" : "=r"(current_physical_addr) : /* <Empty> */);
+  if ((current_physical_addr & ~0xFFFu) == physical_addr_page_dir)
+  {
+    tlb_statistics.cr3_load_skip_count++;
+    return;
+  }
+  tlb_statistics.cr3_load_count++;
   __asm__ volatile("mov %0, %%cr3" : /* <Empty> */ : "r"(physical_addr_page_dir) : "memory");
+}
+
+void paging_get_tlb_statistics(struct PagingTLBStatistics *statistics)
+{
+  *statistics = tlb_statistics;
 }
\ No newline at end of file
@@ -3,8 +3,42 @@
 #include "header/memory/paging.h"
 #include "header/stdlib/string.h"
 #include "header/cpu/gdt.h"
+#include "header/memory/kmalloc.h"
+#include "header/process/elf.h"
 
-struct ProcessControlBlock _process_list[PROCESS_COUNT_MAX];
+// NULL = slot kosong, PCB aktif dialokasikan dari pcb_cache
+struct ProcessControlBlock *_process_list[PROCESS_COUNT_MAX];
+
+static struct KmemCache *pcb_cache = NULL;
+
+/**
+ * Constructor pcb_cache: dijalankan sekali per object. PCB yang dilepas process_destroy sudah kembali
+ * ke keadaan ini (mapping kosong, page_used_count 0) sehingga alokasi berikutnya tidak perlu memset
+ */
+static void pcb_constructor(void *object)
+{
+  memset(object, 0, sizeof(struct ProcessControlBlock));
+}
+
+/**
+ * Satu page image executable di cache, milik cache (owner) dan dibagi read-only ke semua proses
+ * yang menjalankan file yang sama lewat page_share_count
+ *
+ * @param next          Entry berikutnya di bucket yang sama
+ * @param inode         Inode executable
+ * @param page_addr     Alamat virtual page, isi page ditentukan oleh program header executable
+ * @param physical_addr Page fisik berisi isi file + nol
+ */
+struct ImageCacheEntry
+{
+  struct ImageCacheEntry *next;
+  uint32_t inode;
+  uint32_t page_addr;
+  uint32_t physical_addr;
+};
+
+static struct KmemCache *image_cache_entry_cache = NULL;
+static struct ImageCacheEntry *image_cache[PROCESS_IMAGE_CACHE_BUCKET_COUNT];
 
 struct ProcessState process_manager_state = {
     .active_process_count = 0,
@@ -17,9 +51,9 @@ void getActivePCB(struct ProcessControlBlock *ptr, int *count)
   *count = 0;
   for (int i = 0; i < PROCESS_COUNT_MAX; i++)
   {
-    if (_process_list[i].metadata.active)
+    if (_process_list[i] != NULL)
     {
-      ptr[*count] = _process_list[i];
+      ptr[*count] = *_process_list[i];
       (*count)++;
     }
   }
@@ -36,7 +70,7 @@ int process_list_get_inactive_index()
   {
     idx = PROCESS_COUNT_MAX - 1;
   }
-  while (_process_list[idx].metadata.active == true)
+  while (_process_list[idx] != NULL)
   {
     idx--;
     if (idx == -1)
@@ -52,26 +86,369 @@ int process_generate_new_pid()
   return process_manager_state.total_pid;
 }
 
-bool release_memory(struct ProcessControlBlock *pcb)
+static uint32_t image_cache_bucket(uint32_t inode, uint32_t page_addr)
 {
-  for (uint32_t i = 0; i < pcb->memory.page_frame_used_count; i++)
+  return (inode * 31 + page_addr / PAGE_SMALL_SIZE) % PROCESS_IMAGE_CACHE_BUCKET_COUNT;
+}
+
+// Pilihan image_cache_drop_if
+#define IMAGE_CACHE_DROP_UNUSED 0 // Tidak dipetakan proses mana pun (hanya referensi cache yang tersisa)
+#define IMAGE_CACHE_DROP_INODE 1  // Milik inode tertentu, 0 = semua
+#define IMAGE_CACHE_DROP_FREED 2  // Inode-nya sudah bebas di filesystem (dihapus, nomornya bisa dipakai ulang)
+
+static void image_cache_drop_if(uint8_t mode, uint32_t inode)
+{
+  for (uint32_t bucket = 0; bucket < PROCESS_IMAGE_CACHE_BUCKET_COUNT; bucket++)
   {
-    void *addr = pcb->memory.virtual_addr_used[i];
-    paging_free_user_page_frame(pcb->context.page_directory_virtual_addr, addr);
-    pcb->memory.virtual_addr_used[i] = NULL;
+    struct ImageCacheEntry **link = &image_cache[bucket];
+    while (*link != NULL)
+    {
+      struct ImageCacheEntry *entry = *link;
+      bool drop;
+      if (mode == IMAGE_CACHE_DROP_UNUSED)
+        drop = paging_get_small_page_share_count(entry->physical_addr) == 0;
+      else if (mode == IMAGE_CACHE_DROP_INODE)
+        drop = inode == 0 || entry->inode == inode;
+      else
+        drop = entry->inode != 0 && !is_inode_used(entry->inode);
+      if (!drop)
+      {
+        link = &entry->next;
+        continue;
+      }
+      // Page yang masih dipetakan proses lain hanya kehilangan referensi cache
+      *link = entry->next;
+      paging_free_small_page(entry->physical_addr);
+      kmem_cache_free(image_cache_entry_cache, entry);
+    }
   }
+}
+
+static void image_cache_prune(void)
+{
+  image_cache_drop_if(IMAGE_CACHE_DROP_UNUSED, 0);
+}
+
+void process_image_cache_invalidate(uint32_t inode)
+{
+  image_cache_drop_if(IMAGE_CACHE_DROP_INODE, inode);
+}
+
+void process_image_cache_invalidate_freed(void)
+{
+  image_cache_drop_if(IMAGE_CACHE_DROP_FREED, 0);
+}
+
+bool release_memory(struct ProcessControlBlock *pcb)
+{
   struct PageDirectory *cur_run = paging_get_current_page_directory_addr();
   paging_use_page_directory(pcb->context.page_directory_virtual_addr);
+  // Mapping dilepas dulu: frame page cache bukan milik proses, jangan ikut dibebaskan
+  mmap_remove_all(pcb->context.page_directory_virtual_addr, pcb->memory.mappings);
+  // Proses menghancurkan dirinya sendiri (page fault ilegal / kill): jangan tetap di page directory yang dilepas
+  if (cur_run == pcb->context.page_directory_virtual_addr)
+    cur_run = &_paging_kernel_page_directory;
+  paging_use_page_directory(cur_run);
+  // Page 4 KiB yang sempat disentuh dan page table-nya ikut dilepas bersama page directory
   paging_free_page_directory(pcb->context.page_directory_virtual_addr);
-  if (cur_run != pcb->context.page_directory_virtual_addr)
+  image_cache_prune();
+  pcb->memory.page_used_count = 0;
+  pcb->memory.page_fault_count = 0;
+  pcb->memory.heap_break = 0;
+  memset(pcb->memory.regions, 0, sizeof(pcb->memory.regions));
+
+  return true;
+}
+
+struct ProcessControlBlock *process_get_pcb_by_page_directory(struct PageDirectory *page_dir)
+{
+  for (int i = 0; i < PROCESS_COUNT_MAX; i++)
+    if (_process_list[i] != NULL && _process_list[i]->context.page_directory_virtual_addr == page_dir)
+      return _process_list[i];
+  return NULL;
+}
+
+static struct ProcessMemoryRegion *reserve_region(struct ProcessControlBlock *pcb, uint32_t start, uint32_t end, bool writable)
+{
+  for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX; i++)
+  {
+    struct ProcessMemoryRegion *region = &pcb->memory.regions[i];
+    if (region->end != 0)
+      continue;
+    memset(region, 0, sizeof(struct ProcessMemoryRegion));
+    region->start = start & ~(PAGE_SMALL_SIZE - 1);
+    region->end = (end + PAGE_SMALL_SIZE - 1) & ~(PAGE_SMALL_SIZE - 1);
+    region->writable = writable;
+    return region;
+  }
+  return NULL;
+}
+
+/**
+ * Lepas page yang sudah disentuh di [start, end), page directory proses harus sedang aktif.
+ * Page copy-on-write hasil fork hanya mengurangi share count, isinya tetap milik proses lain
+ */
+static void release_region_pages(struct ProcessControlBlock *pcb, uint32_t start, uint32_t end)
+{
+  for (uint32_t page_addr = start; page_addr < end; page_addr += PAGE_SMALL_SIZE)
+  {
+    uint32_t physical_addr = paging_unmap_small_page(pcb->context.page_directory_virtual_addr, (void *)page_addr);
+    if (physical_addr == 0)
+      continue;
+    paging_free_small_page(physical_addr);
+    if (pcb->memory.page_used_count > 0)
+      pcb->memory.page_used_count--;
+  }
+}
+
+uint32_t process_brk(struct ProcessControlBlock *pcb, uint32_t new_break)
+{
+  struct ProcessMemoryRegion *heap = NULL;
+  for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX && heap == NULL; i++)
+    if (pcb->memory.regions[i].end != 0 && pcb->memory.regions[i].type == PROCESS_REGION_HEAP)
+      heap = &pcb->memory.regions[i];
+  if (heap == NULL)
+    return 0;
+  if (new_break == 0 || new_break < heap->start || new_break > MMAP_REGION_START)
+    return pcb->memory.heap_break;
+
+  // Page tetap lazy, cek memori hanya supaya malloc menerima kegagalan alih-alih proses dihentikan saat fault
+  uint32_t new_end = (new_break + PAGE_SMALL_SIZE - 1) & ~(PAGE_SMALL_SIZE - 1);
+  if (new_end > heap->end && !paging_allocate_check(new_end - heap->end))
+    return pcb->memory.heap_break;
+  if (new_end < heap->end)
+    release_region_pages(pcb, new_end, heap->end);
+  heap->end = new_end;
+  pcb->memory.heap_break = new_break;
+  return new_break;
+}
+
+void *process_mmap_anonymous(struct ProcessControlBlock *pcb, uint32_t size, bool writable)
+{
+  uint32_t length = (size + PAGE_SMALL_SIZE - 1) & ~(PAGE_SMALL_SIZE - 1);
+  if (size == 0 || length == 0 || length > PROCESS_ANONYMOUS_MMAP_END - PROCESS_ANONYMOUS_MMAP_START)
+    return NULL;
+
+  // First fit: kandidat digeser ke akhir setiap region yang bertabrakan sampai tidak ada lagi
+  uint32_t start = PROCESS_ANONYMOUS_MMAP_START;
+  bool moved = true;
+  while (moved && start <= PROCESS_ANONYMOUS_MMAP_END - length)
+  {
+    moved = false;
+    for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX; i++)
+    {
+      struct ProcessMemoryRegion *region = &pcb->memory.regions[i];
+      if (region->end != 0 && region->start < start + length && region->end > start)
+      {
+        start = region->end;
+        moved = true;
+      }
+    }
+  }
+  if (start > PROCESS_ANONYMOUS_MMAP_END - length)
+    return NULL;
+
+  struct ProcessMemoryRegion *region = reserve_region(pcb, start, start + length, writable);
+  if (region == NULL)
+    return NULL;
+  region->type = PROCESS_REGION_ANONYMOUS;
+  return (void *)start;
+}
+
+int8_t process_munmap_anonymous(struct ProcessControlBlock *pcb, void *addr)
+{
+  for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX; i++)
+  {
+    struct ProcessMemoryRegion *region = &pcb->memory.regions[i];
+    if (region->end == 0 || region->type != PROCESS_REGION_ANONYMOUS || region->start != (uint32_t)addr)
+      continue;
+    release_region_pages(pcb, region->start, region->end);
+    memset(region, 0, sizeof(struct ProcessMemoryRegion));
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * Isi page baru dari semua region file yang menyentuh page_addr. Segment ELF yang berbagi satu page
+ * (linker script tanpa align page) masing-masing menyumbang bagiannya, sisa page tetap nol
+ */
+static void fill_file_page(struct ProcessControlBlock *pcb, uint8_t *page, uint32_t page_addr)
+{
+  for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX; i++)
+  {
+    struct ProcessMemoryRegion *region = &pcb->memory.regions[i];
+    if (region->end == 0 || region->inode == 0)
+      continue;
+    uint32_t from = region->file_start > page_addr ? region->file_start : page_addr;
+    uint32_t to = region->file_end < page_addr + PAGE_SMALL_SIZE ? region->file_end : page_addr + PAGE_SMALL_SIZE;
+    if (from >= to)
+      continue;
+    struct EXT2Inode node;
+    read_inode(region->inode, &node);
+    read_inode_range(&node, page + (from - page_addr), region->file_offset + (from - region->file_start), to - from);
+  }
+}
+
+/**
+ * Page image untuk (inode, page_addr) dari cache, dibaca dari disk hanya saat miss pertama.
+ * Isi page hanya bergantung pada file sehingga proses lain yang menjalankan file sama memakai page fisik yang sama
+ *
+ * @return Alamat fisik page milik cache, 0 jika memori habis
+ */
+static uint32_t image_cache_get(struct ProcessControlBlock *pcb, uint32_t inode, uint32_t page_addr)
+{
+  uint32_t bucket = image_cache_bucket(inode, page_addr);
+  for (struct ImageCacheEntry *entry = image_cache[bucket]; entry != NULL; entry = entry->next)
+    if (entry->inode == inode && entry->page_addr == page_addr)
+      return entry->physical_addr;
+
+  if (image_cache_entry_cache == NULL)
+    image_cache_entry_cache = kmem_cache_create("image_cache", sizeof(struct ImageCacheEntry), NULL);
+  struct ImageCacheEntry *entry = kmem_cache_alloc(image_cache_entry_cache);
+  uint32_t physical_addr = entry ? paging_allocate_small_page() : 0;
+  if (physical_addr == 0)
+  {
+    kmem_cache_free(image_cache_entry_cache, entry);
+    return 0;
+  }
+  uint8_t *page = paging_physical_to_virtual(physical_addr);
+  memset(page, 0, PAGE_SMALL_SIZE);
+  fill_file_page(pcb, page, page_addr);
+
+  entry->inode = inode;
+  entry->page_addr = page_addr;
+  entry->physical_addr = physical_addr;
+  entry->next = image_cache[bucket];
+  image_cache[bucket] = entry;
+  return physical_addr;
+}
+
+bool process_handle_page_fault(struct ProcessControlBlock *pcb, uint32_t fault_addr, uint32_t error_code)
+{
+  // Page sudah ada tapi akses ditolak: hanya write ke page copy-on-write hasil fork yang sah
+  if (error_code & PAGE_FAULT_PRESENT)
+  {
+    if (!(error_code & PAGE_FAULT_WRITE) ||
+        !paging_handle_cow_fault(pcb->context.page_directory_virtual_addr, (void *)fault_addr))
+      return false;
+    pcb->memory.page_fault_count++;
+    return true;
+  }
+
+  // Satu page bisa dicakup lebih dari satu region (segment ELF yang bersebelahan)
+  uint32_t page_addr = fault_addr & ~(PAGE_SMALL_SIZE - 1);
+  bool reserved = false, writable = false;
+  uint32_t inode = 0;
+  for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX; i++)
   {
-    paging_use_page_directory(cur_run);
+    struct ProcessMemoryRegion *region = &pcb->memory.regions[i];
+    if (region->end == 0 || page_addr < region->start || page_addr >= region->end)
+      continue;
+    reserved = true;
+    writable |= region->writable;
+    // Page bss murni (di luar [file_start, file_end)) cukup zero-fill, tidak perlu masuk cache
+    if (region->inode != 0 && region->file_start < page_addr + PAGE_SMALL_SIZE && region->file_end > page_addr)
+      inode = region->inode;
   }
-  pcb->memory.page_frame_used_count = 0;
+  if (!reserved || ((error_code & PAGE_FAULT_WRITE) && !writable))
+    return false;
 
+  struct PageDirectory *page_dir = pcb->context.page_directory_virtual_addr;
+  if (paging_get_user_small_page(page_dir, (void *)page_addr) != 0)
+    return true;
+  if (inode == 0)
+  {
+    // Page anonymous selalu di-zero sehingga isi memori proses lain tidak pernah bocor
+    if (!paging_allocate_user_small_page(page_dir, (void *)page_addr))
+      return false;
+  }
+  else
+  {
+    // Page file dari image cache: text dibagi read-only, data dibagi copy-on-write sampai ditulis
+    uint32_t physical_addr = image_cache_get(pcb, inode, page_addr);
+    if (physical_addr == 0 || !paging_map_shared_small_page(page_dir, (void *)page_addr, physical_addr, writable))
+      return false;
+    if ((error_code & PAGE_FAULT_WRITE) && !paging_handle_cow_fault(page_dir, (void *)page_addr))
+      return false;
+  }
+  pcb->memory.page_used_count++;
+  pcb->memory.page_fault_count++;
   return true;
 }
 
+void process_prefault_user_buffer(void *addr, uint32_t size)
+{
+  struct ProcessControlBlock *pcb = process_get_current_running_pcb_pointer();
+  if (pcb == NULL || size == 0 || (uint32_t)addr >= KERNEL_VIRTUAL_ADDRESS_BASE)
+    return;
+  uint32_t end = (uint32_t)addr + size;
+  if (end < (uint32_t)addr || end > KERNEL_VIRTUAL_ADDRESS_BASE)
+    end = KERNEL_VIRTUAL_ADDRESS_BASE;
+
+  // Page anonymous tidak perlu: fault-nya hanya zero-fill dan tidak menyentuh ext2
+  for (uint32_t i = 0; i < PROCESS_REGION_COUNT_MAX; i++)
+  {
+    struct ProcessMemoryRegion *region = &pcb->memory.regions[i];
+    if (region->end == 0 || region->inode == 0)
+      continue;
+    uint32_t from = region->start > (uint32_t)addr ? region->start : (uint32_t)addr & ~(PAGE_SMALL_SIZE - 1);
+    uint32_t to = region->end < end ? region->end : end;
+    for (uint32_t page_addr = from; page_addr < to; page_addr += PAGE_SMALL_SIZE)
+      if (paging_get_user_small_page(pcb->context.page_directory_virtual_addr, (void *)page_addr) == 0)
+        process_handle_page_fault(pcb, page_addr, PAGE_FAULT_WRITE);
+  }
+}
+
+/**
+ * Cari file executable milik request
+ *
+ * @return False jika parent bukan direktori, file tidak ada, atau berupa direktori
+ */
+static bool process_find_executable(struct EXT2DriverRequest *request, uint32_t *inode, struct EXT2Inode *file)
+{
+  struct EXT2Inode parent;
+  read_inode(request->parent_inode, &parent);
+  if (!is_directory(&parent) || !find_inode_in_dir(&parent, request->name, inode))
+    return false;
+  read_inode(*inode, file);
+  return !is_directory(file);
+}
+
+/**
+ * Validasi header ELF32 i386 executable dan ambil program header-nya
+ *
+ * @return Jumlah program header, 0 jika bukan ELF yang bisa dimuat
+ */
+static uint32_t elf_read_program_headers(struct EXT2Inode *file, struct ELF32Header *header,
+                                         struct ELF32ProgramHeader *program_headers)
+{
+  if (read_inode_range(file, header, 0, sizeof(struct ELF32Header)) != sizeof(struct ELF32Header) ||
+      *(uint32_t *)header->e_ident != ELF_MAGIC)
+    return 0;
+  if (header->e_ident[4] != ELF_CLASS_32 || header->e_ident[5] != ELF_DATA_LSB || header->e_type != ELF_TYPE_EXEC ||
+      header->e_machine != ELF_MACHINE_386 || header->e_phentsize != sizeof(struct ELF32ProgramHeader) ||
+      header->e_phnum == 0 || header->e_phnum > ELF_PROGRAM_HEADER_COUNT_MAX)
+    return 0;
+  uint32_t table_size = header->e_phnum * sizeof(struct ELF32ProgramHeader);
+  if (read_inode_range(file, program_headers, header->e_phoff, table_size) != table_size)
+    return 0;
+  return header->e_phnum;
+}
+
+/**
+ * Segment PT_LOAD harus berada di bawah region mmap, tidak menimpa stack, dan datanya ada di file
+ */
+static bool elf_segment_valid(struct ELF32ProgramHeader *segment, struct EXT2Inode *file)
+{
+  uint32_t end = segment->p_vaddr + segment->p_memsz;
+  uint32_t stack_bottom = PROCESS_USER_STACK_TOP - PROCESS_USER_STACK_SIZE;
+  return segment->p_filesz <= segment->p_memsz && end >= segment->p_vaddr && end <= MMAP_REGION_START &&
+         (end <= stack_bottom || segment->p_vaddr >= PROCESS_USER_STACK_TOP) &&
+         segment->p_offset + segment->p_filesz >= segment->p_offset &&
+         segment->p_offset + segment->p_filesz <= file->i_size;
+}
+
 int32_t process_create_user_process(struct EXT2DriverRequest request)
 {
   int32_t retcode = PROCESS_CREATE_SUCCESS;
@@ -88,38 +465,129 @@ int32_t process_create_user_process(struct EXT2DriverRequest request)
     goto exit_cleanup;
   }
 
-  // Check whether memory is enough for the executable and additional frame for user stack
-  uint32_t page_frame_count_needed = ceil_div(request.buffer_size + PAGE_FRAME_SIZE, PAGE_FRAME_SIZE);
-  if (!paging_allocate_check(page_frame_count_needed) || page_frame_count_needed > PROCESS_PAGE_FRAME_COUNT_MAX)
+  // Executable ELF32: PT_LOAD hanya dicadangkan, isi file dibaca saat page fault. Selain itu flat binary
+  // dimuat ke region [buf, buf + buffer_size) dan tidak boleh masuk region mmap
+  uint32_t inode = 0;
+  struct EXT2Inode file;
+  struct ELF32Header elf_header;
+  struct ELF32ProgramHeader program_headers[ELF_PROGRAM_HEADER_COUNT_MAX];
+  bool found = process_find_executable(&request, &inode, &file);
+  uint32_t program_header_count = found ? elf_read_program_headers(&file, &elf_header, program_headers) : 0;
+  bool entry_loaded = false;
+  for (uint32_t i = 0; i < program_header_count; i++)
+  {
+    struct ELF32ProgramHeader *segment = &program_headers[i];
+    if (segment->p_type != ELF_PT_LOAD)
+      continue;
+    if (!elf_segment_valid(segment, &file))
+    {
+      retcode = PROCESS_CREATE_FAIL_INVALID_ENTRYPOINT;
+      goto exit_cleanup;
+    }
+    entry_loaded |= elf_header.e_entry >= segment->p_vaddr && elf_header.e_entry < segment->p_vaddr + segment->p_memsz;
+  }
+  if (program_header_count > 0 && !entry_loaded)
+  {
+    retcode = PROCESS_CREATE_FAIL_INVALID_ENTRYPOINT;
+    goto exit_cleanup;
+  }
+
+  uint32_t image_start = (uint32_t)request.buf;
+  uint32_t image_end = image_start + request.buffer_size;
+  // Heap tepat setelah byte image tertinggi, tidak pernah di bawah stack
+  uint32_t heap_start = program_header_count > 0 ? 0 : image_end;
+  for (uint32_t i = 0; i < program_header_count; i++)
+    if (program_headers[i].p_type == ELF_PT_LOAD && program_headers[i].p_vaddr + program_headers[i].p_memsz > heap_start)
+      heap_start = program_headers[i].p_vaddr + program_headers[i].p_memsz;
+  if (heap_start < PROCESS_USER_STACK_TOP)
+    heap_start = PROCESS_USER_STACK_TOP;
+  heap_start = (heap_start + PAGE_SMALL_SIZE - 1) & ~(PAGE_SMALL_SIZE - 1);
+  if (program_header_count == 0 && (image_end < image_start || image_end > MMAP_REGION_START))
+  {
+    retcode = PROCESS_CREATE_FAIL_INVALID_ENTRYPOINT;
+    goto exit_cleanup;
+  }
+  // Memori yang dicek cukup: page directory + page table, ditambah page isi file flat binary (disentuh read)
+  uint32_t image_size = !found || file.i_size > request.buffer_size ? request.buffer_size : file.i_size;
+  uint32_t page_count_needed = 3;
+  if (program_header_count == 0)
+    page_count_needed += ceil_div(image_size + (image_start & (PAGE_SMALL_SIZE - 1)), PAGE_SMALL_SIZE);
+  if (!paging_allocate_check(page_count_needed * PAGE_SMALL_SIZE))
   {
     retcode = PROCESS_CREATE_FAIL_NOT_ENOUGH_MEMORY;
     goto exit_cleanup;
   }
 
   // Process PCB
+  if (pcb_cache == NULL)
+    pcb_cache = kmem_cache_create("pcb", sizeof(struct ProcessControlBlock), pcb_constructor);
   int32_t p_index = process_list_get_inactive_index();
-  struct ProcessControlBlock *new_pcb = &(_process_list[p_index]);
+  struct ProcessControlBlock *new_pcb = pcb_cache ? kmem_cache_alloc(pcb_cache) : NULL;
+  struct PageDirectory *new_page_dir = new_pcb ? paging_create_new_page_directory() : NULL;
+  if (new_page_dir == NULL)
+  {
+    kmem_cache_free(pcb_cache, new_pcb);
+    retcode = PROCESS_CREATE_FAIL_NOT_ENOUGH_MEMORY;
+    goto exit_cleanup;
+  }
   memcpy(new_pcb->metadata.name, request.name, 8 * sizeof(char));
-  struct PageDirectory *cur_active = paging_get_current_page_directory_addr();
-  new_pcb->context.page_directory_virtual_addr = paging_create_new_page_directory();
-  paging_use_page_directory(new_pcb->context.page_directory_virtual_addr);
+  new_pcb->context.page_directory_virtual_addr = new_page_dir;
+  reserve_region(new_pcb, PROCESS_USER_STACK_TOP - PROCESS_USER_STACK_SIZE, PROCESS_USER_STACK_TOP, true);
 
-  for (uint32_t i = 0; i < page_frame_count_needed; i++)
+  if (program_header_count > 0)
   {
-    new_pcb->memory.virtual_addr_used[i] = request.buf + i * PAGE_FRAME_SIZE;
-    paging_allocate_user_page_frame(new_pcb->context.page_directory_virtual_addr, new_pcb->memory.virtual_addr_used[i]);
+    for (uint32_t i = 0; i < program_header_count; i++)
+    {
+      struct ELF32ProgramHeader *segment = &program_headers[i];
+      if (segment->p_type != ELF_PT_LOAD || segment->p_memsz == 0)
+        continue;
+      struct ProcessMemoryRegion *region = reserve_region(new_pcb, segment->p_vaddr, segment->p_vaddr + segment->p_memsz,
+                                                          (segment->p_flags & ELF_PF_W) != 0);
+      if (region == NULL)
+      {
+        paging_free_page_directory(new_page_dir);
+        memset(new_pcb->memory.regions, 0, sizeof(new_pcb->memory.regions));
+        kmem_cache_free(pcb_cache, new_pcb);
+        retcode = PROCESS_CREATE_FAIL_INVALID_ENTRYPOINT;
+        goto exit_cleanup;
+      }
+      if (segment->p_filesz > 0)
+      {
+        region->inode = inode;
+        region->file_start = segment->p_vaddr;
+        region->file_end = segment->p_vaddr + segment->p_filesz;
+        region->file_offset = segment->p_offset;
+      }
+    }
+    new_pcb->context.eip = elf_header.e_entry;
+    _process_list[p_index] = new_pcb;
+  }
+  else
+  {
+    reserve_region(new_pcb, image_start, image_end, true);
+
+    // Slot diisi sebelum read: page fault saat kernel menulis image ke page directory baru
+    // menemukan PCB ini lewat process_get_pcb_by_page_directory dan hanya page isi file yang dialokasikan
+    _process_list[p_index] = new_pcb;
+    struct PageDirectory *cur_active = paging_get_current_page_directory_addr();
+    paging_use_page_directory(new_page_dir);
+    read(request);
+    paging_use_page_directory(cur_active);
+    new_pcb->context.eip = (uint32_t)request.buf;
   }
-  new_pcb->memory.page_frame_used_count = page_frame_count_needed;
-  read(request);
-  new_pcb->context.eip = (uint32_t)request.buf;
-  paging_use_page_directory(cur_active);
 
-  new_pcb->context.eflags |= CPU_EFLAGS_BASE_FLAG | CPU_EFLAGS_FLAG_INTERRUPT_ENABLE;
+  // Region heap kosong (start == end), tumbuh lewat process_brk
+  struct ProcessMemoryRegion *heap = reserve_region(new_pcb, heap_start, heap_start, true);
+  if (heap != NULL)
+    heap->type = PROCESS_REGION_HEAP;
+  new_pcb->memory.heap_break = heap_start;
+
+  new_pcb->context.eflags = CPU_EFLAGS_BASE_FLAG | CPU_EFLAGS_FLAG_INTERRUPT_ENABLE;
   new_pcb->context.cpu.segment.ds = GDT_USER_DATA_SEGMENT_SELECTOR;
   new_pcb->context.cpu.segment.es = GDT_USER_DATA_SEGMENT_SELECTOR;
   new_pcb->context.cpu.segment.fs = GDT_USER_DATA_SEGMENT_SELECTOR;
   new_pcb->context.cpu.segment.gs = GDT_USER_DATA_SEGMENT_SELECTOR;
-  new_pcb->context.cpu.stack.esp = 0x400000;
+  new_pcb->context.cpu.stack.esp = PROCESS_USER_STACK_TOP;
   new_pcb->metadata.pid = process_generate_new_pid();
   new_pcb->metadata.active = true;
   new_pcb->metadata.cur_state = READY;
@@ -128,13 +596,49 @@ exit_cleanup:
   return retcode;
 }
 
+int32_t process_fork(struct Context context)
+{
+  struct ProcessControlBlock *parent = process_get_current_running_pcb_pointer();
+  if (parent == NULL || process_manager_state.active_process_count >= PROCESS_COUNT_MAX)
+    return -1;
+
+  int32_t p_index = process_list_get_inactive_index();
+  struct ProcessControlBlock *child = kmem_cache_alloc(pcb_cache);
+  struct PageDirectory *child_page_dir = child ? paging_create_new_page_directory() : NULL;
+  if (child_page_dir == NULL)
+  {
+    kmem_cache_free(pcb_cache, child);
+    return -1;
+  }
+  // Hanya page table yang disalin, isi page dibagi read-only sampai salah satu proses menulis
+  if (!paging_clone_user_pages(child_page_dir, parent->context.page_directory_virtual_addr))
+  {
+    paging_free_page_directory(child_page_dir);
+    kmem_cache_free(pcb_cache, child);
+    return -1;
+  }
+
+  memcpy(child->metadata.name, parent->metadata.name, sizeof(child->metadata.name));
+  memcpy(child->memory.regions, parent->memory.regions, sizeof(child->memory.regions));
+  child->memory.page_used_count = parent->memory.page_used_count;
+  child->memory.heap_break = parent->memory.heap_break;
+  child->context = context;
+  child->context.page_directory_virtual_addr = child_page_dir;
+  child->metadata.pid = process_generate_new_pid();
+  child->metadata.active = true;
+  child->metadata.cur_state = READY;
+  _process_list[p_index] = child;
+  process_manager_state.active_process_count++;
+  return child->metadata.pid;
+}
+
 struct ProcessControlBlock *process_get_current_running_pcb_pointer(void)
 {
   if (process_manager_state.cur_idx == -1)
   {
     return NULL;
   }
-  return &_process_list[process_manager_state.cur_idx];
+  return _process_list[process_manager_state.cur_idx];
 }
 
 void qemu_exit()
@@ -152,9 +656,10 @@ bool process_destroy(uint32_t pid)
 {
   for (int i = 0; i < PROCESS_COUNT_MAX; i++)
   {
-    if (_process_list[i].metadata.pid == pid)
+    struct ProcessControlBlock *pcb = _process_list[i];
+    if (pcb != NULL && pcb->metadata.pid == pid)
     {
-      if (!release_memory(&_process_list[i]))
+      if (!release_memory(pcb))
       {
         return false;
       }
@@ -165,7 +670,9 @@ bool process_destroy(uint32_t pid)
         asm volatile("outw %0, %1" : : "a"((uint16_t)0x2000), "Nd"((uint16_t)0x604));
       }
 
-      _process_list[i].metadata.active = false;
+      pcb->metadata.active = false;
+      _process_list[i] = NULL;
+      kmem_cache_free(pcb_cache, pcb);
       process_manager_state.active_process_count--;
 
       return true;
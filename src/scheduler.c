@@ -1,6 +1,8 @@
 #include "./header/scheduler/scheduler.h"
 #include "./header/cpu/interrupt.h"
 
+static struct SchedulerStatistics scheduler_statistics;
+
 /* --- Scheduler --- */
 /**
  * Initialize scheduler before executing init process
@@ -17,7 +19,7 @@ void scheduler_init(void)
  */
 void scheduler_save_context_to_current_running_pcb(struct Context ctx)
 {
-  struct ProcessControlBlock *cur_run = &_process_list[process_manager_state.cur_idx];
+  struct ProcessControlBlock *cur_run = _process_list[process_manager_state.cur_idx];
   cur_run->context.cpu = ctx.cpu;
   cur_run->context.eflags = ctx.eflags;
   cur_run->context.eip = ctx.eip;
@@ -30,14 +32,29 @@ void scheduler_switch_to_next_process(void)
 {
   // if (process_manager_state.active_process_count > 1) {
   int idx = (process_manager_state.cur_idx + 1) % PROCESS_COUNT_MAX;
-  while (!_process_list[idx].metadata.active)
+  while (_process_list[idx] == NULL)
   {
     idx = (idx + 1) % PROCESS_COUNT_MAX;
   }
-  _process_list[process_manager_state.cur_idx].metadata.cur_state = READY;
-  struct Context *ctx = &_process_list[idx].context;
+  if (process_manager_state.cur_idx >= 0 && _process_list[process_manager_state.cur_idx] != NULL)
+    _process_list[process_manager_state.cur_idx]->metadata.cur_state = READY;
+  scheduler_statistics.switch_count++;
+  if (idx == process_manager_state.cur_idx)
+    scheduler_statistics.same_process_count++;
+  struct Context *ctx = &_process_list[idx]->context;
+  // Tidak reload CR3 jika page directory sama, lihat paging_use_page_directory
   paging_use_page_directory(ctx->page_directory_virtual_addr);
   process_manager_state.cur_idx = idx;
-  _process_list[idx].metadata.cur_state = RUNNING;
+  _process_list[idx]->metadata.cur_state = RUNNING;
   process_context_switch(*ctx);
-}
\ No newline at end of file
+}
+/**
+ * Copy context switch and TLB statistics
+ *
+ * @param statistics Destination
+ */
+void scheduler_get_statistics(struct SchedulerStatistics *statistics)
+{
+  *statistics = scheduler_statistics;
+  paging_get_tlb_statistics(&statistics->tlb);
+}
@@ -0,0 +1,162 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "header/stdlib/malloc.h"
+#include "header/stdlib/string.h"
+#include "header/memory/mmap.h"
+
+extern void user_syscall(uint32_t eax, uint32_t ebx, uint32_t ecx, uint32_t edx);
+
+/**
+ * Header di depan setiap blok
+ *
+ * @param size_class Index size class, MALLOC_CLASS_LARGE untuk blok mmap
+ * @param capacity   Byte yang bisa dipakai setelah header (blok besar: panjang mmap - header)
+ */
+struct MallocBlockHeader
+{
+  uint32_t size_class;
+  uint32_t capacity;
+};
+
+/**
+ * Blok bebas di free list, next menumpang di area data
+ */
+struct MallocFreeBlock
+{
+  struct MallocBlockHeader header;
+  struct MallocFreeBlock *next;
+};
+
+static const uint32_t malloc_size_class[MALLOC_SIZE_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048};
+
+static struct MallocFreeBlock *free_list[MALLOC_SIZE_CLASS_COUNT];
+// Sisa span sbrk yang belum dipotong jadi object
+static uint8_t *span_cursor = NULL;
+static uint8_t *span_end = NULL;
+
+void *sbrk(int32_t increment)
+{
+  void *old_break = NULL;
+  user_syscall(47, (uint32_t)increment, (uint32_t)&old_break, 0);
+  return old_break;
+}
+
+/**
+ * Isi free list class yang kosong: beberapa object dipotong sekaligus supaya sbrk jarang dipanggil
+ *
+ * @return False jika heap tidak bisa ditambah
+ */
+static bool refill_free_list(uint32_t class)
+{
+  uint32_t block_size = sizeof(struct MallocBlockHeader) + malloc_size_class[class];
+  if ((uint32_t)(span_end - span_cursor) < block_size)
+  {
+    // Sisa span terlalu kecil untuk class ini dibuang, span baru selalu cukup untuk class terbesar
+    uint8_t *span = sbrk(MALLOC_SPAN_SIZE);
+    if (span == NULL)
+      return false;
+    if (span != span_end)
+      span_cursor = span;
+    span_end = span + MALLOC_SPAN_SIZE;
+  }
+
+  for (uint32_t i = 0; i < MALLOC_REFILL_BATCH && (uint32_t)(span_end - span_cursor) >= block_size; i++)
+  {
+    struct MallocFreeBlock *block = (struct MallocFreeBlock *)span_cursor;
+    block->header.size_class = class;
+    block->header.capacity = malloc_size_class[class];
+    block->next = free_list[class];
+    free_list[class] = block;
+    span_cursor += block_size;
+  }
+  return true;
+}
+
+static void *malloc_large(size_t size)
+{
+  struct MmapRequest request;
+  memset(&request, 0, sizeof(request));
+  request.file.buffer_size = sizeof(struct MallocBlockHeader) + size;
+  request.prot = MMAP_PROT_READ | MMAP_PROT_WRITE;
+  request.flags = MMAP_PRIVATE | MMAP_ANONYMOUS;
+
+  struct MallocBlockHeader *header = NULL;
+  user_syscall(36, (uint32_t)&request, (uint32_t)&header, 0);
+  if (header == NULL)
+    return NULL;
+  // Kapasitas sampai akhir page terakhir, realloc kecil berikutnya tidak perlu mmap ulang
+  uint32_t length = (request.file.buffer_size + PAGE_SMALL_SIZE - 1) & ~(PAGE_SMALL_SIZE - 1);
+  header->size_class = MALLOC_CLASS_LARGE;
+  header->capacity = length - sizeof(struct MallocBlockHeader);
+  return header + 1;
+}
+
+void *malloc(size_t size)
+{
+  if (size == 0)
+    return NULL;
+  if (size > MALLOC_SMALL_SIZE_MAX)
+    return size > 0xFFFFFFFF - PAGE_SMALL_SIZE ? NULL : malloc_large(size);
+
+  uint32_t class = 0;
+  while (malloc_size_class[class] < size)
+    class++;
+  if (free_list[class] == NULL && !refill_free_list(class))
+    return NULL;
+
+  struct MallocFreeBlock *block = free_list[class];
+  free_list[class] = block->next;
+  return &block->header + 1;
+}
+
+void *calloc(size_t count, size_t size)
+{
+  if (size != 0 && count > 0xFFFFFFFF / size)
+    return NULL;
+  void *ptr = malloc(count * size);
+  if (ptr != NULL)
+    memset(ptr, 0, count * size);
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+  if (ptr == NULL)
+    return malloc(size);
+  if (size == 0)
+  {
+    free(ptr);
+    return NULL;
+  }
+
+  struct MallocBlockHeader *header = (struct MallocBlockHeader *)ptr - 1;
+  if (size <= header->capacity)
+    return ptr;
+  void *new_ptr = malloc(size);
+  if (new_ptr == NULL)
+    return NULL;
+  memcpy(new_ptr, ptr, header->capacity);
+  free(ptr);
+  return new_ptr;
+}
+
+void free(void *ptr)
+{
+  if (ptr == NULL)
+    return;
+  struct MallocBlockHeader *header = (struct MallocBlockHeader *)ptr - 1;
+  if (header->size_class == MALLOC_CLASS_LARGE)
+  {
+    int8_t result;
+    user_syscall(37, (uint32_t)header, (uint32_t)&result, 0);
+    return;
+  }
+  if (header->size_class >= MALLOC_SIZE_CLASS_COUNT)
+    return;
+
+  struct MallocFreeBlock *block = (struct MallocFreeBlock *)header;
+  block->next = free_list[header->size_class];
+  free_list[header->size_class] = block;
+}
@@ -182,7 +182,13 @@ void process_command(char* command_buffer) {
             print_line("cp: missing arguments (usage: cp source destination)");
         }
     } else if (strcmp(command_name, "rm") == 0) {
-        if (arg1) {
+        if (arg1 && strcmp(arg1, "-r") == 0) {
+            if (arg2) {
+                handle_rm_recursive(arg2);
+            } else {
+                print_line("rm: missing argument (usage: rm -r <name>)");
+            }
+        } else if (arg1) {
             handle_rm(arg1);
         } else {
             print_line("rm: missing argument");
@@ -193,12 +199,30 @@ void process_command(char* command_buffer) {
         } else {
             print_line("mv: missing arguments (usage: mv source destination)");
         }
+    } else if (strcmp(command_name, "chattr") == 0) {
+        if (arg1 && arg2) {
+            handle_chattr(arg1, arg2);
+        } else {
+            print_line("chattr: missing arguments (usage: chattr +c|-c <name>)");
+        }
     } else if (strcmp(command_name, "find") == 0) {
         if (arg1) {
             handle_find(arg1);
         } else {
             print_line("find: missing argument");
         }
+    } else if (strcmp(command_name, "df") == 0) {
+        handle_df();
+    } else if (strcmp(command_name, "dedup") == 0) {
+        handle_dedup();
+    } else if (strcmp(command_name, "snapshot") == 0) {
+        handle_snapshot(arg1);
+    } else if (strcmp(command_name, "slabinfo") == 0) {
+        handle_slabinfo();
+    } else if (strcmp(command_name, "fork") == 0) {
+        handle_fork();
+    } else if (strcmp(command_name, "schedstat") == 0) {
+        handle_schedstat();
     } else if (strcmp(command_name, "beep") == 0) { // Tambahkan perintah beep
         int b = 0;
         print_string("Playing beep...", &current_output_row, &b);